@@ -41,6 +41,8 @@ Attribute& Attribute::operator=(Attribute&& a)
         _values = move(a._values);
         _valuesTypes = move(a._valuesTypes);
         _defaultSetAndGet = a._defaultSetAndGet;
+        _isDirty = a._isDirty.load();
+        _isVolatile = a._isVolatile;
     }
 
     return *this;
@@ -68,6 +70,7 @@ bool Attribute::operator()(const Values& args)
         for (const auto& a : args)
             _valuesTypes.push_back(a.getTypeAsChar());
 
+        _isDirty = true;
         return true;
     }
     else if (!_setFunc)
@@ -96,7 +99,11 @@ bool Attribute::operator()(const Values& args)
         }
     }
 
-    return _setFunc(args);
+    if (!_setFunc(args))
+        return false;
+
+    _isDirty = true;
+    return true;
 }
 
 /*************/
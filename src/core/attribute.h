@@ -145,6 +145,35 @@ class Attribute
      */
     bool hasGetter() const { return _getFunc != nullptr; }
 
+    /**
+     * \brief Check whether the attribute has been set since its modification flag was last reset
+     * \return Return true if the attribute has been modified
+     */
+    bool isDirty() const { return _isDirty; }
+
+    /**
+     * \brief Flag the attribute as modified, for values which changed without the setter being called
+     */
+    void setDirty() { _isDirty = true; }
+
+    /**
+     * \brief Reset the modification flag
+     * \return Return true if the attribute had been modified
+     */
+    bool resetDirty() { return _isDirty.exchange(false); }
+
+    /**
+     * \brief Check whether the attribute value can change without its setter being called, in which case it has to be polled
+     * \return Return true if the value is volatile
+     */
+    bool isVolatile() const { return _isVolatile || (!_setFunc && !_defaultSetAndGet); }
+
+    /**
+     * \brief Set whether the attribute value can change without its setter being called
+     * \param isVolatile If true, the value has to be polled
+     */
+    void setVolatile(bool isVolatile) { _isVolatile = isVolatile; }
+
     /**
      * \brief Ask whether the attribute is locked.
      * \return Returns true if the attribute is locked.
@@ -227,6 +256,8 @@ class Attribute
     std::map<uint32_t, Callback> _callbacks{};
 
     bool _isLocked{false};
+    std::atomic_bool _isDirty{true}; //!< True if the attribute has been set since the flag was last reset
+    bool _isVolatile{false};         //!< True if the value can change without the setter being called
 };
 
 } // namespace Splash
@@ -119,6 +119,22 @@ Attribute::Sync BaseObject::getAttributeSyncMethod(const string& name)
         return Attribute::Sync::no_sync;
 }
 
+/*************/
+vector<string> BaseObject::getDirtyAttributes(bool all)
+{
+    vector<string> attributes;
+    unique_lock<recursive_mutex> lock(_attribMutex);
+    for (auto& attribute : _attribFunctions)
+    {
+        if (!attribute.second.hasGetter())
+            continue;
+        // The flag is reset first, so that a value set while being read is considered again next time
+        if (attribute.second.resetDirty() || attribute.second.isVolatile() || all)
+            attributes.push_back(attribute.first);
+    }
+    return attributes;
+}
+
 /*************/
 void BaseObject::runAsyncTask(const function<void(void)>& func)
 {
@@ -164,6 +180,15 @@ void BaseObject::setAttributeSyncMethod(const string& name, const Attribute::Syn
         attr->second.setSyncMethod(method);
 }
 
+/*************/
+void BaseObject::setAttributeVolatile(const string& name, bool isVolatile)
+{
+    unique_lock<recursive_mutex> lock(_attribMutex);
+    auto attr = _attribFunctions.find(name);
+    if (attr != _attribFunctions.end())
+        attr->second.setVolatile(isVolatile);
+}
+
 /*************/
 void BaseObject::removeAttribute(const string& name)
 {
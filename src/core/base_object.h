@@ -33,6 +33,7 @@
 #include <map>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
@@ -106,6 +107,14 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     Attribute::Sync getAttributeSyncMethod(const std::string& name);
 
+    /**
+     * \brief Get the attributes modified since the last call, and reset their modification flag.
+     * Volatile attributes are always considered as modified. Attributes without a getter are ignored.
+     * \param all If true, get all the attributes having a getter, modified or not
+     * \return Return the names of the attributes
+     */
+    std::vector<std::string> getDirtyAttributes(bool all = false);
+
     /**
      * Register a callback to any call to the setter
      * \param attr Attribute to add a callback to
@@ -206,6 +215,13 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     void setAttributeSyncMethod(const std::string& name, const Attribute::Sync& method);
 
+    /**
+     * \brief Set whether the attribute value can change without its setter being called
+     * \param name Attribute name
+     * \param isVolatile If true, the attribute value is polled whenever the modified attributes are queried
+     */
+    void setAttributeVolatile(const std::string& name, bool isVolatile);
+
     /**
      * \brief Remove the specified attribute
      * \param name Attribute name
@@ -1,12 +1,20 @@
 #include "./core/buffer_object.h"
 
 #include "./core/root_object.h"
+#include "./core/thread_pool.h"
 
 using namespace std;
 
 namespace Splash
 {
 
+/*************/
+BufferObject::~BufferObject()
+{
+    if (_deserializeFuture.valid())
+        _deserializeFuture.wait();
+}
+
 /**************/
 void BufferObject::setNotUpdated()
 {
@@ -35,7 +43,7 @@ void BufferObject::setSerializedObject(shared_ptr<SerializedObject> obj)
         _newSerializedObject = true;
 
         // Deserialize it right away, in a separate thread
-        _deserializeFuture = async(launch::async, [this]() {
+        _deserializeFuture = ThreadPool::get().enqueue([this]() {
             lock_guard<shared_mutex> lock(_writeMutex);
             deserialize();
             _serializedObjectWaitingMutex.unlock();
@@ -27,6 +27,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <future>
 #include <json/json.h>
 #include <list>
@@ -55,6 +56,11 @@ class BufferObject : public GraphObject
         registerAttributes();
     }
 
+    /**
+     * \brief Destructor, waits for the pending deserialization if any
+     */
+    virtual ~BufferObject() override;
+
     /**
      * Lock the buffer, useful while reading. Use with care
      * Note that only write mutex is needed, as it also disables reading
@@ -128,6 +134,21 @@ class BufferObject : public GraphObject
      */
     virtual std::shared_ptr<SerializedObject> serialize() const = 0;
 
+    /**
+     * \brief Serialize the object into memory given by the caller, e.g. to write it only once in shared memory.
+     * Objects which can not be serialized into a single array are serialized as usual.
+     * \param allocate Function returning an array of the given size, or an empty array if it is not able to
+     * \return Return a serialized representation of the object
+     */
+    virtual std::shared_ptr<SerializedObject> serializeInto(const std::function<ResizableArray<uint8_t>(size_t)>& /*allocate*/) const { return serialize(); }
+
+    /**
+     * \brief Get a handle over the current buffer, for objects living in the same process.
+     * Objects unable to share their buffer are serialized instead.
+     * \return Return a serialized object holding the handle
+     */
+    virtual std::shared_ptr<SerializedObject> share() const { return serialize(); }
+
     /**
      * \brief Set the next serialized object to deserialize to buffer
      * \param obj Serialized object
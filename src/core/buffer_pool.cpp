@@ -0,0 +1,135 @@
+#include "./core/buffer_pool.h"
+
+#include <cstdlib>
+#include <sys/mman.h>
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+ResizableArray<uint8_t> BufferPool::allocate(size_t size)
+{
+    if (size == 0)
+        return {};
+
+    auto capacity = getCapacity(size);
+    uint8_t* block = nullptr;
+
+    {
+        lock_guard<mutex> lock(_mutex);
+        auto bucketIt = _freeBuffers.find(capacity);
+        if (bucketIt != _freeBuffers.end() && !bucketIt->second.empty())
+        {
+            block = bucketIt->second.back();
+            bucketIt->second.pop_back();
+            _cachedBytes -= capacity;
+        }
+    }
+
+    if (block)
+    {
+        _recycledAllocations.fetch_add(1, memory_order_relaxed);
+        _recycledBytes.fetch_add(capacity, memory_order_relaxed);
+    }
+    else
+    {
+        block = allocateBlock(capacity);
+        if (!block)
+            return {};
+        _allocations.fetch_add(1, memory_order_relaxed);
+    }
+
+    // The global pool is never destroyed, whereas a pool created by an object may go away before the arrays it gave
+    auto owner = weak_from_this();
+    if (owner.expired())
+        return ResizableArray<uint8_t>(block, size, [this, capacity](uint8_t* ptr) { release(ptr, capacity); });
+
+    return ResizableArray<uint8_t>(block, size, [owner, capacity](uint8_t* ptr) {
+        if (auto pool = owner.lock())
+            pool->release(ptr, capacity);
+        else
+            freeBlock(ptr, capacity);
+    });
+}
+
+/*************/
+void BufferPool::clear()
+{
+    lock_guard<mutex> lock(_mutex);
+    for (auto& bucket : _freeBuffers)
+        for (auto block : bucket.second)
+            freeBlock(block, bucket.first);
+    _freeBuffers.clear();
+    _cachedBytes = 0;
+}
+
+/*************/
+BufferPool::Stats BufferPool::getStats() const
+{
+    Stats stats;
+    stats.allocations = _allocations.load(memory_order_relaxed);
+    stats.recycledAllocations = _recycledAllocations.load(memory_order_relaxed);
+    stats.recycledBytes = _recycledBytes.load(memory_order_relaxed);
+
+    lock_guard<mutex> lock(_mutex);
+    stats.cachedBytes = _cachedBytes;
+    return stats;
+}
+
+/*************/
+size_t BufferPool::getCapacity(size_t size)
+{
+    // Small buffers go in power of two buckets, larger ones are rounded to the huge page size
+    if (size >= _largeBufferSize)
+        return ((size + _largeBufferSize - 1) / _largeBufferSize) * _largeBufferSize;
+
+    size_t capacity = 4096;
+    while (capacity < size)
+        capacity <<= 1;
+    return capacity;
+}
+
+/*************/
+uint8_t* BufferPool::allocateBlock(size_t capacity)
+{
+    if (capacity < _largeBufferSize)
+        return static_cast<uint8_t*>(malloc(capacity));
+
+    auto block = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED)
+        return nullptr;
+#ifdef MADV_HUGEPAGE
+    // Transparent huge pages reduce the number of page faults and TLB misses when filling the buffer
+    madvise(block, capacity, MADV_HUGEPAGE);
+#endif
+    return static_cast<uint8_t*>(block);
+}
+
+/*************/
+void BufferPool::freeBlock(uint8_t* block, size_t capacity)
+{
+    if (capacity < _largeBufferSize)
+        free(block);
+    else
+        munmap(block, capacity);
+}
+
+/*************/
+void BufferPool::release(uint8_t* block, size_t capacity)
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (_cachedBytes + capacity <= _maxCachedBytes)
+        {
+            _freeBuffers[capacity].push_back(block);
+            _cachedBytes += capacity;
+            return;
+        }
+    }
+
+    freeBlock(block, capacity);
+}
+
+} // namespace Splash
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @buffer_pool.h
+ * Pool of large byte buffers, recycled once released to avoid allocating and page faulting them at each frame
+ * A global pool is available through BufferPool::get(), and objects producing frames at a high rate can hold their own.
+ */
+
+#ifndef SPLASH_BUFFER_POOL_H
+#define SPLASH_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "./core/resizable_array.h"
+#include "./core/serialized_object.h"
+
+namespace Splash
+{
+
+/*************/
+class BufferPool : public std::enable_shared_from_this<BufferPool>
+{
+  public:
+    struct Stats
+    {
+        uint64_t allocations{0};         //!< Number of buffers allocated from the system
+        uint64_t recycledAllocations{0}; //!< Number of allocations avoided by recycling a buffer
+        uint64_t recycledBytes{0};       //!< Number of bytes recycled
+        uint64_t cachedBytes{0};         //!< Number of bytes currently held by the pool
+    };
+
+  public:
+    /**
+     * \brief Get the singleton
+     * \return Return the BufferPool singleton
+     */
+    static BufferPool& get()
+    {
+        static auto instance = new BufferPool;
+        return *instance;
+    }
+
+    /**
+     * \brief Create a pool owned by the caller. Arrays allocated from it stay valid after the pool is destroyed.
+     * \param maxCachedSize Maximum size in bytes held by the pool
+     * \return Return the pool
+     */
+    static std::shared_ptr<BufferPool> create(size_t maxCachedSize)
+    {
+        auto pool = std::shared_ptr<BufferPool>(new BufferPool, [](BufferPool* pool) { delete pool; });
+        pool->setMaxCachedSize(maxCachedSize);
+        return pool;
+    }
+
+    /**
+     * \brief Get an array of the given size. Its content is not initialized, and it goes back to the pool once destroyed.
+     * \param size Array size
+     * \return Return the array
+     */
+    ResizableArray<uint8_t> allocate(size_t size);
+
+    /**
+     * \brief Get a SerializedObject of the given size, backed by a pooled array
+     * \param size Object size
+     * \return Return the serialized object
+     */
+    std::shared_ptr<SerializedObject> allocateSerializedObject(size_t size) { return std::make_shared<SerializedObject>(allocate(size)); }
+
+    /**
+     * \brief Free all the buffers currently held by the pool
+     */
+    void clear();
+
+    /**
+     * \brief Get the pool statistics
+     * \return Return the statistics
+     */
+    Stats getStats() const;
+
+    /**
+     * \brief Set the maximum amount of memory held by the pool. Buffers released above this limit are freed.
+     * \param size Maximum size in bytes
+     */
+    void setMaxCachedSize(size_t size) { _maxCachedBytes = size; }
+
+  private:
+    static constexpr size_t _largeBufferSize{2 << 20}; //!< Buffers larger than this are allocated by pages of this size, and backed by huge pages if possible
+
+    mutable std::mutex _mutex{};
+    std::map<size_t, std::vector<uint8_t*>> _freeBuffers{}; //!< Released buffers, sorted by capacity
+    size_t _cachedBytes{0};
+    std::atomic<size_t> _maxCachedBytes{1ull << 30};
+
+    std::atomic<uint64_t> _allocations{0};
+    std::atomic<uint64_t> _recycledAllocations{0};
+    std::atomic<uint64_t> _recycledBytes{0};
+
+    BufferPool() = default;
+    ~BufferPool() { clear(); }
+    BufferPool(const BufferPool&) = delete;
+    const BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * \brief Get the capacity of the bucket for the given size
+     * \param size Requested size
+     * \return Return the bucket capacity
+     */
+    static size_t getCapacity(size_t size);
+
+    /**
+     * \brief Allocate a new block from the system
+     * \param capacity Block capacity
+     * \return Return a pointer to the block
+     */
+    static uint8_t* allocateBlock(size_t capacity);
+
+    /**
+     * \brief Give a block back to the system
+     * \param block Block pointer
+     * \param capacity Block capacity
+     */
+    static void freeBlock(uint8_t* block, size_t capacity);
+
+    /**
+     * \brief Get a block back into the pool
+     * \param block Block pointer
+     * \param capacity Block capacity
+     */
+    void release(uint8_t* block, size_t capacity);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_BUFFER_POOL_H
@@ -118,6 +118,8 @@ bool GraphObject::linkTo(const shared_ptr<GraphObject>& obj)
 
     _linkedObjects.push_back(obj);
     obj->linkToParent(this);
+    if (_root)
+        _root->signalGraphUpdated();
 
     if (_root && !_name.empty() && !obj->getName().empty())
     {
@@ -157,6 +159,8 @@ void GraphObject::unlinkFrom(const shared_ptr<GraphObject>& obj)
     unlinkIt(obj);
     _linkedObjects.erase(objectIt);
     obj->unlinkFromParent(this);
+    if (_root)
+        _root->signalGraphUpdated();
 
     if (_root && !_name.empty() && !obj->getName().empty())
     {
@@ -204,6 +208,8 @@ bool GraphObject::setRenderingPriority(Priority priority)
     if (priority < Priority::PRE_CAMERA || priority >= Priority::POST_WINDOW)
         return false;
     _renderingPriority = priority;
+    if (_root)
+        _root->signalGraphUpdated();
     return true;
 }
 /*************/
@@ -232,6 +238,8 @@ void GraphObject::registerAttributes()
     addAttribute("priorityShift",
         [&](const Values& args) {
             _priorityShift = args[0].as<int>();
+            if (_root)
+                _root->signalGraphUpdated();
             return true;
         },
         [&]() -> Values { return {_priorityShift}; },
@@ -266,6 +274,7 @@ void GraphObject::registerAttributes()
 
     addAttribute("timestamp", [](const Values&) { return true; }, [&]() -> Values { return {getTimestamp()}; });
     setAttributeDescription("timestamp", "Timestamp (in µs) for the current buffer, based on the latest image data created/received");
+    setAttributeVolatile("timestamp", true);
 }
 
 /*************/
@@ -1,8 +1,11 @@
 #include "./core/imagebuffer.h"
 
 #include <assert.h>
+#include <cstring>
 #include <vector>
 
+#include "./core/buffer_pool.h"
+
 using namespace std;
 
 namespace Splash
@@ -90,11 +93,11 @@ ImageBuffer::ImageBuffer(const ImageBufferSpec& spec, uint8_t* data, bool map)
     }
     else if (!map)
     {
-        auto size = spec.width * spec.height * spec.pixelBytes();
-        if (data)
-            _buffer = ResizableArray<uint8_t>(data, data + size);
-        else
-            _buffer.resize(size);
+        // Images are allocated from the pool, as they are mostly released to be replaced by a similar one
+        auto size = spec.rawSize();
+        _buffer = BufferPool::get().allocate(size);
+        if (data && _buffer.size())
+            memcpy(_buffer.data(), data, size);
     }
 }
 
@@ -140,11 +140,19 @@ class ImageBufferSpec
      */
     int pixelBytes() const { return bpp / 8; }
 
+    /**
+     * \brief Check whether the image is made of planes with subsampled chroma, namely NV12, I420 or P010
+     * Planes are stored one after the other, the luma plane being followed by the chroma planes each a quarter its size.
+     * Width and height of such images are even, and channels and bpp describe the luma plane.
+     * \return Return true if the image is planar
+     */
+    bool isPlanar() const { return format == "NV12" || format == "I420" || format == "P010"; }
+
     /**
      * \brief Get image size in bytes
      * \return Return image size
      */
-    int rawSize() const { return pixelBytes() * width * height; }
+    int rawSize() const { return isPlanar() ? pixelBytes() * width * (height + height / 2) : pixelBytes() * width * height; }
 };
 
 /*************/
@@ -164,6 +172,17 @@ class ImageBuffer
      */
     ImageBuffer(const ImageBufferSpec& spec, uint8_t* data = nullptr, bool map = false);
 
+    /**
+     * \brief Constructor, using the given array as the buffer. Its content is left as is.
+     * \param spec Image spec
+     * \param buffer Array to use, its size must match the spec
+     */
+    ImageBuffer(const ImageBufferSpec& spec, ResizableArray<uint8_t>&& buffer)
+        : _spec(spec)
+        , _buffer(std::move(buffer))
+    {
+    }
+
     /**
      * \brief Destructor
      */
@@ -204,7 +223,7 @@ class ImageBuffer
      * \brief Get the image buffer size
      * \return Return the size
      */
-    size_t getSize() const { return _mappedBuffer ? _spec.width * _spec.height * _spec.pixelBytes() : _buffer.size(); }
+    size_t getSize() const { return _mappedBuffer ? _spec.rawSize() : _buffer.size(); }
 
     /**
      * \brief Fill all channels with the given value
@@ -219,7 +238,7 @@ class ImageBuffer
     void setRawBuffer(ResizableArray<uint8_t>&& buffer)
     {
         if (!_mappedBuffer)
-            _buffer = buffer;
+            _buffer = std::move(buffer);
     }
 
   private:
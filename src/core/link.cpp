@@ -5,8 +5,11 @@
 #include <thread>
 
 #include "./core/attribute.h"
+#include "./core/buffer_pool.h"
 #include "./core/buffer_object.h"
 #include "./core/root_object.h"
+#include "./core/serialize/serialize_value.h"
+#include "./core/serializer.h"
 #include "./utils/log.h"
 #include "./utils/timer.h"
 
@@ -45,6 +48,12 @@ Link::Link(RootObject* root, const string& name)
     if (!socketPrefix.empty())
         _basePath += socketPrefix + string("_");
 
+    // Shared memory segments are only created when the shm transport is used
+    auto shmRingName = string("/splash_");
+    if (!socketPrefix.empty())
+        shmRingName += socketPrefix + string("_");
+    _shmRingOut = make_unique<ShmRingWriter>(shmRingName + "shm_" + _name);
+
     _running = true;
     _bufferInThread = thread([&]() { handleInputBuffers(); });
     _messageInThread = thread([&]() { handleInputMessages(); });
@@ -67,6 +76,14 @@ Link::~Link()
     {
         Log::get() << Log::ERROR << "Link::" << __FUNCTION__ << " - Error while closing socket: " << e.what() << Log::endl;
     }
+
+    // Close the sockets and the context explicitly, as buffers still in flight
+    // are released during their destruction and need the Link to still be alive
+    _socketMessageOut.reset();
+    _socketMessageIn.reset();
+    _socketBufferOut.reset();
+    _socketBufferIn.reset();
+    _context.reset();
 }
 
 /*************/
@@ -140,26 +157,8 @@ void Link::disconnectFrom(const std::string& name)
 /*************/
 bool Link::waitForBufferSending(chrono::milliseconds maximumWait)
 {
-    bool returnValue;
-    chrono::milliseconds totalWait{0};
-
-    while (true)
-    {
-        if (_otgNumber == 0)
-        {
-            returnValue = true;
-            break;
-        }
-        if (totalWait > maximumWait)
-        {
-            returnValue = false;
-            break;
-        }
-        totalWait = totalWait + chrono::milliseconds(1);
-        this_thread::sleep_for(chrono::milliseconds(1));
-    }
-
-    return returnValue;
+    unique_lock<mutex> lock(_otgMutex);
+    return _otgCondition.wait_for(lock, maximumWait, [&]() { return _otgNumber.load(std::memory_order_acquire) == 0; });
 }
 
 /*************/
@@ -170,12 +169,15 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
         for (auto& rootObjectIt : _connectedTargetPointers)
         {
             auto rootObject = rootObjectIt.second;
-            // If there is also a connection to another process,
-            // we make a copy of the buffer right now
+            // If there is also a connection to another process, we make a copy of the buffer
+            // right now, unless the inner peer can use the handle over the source buffer
             if (rootObject && _connectedToOuter)
             {
                 auto copiedBuffer = make_shared<SerializedObject>();
-                *copiedBuffer = *buffer;
+                if (buffer->hasHandle())
+                    copiedBuffer->_handle = buffer->_handle;
+                else
+                    *copiedBuffer = *buffer;
                 rootObject->setFromSerializedObject(name, copiedBuffer);
             }
             else if (rootObject)
@@ -192,18 +194,48 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
             lock_guard<Spinlock> lock(_bufferSendMutex);
             auto bufferPtr = buffer.get();
 
-            _otgMutex.lock();
-            _otgBuffers.push_back(buffer);
-            _otgMutex.unlock();
-
-            _otgNumber.fetch_add(1, std::memory_order_acq_rel);
-
             zmq::message_t msg(name.size() + 1);
             memcpy(msg.data(), (void*)name.c_str(), name.size() + 1);
             _socketBufferOut->send(msg, ZMQ_SNDMORE);
 
-            msg.rebuild(bufferPtr->data(), bufferPtr->size(), Link::freeOlderBuffer, this);
-            _socketBufferOut->send(msg);
+            // Buffers not serialized into a slot are copied into one. If the shared memory ring is full,
+            // fall back to sending the buffer through the socket
+            ShmRingDescriptor descriptor;
+            auto transport = _bufferTransport.load();
+            const auto readerCount = static_cast<uint32_t>(_connectedTargets.size());
+            if (transport == BufferTransport::shm && !_shmRingOut->commit(buffer, readerCount, descriptor) && !_shmRingOut->write(buffer, readerCount, descriptor))
+                transport = BufferTransport::ipc;
+
+            msg.rebuild(sizeof(transport));
+            memcpy(msg.data(), (void*)&transport, sizeof(transport));
+            _socketBufferOut->send(msg, ZMQ_SNDMORE);
+
+            if (transport == BufferTransport::shm)
+            {
+                msg.rebuild(sizeof(descriptor));
+                memcpy(msg.data(), (void*)&descriptor, sizeof(descriptor));
+                _socketBufferOut->send(msg);
+            }
+            else
+            {
+                // The token keeps the buffer alive until ZMQ does not need it anymore
+                auto token = new OutgoingBuffer{this, buffer};
+                _otgNumber.fetch_add(1, std::memory_order_acq_rel);
+
+                auto hasPayload = bufferPtr->payloadSize() != 0;
+                msg.rebuild(bufferPtr->data(), bufferPtr->size(), Link::freeOlderBuffer, token);
+                _socketBufferOut->send(msg, hasPayload ? ZMQ_SNDMORE : 0);
+
+                // The payload goes as its own part, so that it is never concatenated to the data
+                if (hasPayload)
+                {
+                    token = new OutgoingBuffer{this, buffer};
+                    _otgNumber.fetch_add(1, std::memory_order_acq_rel);
+
+                    msg.rebuild(bufferPtr->payload(), bufferPtr->payloadSize(), Link::freeOlderBuffer, token);
+                    _socketBufferOut->send(msg);
+                }
+            }
         }
         catch (const zmq::error_t& e)
         {
@@ -218,10 +250,20 @@ bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
 /*************/
 bool Link::sendBuffer(const string& name, const shared_ptr<BufferObject>& object)
 {
-    auto buffer = object->serialize();
+    auto buffer = serialize(object);
+    if (!buffer)
+        return false;
     return sendBuffer(name, std::move(buffer));
 }
 
+/*************/
+shared_ptr<SerializedObject> Link::serialize(const shared_ptr<BufferObject>& object)
+{
+    if (_connectedToOuter && _bufferTransport.load() == BufferTransport::shm)
+        return object->serializeInto([&](size_t size) { return _shmRingOut->acquire(size); });
+    return object->serialize();
+}
+
 /*************/
 bool Link::sendMessage(const string& name, const string& attribute, const Values& message)
 {
@@ -237,72 +279,13 @@ bool Link::sendMessage(const string& name, const string& attribute, const Values
 
     if (_connectedToOuter)
     {
-        try
-        {
-            lock_guard<Spinlock> lock(_msgSendMutex);
-
-            // First we send the name of the target
-            zmq::message_t msg(name.size() + 1);
-            memcpy(msg.data(), (void*)name.c_str(), name.size() + 1);
-            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-            // And the target's attribute
-            msg.rebuild(attribute.size() + 1);
-            memcpy(msg.data(), (void*)attribute.c_str(), attribute.size() + 1);
-            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-            // Helper function to send messages
-            std::function<void(const Values& message)> sendMessage;
-            sendMessage = [&](const Values& message) {
-                // Size of the message
-                int size = message.size();
-                msg.rebuild(sizeof(size));
-                memcpy(msg.data(), (void*)&size, sizeof(size));
-
-                if (message.size() == 0)
-                    _socketMessageOut->send(msg);
-                else
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-                for (uint32_t i = 0; i < message.size(); ++i)
-                {
-                    auto v = message[i];
-                    Value::Type valueType = v.getType();
-
-                    msg.rebuild(sizeof(valueType));
-                    memcpy(msg.data(), (void*)&valueType, sizeof(valueType));
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-                    std::string valueName = v.getName();
-                    msg.rebuild(valueName.size() + 1);
-                    memcpy(msg.data(), valueName.data(), valueName.size() + 1);
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-                    if (valueType == Value::Type::values)
-                        sendMessage(v.as<Values>());
-                    else
-                    {
-                        int valueSize = (valueType == Value::Type::string) ? v.size() + 1 : v.size();
-                        void* value = v.data();
-                        msg.rebuild(valueSize);
-                        memcpy(msg.data(), value, valueSize);
-
-                        if (i != message.size() - 1)
-                            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-                        else
-                            _socketMessageOut->send(msg);
-                    }
-                }
-            };
+        lock_guard<Spinlock> lock(_msgSendMutex);
+        _messageBatch.emplace_back(name, attribute, message);
 
-            // Send the message
-            sendMessage(message);
-        }
-        catch (const zmq::error_t& e)
-        {
-            if (errno != ETERM)
-                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
-        }
+        // Messages from the batching thread are kept until the batch is flushed,
+        // the others are sent right away along with the pending ones to keep them in order
+        if (this_thread::get_id() != _batchThreadId.load())
+            sendMessageBatch();
     }
 
 // We don't display broadcast messages, for visibility
@@ -315,22 +298,58 @@ bool Link::sendMessage(const string& name, const string& attribute, const Values
 }
 
 /*************/
-void Link::freeOlderBuffer(void* data, void* hint)
+void Link::startMessageBatch()
 {
-    Link* ctx = (Link*)hint;
-    lock_guard<Spinlock> lock(ctx->_otgMutex);
-    uint32_t index = 0;
-    for (; index < ctx->_otgBuffers.size(); ++index)
-        if (ctx->_otgBuffers[index]->data() == data)
-            break;
-
-    if (index >= ctx->_otgBuffers.size())
-    {
-        Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " - Buffer to free not found in currently sent buffers list" << Log::endl;
+    _batchThreadId = this_thread::get_id();
+}
+
+/*************/
+void Link::flushMessageBatch()
+{
+    if (this_thread::get_id() == _batchThreadId.load())
+        _batchThreadId = thread::id();
+
+    lock_guard<Spinlock> lock(_msgSendMutex);
+    sendMessageBatch();
+}
+
+/*************/
+void Link::sendMessageBatch()
+{
+    if (_messageBatch.empty())
         return;
+
+    try
+    {
+        // The whole batch is sent as a single frame
+        vector<uint8_t> serializedBatch;
+        Serial::serialize(_messageBatch, serializedBatch);
+        _messageBatch.clear();
+
+        zmq::message_t msg(serializedBatch.size());
+        memcpy(msg.data(), serializedBatch.data(), serializedBatch.size());
+        _socketMessageOut->send(msg);
+    }
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
+    }
+}
+
+/*************/
+void Link::freeOlderBuffer(void* /*data*/, void* hint)
+{
+    auto token = static_cast<OutgoingBuffer*>(hint);
+    auto link = token->link;
+    delete token;
+
+    // Only the release of the last buffer in flight has to wake up the waiting thread
+    if (link->_otgNumber.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        lock_guard<mutex> lock(link->_otgMutex);
+        link->_otgCondition.notify_all();
     }
-    ctx->_otgBuffers.erase(ctx->_otgBuffers.begin() + index);
-    ctx->_otgNumber.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 /*************/
@@ -345,64 +364,36 @@ void Link::handleInputMessages()
         _socketMessageIn->bind((_basePath + "msg_" + _name).c_str());
         _socketMessageIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
 
-        // Helper function to receive messages
         zmq::message_t msg;
-        std::function<Values(void)> recvMessage;
-        recvMessage = [&]() -> Values {
-            _socketMessageIn->recv(&msg); // size of the message
-            int size = *(int*)msg.data();
-
-            Values values;
-            for (int i = 0; i < size; ++i)
-            {
-                _socketMessageIn->recv(&msg);
-                Value::Type valueType = *(Value::Type*)msg.data();
-
-                _socketMessageIn->recv(&msg);
-                string valueName(static_cast<char*>(msg.data()));
-
-                if (valueType == Value::Type::values)
-                {
-                    values.push_back(recvMessage());
-                }
-                else
-                {
-                    _socketMessageIn->recv(&msg);
-                    if (valueType == Value::Type::integer)
-                        values.push_back(*(int64_t*)msg.data());
-                    else if (valueType == Value::Type::real)
-                        values.push_back(*(double*)msg.data());
-                    else if (valueType == Value::Type::string)
-                        values.push_back(string((char*)msg.data()));
-                }
-
-                if (!valueName.empty())
-                    values.back().setName(valueName);
-            }
-            return values;
-        };
-
+        zmq::pollitem_t pollItems[] = {{static_cast<void*>(*_socketMessageIn), 0, ZMQ_POLLIN, 0}};
         while (_running)
         {
-            if (!_socketMessageIn->recv(&msg, ZMQ_DONTWAIT)) // name of the target
-            {
-                std::this_thread::sleep_for(1ms);
+            // Wait for a message to arrive, waking up regularly to check whether we should stop
+            zmq::poll(pollItems, 1, _pollTimeout);
+            if (!(pollItems[0].revents & ZMQ_POLLIN))
                 continue;
-            }
-            string name((char*)msg.data());
-            _socketMessageIn->recv(&msg); // target's attribute
-            string attribute((char*)msg.data());
 
-            Values values = recvMessage();
+            if (!_socketMessageIn->recv(&msg, ZMQ_DONTWAIT))
+                continue;
 
-            if (_rootObject)
-                _rootObject->set(name, attribute, values);
+            auto dataPtr = static_cast<uint8_t*>(msg.data());
+            auto serializedBatch = vector<uint8_t>(dataPtr, dataPtr + msg.size());
+            auto messages = Serial::deserialize<MessageBatch>(serializedBatch);
+
+            for (const auto& message : messages)
+            {
+                const auto& name = std::get<0>(message);
+                const auto& attribute = std::get<1>(message);
+
+                if (_rootObject)
+                    _rootObject->set(name, attribute, std::get<2>(message));
 // We don't display broadcast messages, for visibility
 #ifdef DEBUG
-            if (name != SPLASH_ALL_PEERS)
-                Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " (" << root->getName() << ")"
-                           << " - Receiving message for " << name << "::" << attribute << Log::endl;
+                if (name != SPLASH_ALL_PEERS)
+                    Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " (" << _rootObject->getName() << ")"
+                               << " - Receiving message for " << name << "::" << attribute << Log::endl;
 #endif
+            }
         }
     }
     catch (const zmq::error_t& e)
@@ -424,19 +415,53 @@ void Link::handleInputBuffers()
         _socketBufferIn->bind((_basePath + "buf_" + _name).c_str());
         _socketBufferIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
 
+        zmq::pollitem_t pollItems[] = {{static_cast<void*>(*_socketBufferIn), 0, ZMQ_POLLIN, 0}};
         while (_running)
         {
-            zmq::message_t msg;
+            zmq::poll(pollItems, 1, _pollTimeout);
+            if (!(pollItems[0].revents & ZMQ_POLLIN))
+                continue;
 
+            zmq::message_t msg;
             if (!_socketBufferIn->recv(&msg, ZMQ_DONTWAIT))
-            {
-                std::this_thread::sleep_for(1ms);
                 continue;
-            }
             string name((char*)msg.data());
 
             _socketBufferIn->recv(&msg);
-            shared_ptr<SerializedObject> buffer = make_shared<SerializedObject>(static_cast<uint8_t*>(msg.data()), static_cast<uint8_t*>(msg.data()) + msg.size());
+            auto transport = *static_cast<BufferTransport*>(msg.data());
+
+            _socketBufferIn->recv(&msg);
+            shared_ptr<SerializedObject> buffer;
+            if (transport == BufferTransport::shm)
+            {
+                // The buffer is read in place, the slot being held until the buffer is released
+                ShmRingDescriptor descriptor;
+                memcpy((void*)&descriptor, msg.data(), std::min(sizeof(descriptor), msg.size()));
+                buffer = _shmRingIn.read(descriptor);
+                if (!buffer)
+                {
+                    Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Buffer " << name << " was overwritten before being read, dropping it" << Log::endl;
+                    continue;
+                }
+            }
+            else
+            {
+                auto data = BufferPool::get().allocate(msg.size());
+                memcpy(data.data(), msg.data(), msg.size());
+
+                if (msg.more())
+                {
+                    // The payload is kept in the message it has been received in, to avoid copying it
+                    auto payloadMsg = make_shared<zmq::message_t>();
+                    _socketBufferIn->recv(payloadMsg.get());
+                    auto payload = ResizableArray<uint8_t>(static_cast<uint8_t*>(payloadMsg->data()), payloadMsg->size(), [payloadMsg](uint8_t*) {});
+                    buffer = make_shared<SerializedObject>(std::move(data), std::move(payload));
+                }
+                else
+                {
+                    buffer = make_shared<SerializedObject>(std::move(data));
+                }
+            }
 
             if (_rootObject)
                 _rootObject->setFromSerializedObject(name, std::move(buffer));
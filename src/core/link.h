@@ -27,17 +27,19 @@
 
 #include <atomic>
 #include <chrono>
-#include <deque>
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 #include <zmq.hpp>
 
 #include "./config.h"
 #include "./core/coretypes.h"
 #include "./core/serialized_object.h"
+#include "./core/shm_ring.h"
 #include "./core/spinlock.h"
 #include "./core/value.h"
 
@@ -50,6 +52,14 @@ class BufferObject;
 /*************/
 class Link
 {
+  public:
+    //! Transport used to send buffers to outer peers
+    enum class BufferTransport : uint8_t
+    {
+        ipc, //!< Buffers are sent through the ZMQ socket
+        shm  //!< Buffers are written into a ring of shared memory slots, and only a descriptor goes through the socket
+    };
+
   public:
     /**
      * \brief Constructor
@@ -96,6 +106,14 @@ class Link
      */
     bool sendBuffer(const std::string& name, const std::shared_ptr<BufferObject>& object);
 
+    /**
+     * \brief Serialize a buffer object to be sent to the connected peers. With the shm transport it is
+     * serialized straight into a shared memory slot, so that it is written only once.
+     * \param object Object to serialize
+     * \return Return the serialized object
+     */
+    std::shared_ptr<SerializedObject> serialize(const std::shared_ptr<BufferObject>& object);
+
     /**
      * \brief Send a message to connected peers
      * \param name Destination object name
@@ -115,6 +133,16 @@ class Link
     template <typename T>
     bool sendMessage(const std::string& name, const std::string& attribute, const std::vector<T>& message);
 
+    /**
+     * \brief Start batching the messages sent from the calling thread, until flushMessageBatch is called
+     */
+    void startMessageBatch();
+
+    /**
+     * \brief Send all the batched messages in a single frame, and stop batching
+     */
+    void flushMessageBatch();
+
     /**
      * \brief Check that all buffers were sent to the client
      * \param maximumWait Maximum waiting time
@@ -122,7 +150,35 @@ class Link
      */
     bool waitForBufferSending(std::chrono::milliseconds maximumWait);
 
+    /**
+     * \brief Set the transport used to send buffers to outer peers. Received buffers are handled whatever the transport.
+     * \param transport Buffer transport
+     */
+    void setBufferTransport(BufferTransport transport) { _bufferTransport = transport; }
+
+    /**
+     * \brief Get the transport used to send buffers to outer peers
+     * \return Return the buffer transport
+     */
+    BufferTransport getBufferTransport() const { return _bufferTransport; }
+
+    /**
+     * \brief Check whether the link is connected to peers in other processes
+     * \return Return true if connected to an outer peer
+     */
+    bool isConnectedToOuter() const { return _connectedToOuter; }
+
+    /**
+     * \brief Check whether the link is connected to peers living in the same process
+     * \return Return true if connected to an inner peer
+     */
+    bool isConnectedToInner() const { return _connectedToInner; }
+
   private:
+    using MessageBatch = std::vector<std::tuple<std::string, std::string, Values>>;
+
+    static constexpr long _pollTimeout{100}; //!< Timeout for the receiving sockets, in ms
+
     RootObject* _rootObject;
     std::string _basePath{""};
     std::string _name{""};
@@ -143,9 +199,23 @@ class Link
     Spinlock _msgSendMutex;
     Spinlock _bufferSendMutex;
 
-    std::deque<std::shared_ptr<SerializedObject>> _otgBuffers;
-    Spinlock _otgMutex;
+    MessageBatch _messageBatch{};                  //!< Messages waiting to be sent, protected by _msgSendMutex
+    std::atomic<std::thread::id> _batchThreadId{}; //!< Thread whose messages are currently batched
+
+    //! Token given to ZMQ along with each buffer sent, and given back when the buffer has been sent
+    struct OutgoingBuffer
+    {
+        Link* link;
+        std::shared_ptr<SerializedObject> buffer;
+    };
+
     std::atomic_int _otgNumber{0};
+    std::mutex _otgMutex;
+    std::condition_variable _otgCondition;
+
+    std::atomic<BufferTransport> _bufferTransport{BufferTransport::ipc};
+    std::unique_ptr<ShmRingWriter> _shmRingOut{};
+    ShmRingReader _shmRingIn{};
 
     std::thread _bufferInThread;
     std::thread _messageInThread;
@@ -153,10 +223,15 @@ class Link
     /**
      * \brief Callback to remove the shared_ptr to a sent buffer
      * \param data Pointer to sent data
-     * \param hint Pointer to the Link
+     * \param hint Pointer to the OutgoingBuffer token of the sent buffer
      */
     static void freeOlderBuffer(void* data, void* hint);
 
+    /**
+     * \brief Send the batched messages, _msgSendMutex has to be locked
+     */
+    void sendMessageBatch();
+
     /**
      * \brief Message input thread function
      */
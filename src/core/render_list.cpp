@@ -0,0 +1,64 @@
+#include "./core/render_list.h"
+
+#include <algorithm>
+
+#include "./graphics/camera.h"
+#include "./graphics/texture.h"
+#include "./graphics/window.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+void RenderList::rebuild(const vector<shared_ptr<GraphObject>>& objects, uint64_t generation)
+{
+    _objects.assign(objects.begin(), objects.end());
+    _renderedObjects.clear();
+    _renderedCategories.clear();
+    _groups.clear();
+    _cameras.clear();
+    _textures.clear();
+    _windows.clear();
+
+    vector<shared_ptr<GraphObject>> renderedObjects;
+    for (const auto& object : objects)
+    {
+        if (object->getRenderingPriority() != GraphObject::Priority::NO_RENDER)
+            renderedObjects.push_back(object);
+
+        auto texture = dynamic_pointer_cast<Texture>(object);
+        if (texture)
+            _textures.push_back(texture);
+
+        if (object->getType() == "window")
+            _windows.push_back(dynamic_pointer_cast<Window>(object));
+    }
+
+    // The sort is stable to keep the order of the objects for a same priority
+    stable_sort(renderedObjects.begin(), renderedObjects.end(), [](const shared_ptr<GraphObject>& lhs, const shared_ptr<GraphObject>& rhs) {
+        return lhs->getRenderingPriority() < rhs->getRenderingPriority();
+    });
+
+    for (size_t i = 0; i < renderedObjects.size(); ++i)
+    {
+        const auto& object = renderedObjects[i];
+        _renderedObjects.push_back(object);
+        _renderedCategories.push_back(object->getCategory());
+
+        auto priority = object->getRenderingPriority();
+        // Cameras shifted out of the camera group keep their own rendering order
+        if (priority == GraphObject::Priority::CAMERA && object->getType() == "camera")
+            _cameras.push_back(dynamic_pointer_cast<Camera>(object));
+
+        if (_groups.empty() || _groups.back().priority != priority)
+            _groups.push_back({priority, object->getType(), i, i});
+        _groups.back().end = i + 1;
+    }
+
+    _generation = generation;
+    _built = true;
+}
+
+} // namespace Splash
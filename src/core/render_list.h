@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @render_list.h
+ * The RenderList class, holding the objects of a Scene sorted by rendering priority.
+ * It is rebuilt only when the graph changes, so that rendering a frame does not involve any lookup or cast.
+ * Objects are held as weak references, so that the list does not keep alive the objects removed from the
+ * Scene, nor prevent the disposal of the unused ones (see RootObject::disposeObject).
+ */
+
+#ifndef SPLASH_RENDER_LIST_H
+#define SPLASH_RENDER_LIST_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./core/graph_object.h"
+
+namespace Splash
+{
+
+class Camera;
+class Texture;
+class Window;
+
+/*************/
+class RenderList
+{
+  public:
+    struct Group
+    {
+        GraphObject::Priority priority{GraphObject::Priority::NO_RENDER};
+        std::string timerName{""}; //!< Name of the timer measuring the rendering of this group
+        size_t begin{0};           //!< Index of the first object of the group
+        size_t end{0};             //!< Index past the last object of the group
+    };
+
+  public:
+    /**
+     * \brief Rebuild the list from the given objects
+     * \param objects Objects of the scene, in the order they should be rendered for a same priority
+     * \param generation Generation of the graph the objects come from
+     */
+    void rebuild(const std::vector<std::shared_ptr<GraphObject>>& objects, uint64_t generation);
+
+    /**
+     * \brief Check whether the list was built from the given graph generation
+     * \param generation Graph generation
+     * \return Return true if the list does not need to be rebuilt
+     */
+    bool isUpToDate(uint64_t generation) const { return _built && _generation == generation; }
+
+    /**
+     * \brief Get all the objects, rendered or not
+     * \return Return the objects
+     */
+    const std::vector<std::weak_ptr<GraphObject>>& getObjects() const { return _objects; }
+
+    /**
+     * \brief Get the objects to render, sorted by priority
+     * \return Return the objects
+     */
+    const std::vector<std::weak_ptr<GraphObject>>& getRenderedObjects() const { return _renderedObjects; }
+
+    /**
+     * \brief Get the category of the objects to render, in the same order as getRenderedObjects
+     * \return Return the categories
+     */
+    const std::vector<GraphObject::Category>& getRenderedCategories() const { return _renderedCategories; }
+
+    /**
+     * \brief Get the groups of objects sharing the same priority, sorted by priority
+     * \return Return the groups
+     */
+    const std::vector<Group>& getGroups() const { return _groups; }
+
+    /**
+     * \brief Get the cameras of the camera priority group, in rendering order
+     * \return Return the cameras
+     */
+    const std::vector<std::weak_ptr<Camera>>& getCameras() const { return _cameras; }
+
+    /**
+     * \brief Get the textures
+     * \return Return the textures
+     */
+    const std::vector<std::weak_ptr<Texture>>& getTextures() const { return _textures; }
+
+    /**
+     * \brief Get the windows
+     * \return Return the windows
+     */
+    const std::vector<std::weak_ptr<Window>>& getWindows() const { return _windows; }
+
+  private:
+    bool _built{false};
+    uint64_t _generation{0};
+    std::vector<std::weak_ptr<GraphObject>> _objects{};
+    std::vector<std::weak_ptr<GraphObject>> _renderedObjects{};
+    std::vector<GraphObject::Category> _renderedCategories{};
+    std::vector<Group> _groups{};
+    std::vector<std::weak_ptr<Camera>> _cameras{};
+    std::vector<std::weak_ptr<Texture>> _textures{};
+    std::vector<std::weak_ptr<Window>> _windows{};
+};
+
+} // namespace Splash
+
+#endif // SPLASH_RENDER_LIST_H
@@ -27,6 +27,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <memory>
 
 namespace Splash
@@ -43,6 +44,26 @@ class ResizableArray
      */
     ResizableArray(size_t size = 0) { resize(size); }
 
+    /**
+     * \brief Constructor wrapping an existing buffer, without copying it
+     * \param data Pointer to the buffer
+     * \param size Buffer size
+     * \param deleter Function called with data once the array does not use it anymore
+     */
+    ResizableArray(T* data, size_t size, const std::function<void(T*)>& deleter)
+    {
+        if (data == nullptr || size == 0)
+        {
+            if (data != nullptr && deleter)
+                deleter(data);
+            return;
+        }
+
+        _size = size;
+        _shift = 0;
+        _buffer = Buffer(data, deleter);
+    }
+
     /**
      * \brief Constructor from two iterators
      * \param start Begin iterator
@@ -61,7 +82,7 @@ class ResizableArray
 
         _size = static_cast<size_t>(end - start);
         _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        _buffer = allocate(_size);
         memcpy(data(), start, _size * sizeof(T));
     }
 
@@ -73,7 +94,7 @@ class ResizableArray
     {
         _size = a.size();
         _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        _buffer = allocate(_size);
         memcpy(data(), a.data(), _size);
     }
 
@@ -81,7 +102,7 @@ class ResizableArray
      * \brief Move constructor
      * \param a ResizableArray to move
      */
-    ResizableArray(ResizableArray&& a)
+    ResizableArray(ResizableArray&& a) noexcept
         : _size(a._size)
         , _shift(a._shift)
         , _buffer(std::move(a._buffer))
@@ -99,7 +120,7 @@ class ResizableArray
 
         _size = a.size();
         _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        _buffer = allocate(_size);
         memcpy(data(), a.data(), _size);
 
         return *this;
@@ -109,7 +130,7 @@ class ResizableArray
      * \brief Move operator
      * \param a ResizableArray to move from
      */
-    ResizableArray& operator=(ResizableArray&& a)
+    ResizableArray& operator=(ResizableArray&& a) noexcept
     {
         if (this == &a)
             return *this;
@@ -173,7 +194,7 @@ class ResizableArray
         }
         else
         {
-            auto newBuffer = std::unique_ptr<T[]>(new T[size]);
+            auto newBuffer = allocate(size);
             if (_size != 0)
             {
                 if (size > _size)
@@ -188,9 +209,21 @@ class ResizableArray
     }
 
   private:
-    size_t _size{0};                       //!< Buffer size
-    size_t _shift{0};                      //!< Buffer shift
-    std::unique_ptr<T[]> _buffer{nullptr}; //!< Pointer to the buffer data
+    using Buffer = std::unique_ptr<T[], std::function<void(T*)>>;
+
+    size_t _size{0};         //!< Buffer size
+    size_t _shift{0};        //!< Buffer shift
+    Buffer _buffer{nullptr}; //!< Pointer to the buffer data
+
+    /**
+     * \brief Allocate a buffer owned by the array
+     * \param size Buffer size
+     * \return Return the allocated buffer
+     */
+    static Buffer allocate(size_t size)
+    {
+        return Buffer(new T[size], [](T* ptr) { delete[] ptr; });
+    }
 };
 
 } // namespace Splash
@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "./core/buffer_object.h"
+#include "./core/buffer_pool.h"
 #include "./core/serialize/serialize_uuid.h"
 #include "./core/serialize/serialize_value.h"
 #include "./core/serializer.h"
@@ -66,6 +67,7 @@ weak_ptr<GraphObject> RootObject::createObject(const string& type, const string&
         object->setName(name);
         object->setSavable(false);
         _objects[name] = object;
+        signalGraphUpdated();
         return object;
     }
 }
@@ -77,7 +79,10 @@ void RootObject::disposeObject(const string& name)
         lock_guard<recursive_mutex> registerLock(_objectsMutex);
         auto objectIt = _objects.find(name);
         if (objectIt != _objects.end() && objectIt->second.use_count() == 1)
+        {
             _objects.erase(objectIt);
+            signalGraphUpdated();
+        }
     });
 }
 
@@ -234,8 +239,7 @@ bool RootObject::handleSerializedObject(const string& name, shared_ptr<Serialize
     {
         auto dataPtr = reinterpret_cast<uint8_t*>(obj->data());
         auto serializedSeeds = vector<uint8_t>(dataPtr, dataPtr + obj->size());
-        auto seeds = Serial::deserialize<list<Tree::Seed>>(serializedSeeds);
-        _tree.addSeedsToQueue(seeds);
+        _tree.addSeedsToQueue(Serial::deserialize<Tree::SeedList>(serializedSeeds));
 
         return true;
     }
@@ -260,52 +264,94 @@ void RootObject::updateTreeFromObjects()
         _tree.setValueForLeafAt(path, Values({std::get<1>(log), static_cast<int>(std::get<2>(log))}));
     }
 
+    // Leaf handles are created once per leaf, so that the paths are not built and parsed at each update
+    auto getLeafHandle = [](unordered_map<string, Tree::LeafHandle>& handles, const string& name, const auto& getPath) -> const Tree::LeafHandle& {
+        auto handleIt = handles.find(name);
+        if (handleIt == handles.end())
+            handleIt = handles.emplace(name, Tree::LeafHandle(getPath())).first;
+        return handleIt->second;
+    };
+
     // Update durations
     auto& durationMap = Timer::get().getDurationMap();
     for (auto& d : durationMap)
     {
-        string path = "/" + _name + "/durations/" + d.first;
-        if (!_tree.hasLeafAt(path))
-            if (!_tree.createLeafAt(path))
+        const auto& handle = getLeafHandle(_durationLeafHandles, d.first, [&]() { return "/" + _name + "/durations/" + d.first; });
+        if (!_tree.hasLeaf(handle))
+            if (!_tree.createLeafAt(handle.getPath()))
+                continue;
+        _tree.setValueForLeaf(handle, Values({Value(static_cast<int>(d.second))}));
+    }
+
+    // Update buffer pool and tree seeds statistics
+    static const string statNames[] = {
+        "bufferPool_allocations", "bufferPool_recycledAllocations", "bufferPool_recycledBytes", "bufferPool_cachedBytes", "tree_generatedSeeds", "tree_coalescedSeeds"};
+    auto poolStats = BufferPool::get().getStats();
+    auto seedCounts = _tree.getSeedCounts();
+    const uint64_t statValues[] = {
+        poolStats.allocations, poolStats.recycledAllocations, poolStats.recycledBytes, poolStats.cachedBytes, seedCounts.first, seedCounts.second};
+    for (size_t i = 0; i < sizeof(statValues) / sizeof(uint64_t); ++i)
+    {
+        const auto& handle = getLeafHandle(_statsLeafHandles, statNames[i], [&]() { return "/" + _name + "/stats/" + statNames[i]; });
+        if (!_tree.hasLeaf(handle))
+            if (!_tree.createLeafAt(handle.getPath()))
                 continue;
-        _tree.setValueForLeafAt(path, Values({Value(static_cast<int>(d.second))}));
+        _tree.setValueForLeaf(handle, Values({Value(static_cast<int64_t>(statValues[i]))}));
     }
 
+    // Only the attributes modified since the last update are copied to the tree. As some values
+    // change without their setter being called, each object is also fully updated periodically,
+    // the objects being spread over the period
+    auto updateIndex = _treeUpdateIndex++;
+
     // Update the Root object attributes
-    auto attributePath = string("/" + _name + "/attributes");
-    assert(_tree.hasBranchAt(attributePath));
+    assert(_tree.hasBranchAt("/" + _name + "/attributes"));
 
     unique_lock<recursive_mutex> lock(_attribMutex);
-    for (const auto& leafName : _tree.getLeafListAt(attributePath))
+    for (const auto& attributeName : getDirtyAttributes(updateIndex % _treeFullUpdatePeriod == 0))
     {
-        auto attribIt = _attribFunctions.find(leafName);
-        if (attribIt == _attribFunctions.end())
-            continue;
-        Values attribValue = attribIt->second();
-        _tree.setValueForLeafAt(attributePath + "/" + leafName, attribValue);
+        Values attribValue = _attribFunctions[attributeName]();
+        const auto& handle = getLeafHandle(_attributeLeafHandles, attributeName, [&]() { return "/" + _name + "/attributes/" + attributeName; });
+        _tree.setValueForLeaf(handle, attribValue);
     }
 
     // Update the GraphObjects attributes
     auto objectsPath = string("/" + _name + "/objects");
     assert(_tree.hasBranchAt(objectsPath));
 
+    uint32_t objectIndex = 0;
     for (const auto& objectName : _tree.getBranchListAt(objectsPath))
     {
         auto objectIt = _objects.find(objectName);
         if (objectIt == _objects.end())
             continue;
         auto object = objectIt->second;
+        auto fullUpdate = (updateIndex + objectIndex++) % _treeFullUpdatePeriod == 0;
+
+        auto dirtyAttributes = object->getDirtyAttributes(fullUpdate);
+        if (dirtyAttributes.empty())
+            continue;
 
-        attributePath = string("/" + _name + "/objects/" + objectName + "/attributes");
-        assert(_tree.hasBranchAt(attributePath));
+        assert(_tree.hasBranchAt(objectsPath + "/" + objectName + "/attributes"));
 
-        for (const auto& leafName : _tree.getLeafListAt(attributePath))
+        auto& objectLeafHandles = _objectAttributeLeafHandles[objectName];
+        for (const auto& attributeName : dirtyAttributes)
         {
             Values attribValue;
-            object->getAttribute(leafName, attribValue);
-            _tree.setValueForLeafAt(attributePath + "/" + leafName, attribValue);
+            object->getAttribute(attributeName, attribValue);
+            const auto& handle = getLeafHandle(objectLeafHandles, attributeName, [&]() { return objectsPath + "/" + objectName + "/attributes/" + attributeName; });
+            _tree.setValueForLeaf(handle, attribValue);
         }
     }
+
+    // Forget about the handles of the objects which do not exist anymore
+    for (auto handlesIt = _objectAttributeLeafHandles.begin(); handlesIt != _objectAttributeLeafHandles.end();)
+    {
+        if (_objects.find(handlesIt->first) == _objects.end())
+            handlesIt = _objectAttributeLeafHandles.erase(handlesIt);
+        else
+            ++handlesIt;
+    }
 }
 
 /*************/
@@ -355,6 +401,7 @@ void RootObject::initializeTree()
     _tree.createBranchAt("/world/durations");
     _tree.createBranchAt("/world/logs");
     _tree.createBranchAt("/world/objects");
+    _tree.createBranchAt("/world/stats");
 
     // Clear the seed list, all these leaves being automatically added to all root objets
     _tree.clearSeedList();
@@ -577,6 +624,8 @@ Values RootObject::sendMessageWithAnswer(const string& name, const string& attri
 
     unique_lock<mutex> conditionLock(_conditionMutex);
     _link->sendMessage(name, attribute, message);
+    // The message must not stay in a batch while waiting for the answer
+    _link->flushMessageBatch();
 
     auto cvStatus = cv_status::no_timeout;
     if (timeout == 0ull)
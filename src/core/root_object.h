@@ -114,6 +114,12 @@ class RootObject : public BaseObject
      */
     std::string getSocketPrefix() const { return _linkSocketPrefix; }
 
+    /**
+     * \brief Check whether buffers are sent to peers living in the same process
+     * \return Return true if connected to an inner peer
+     */
+    bool isConnectedToInner() const { return _link && _link->isConnectedToInner(); }
+
     /**
      * \brief Get the configuration path
      * \return Return the configuration path
@@ -121,7 +127,7 @@ class RootObject : public BaseObject
     std::string getConfigurationPath() const
     {
         Value value;
-        _tree.getValueForLeafAt("/world/attributes/configurationPath", value);
+        _tree.getValueForLeaf(_configurationPathLeafHandle, value);
         if (value.size() > 0 && value.getType() == Value::Type::values)
             return value[0].as<std::string>();
         return "";
@@ -134,7 +140,7 @@ class RootObject : public BaseObject
     std::string getMediaPath() const
     {
         Value value;
-        _tree.getValueForLeafAt("/world/attributes/mediaPath", value);
+        _tree.getValueForLeaf(_mediaPathLeafHandle, value);
         if (value.size() > 0 && value.getType() == Value::Type::values)
             return value[0].as<std::string>();
         return "";
@@ -181,11 +187,27 @@ class RootObject : public BaseObject
      */
     void signalBufferObjectUpdated();
 
+    /**
+     * \brief Signals that the graph changed, i.e. objects were added, removed, linked, unlinked or had their rendering priority modified
+     */
+    void signalGraphUpdated() { ++_graphGeneration; }
+
   protected:
     Tree::Root _tree{}; //!< Configuration / status tree, shared between all root objects
     std::unordered_map<std::string, int> _treeCallbackIds{};
     std::unordered_map<std::string, CallbackHandle> _attributeCallbackHandles{};
 
+    static constexpr uint32_t _treeFullUpdatePeriod{30}; //!< Objects have all their attributes copied to the tree once every this number of updates
+    uint32_t _treeUpdateIndex{0};                        //!< Number of calls to updateTreeFromObjects
+
+    // Handles to the leaves updated at each frame, to avoid parsing their paths each time
+    const Tree::LeafHandle _configurationPathLeafHandle{"/world/attributes/configurationPath"};
+    const Tree::LeafHandle _mediaPathLeafHandle{"/world/attributes/mediaPath"};
+    std::unordered_map<std::string, Tree::LeafHandle> _durationLeafHandles{};
+    std::unordered_map<std::string, Tree::LeafHandle> _statsLeafHandles{};
+    std::unordered_map<std::string, Tree::LeafHandle> _attributeLeafHandles{};
+    std::unordered_map<std::string, std::unordered_map<std::string, Tree::LeafHandle>> _objectAttributeLeafHandles{};
+
     std::unique_ptr<Factory> _factory{}; //!< Object factory
     std::unique_ptr<Link> _link{};       //!< Link object for communicatin between World and Scene
     std::string _linkSocketPrefix{""}; //!< Prefix to add to shared memory socket paths
@@ -205,6 +227,7 @@ class RootObject : public BaseObject
     mutable std::recursive_mutex _objectsMutex{};                   //!< Used in registration and unregistration of objects
     std::atomic_bool _objectsCurrentlyUpdated{false};               //!< Prevents modification of objects from multiple places at the same time
     DenseMap<std::string, std::shared_ptr<GraphObject>> _objects{}; //!< Map of all the objects
+    std::atomic<uint64_t> _graphGeneration{0};                      //!< Incremented each time the graph changes
 
     /**
      * \brief Wait for a BufferObject update. This does not prevent spurious wakeups.
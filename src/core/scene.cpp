@@ -9,8 +9,10 @@
 #include "./graphics/camera.h"
 #include "./graphics/filter.h"
 #include "./graphics/geometry.h"
+#include "./graphics/multiview_renderer.h"
 #include "./graphics/object.h"
 #include "./graphics/profiler_gl.h"
+#include "./graphics/program_cache.h"
 #include "./graphics/texture.h"
 #include "./graphics/texture_image.h"
 #include "./graphics/warp.h"
@@ -104,6 +106,11 @@ Scene::~Scene()
     _objects.clear();
     for (auto& obj : _objects)
         obj.second.reset();
+    _renderList = RenderList();
+    _multiviewRenderer.reset();
+
+    // Programs live as long as the context they were created in
+    ProgramCache::get().clear();
 
     _mainWindow->releaseContext();
 
@@ -144,6 +151,7 @@ std::shared_ptr<GraphObject> Scene::addObject(const string& type, const string&
 
         obj->setName(name);
         _objects[name] = obj;
+        signalGraphUpdated();
 
         // Some objects have to be connected to the gui (if the Scene is master)
         if (_gui != nullptr)
@@ -220,12 +228,20 @@ void Scene::remove(const string& name)
     lock_guard<recursive_mutex> lockObjects(_objectsMutex);
 
     if (_objects.find(name) != _objects.end())
+    {
         _objects.erase(name);
+        signalGraphUpdated();
+    }
 }
 
 /*************/
 void Scene::render()
 {
+    {
+        lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+        updateRenderList();
+    }
+
     // We want to have as much time as possible for uploading the textures,
     // so we start it right now.
     if (!_threadedTextureUpload)
@@ -233,13 +249,9 @@ void Scene::render()
         bool expectedAtomicValue = false;
         if (!_doUploadTextures.compare_exchange_strong(expectedAtomicValue, false, std::memory_order_acq_rel))
         {
-            lock_guard<recursive_mutex> lockObjects(_objectsMutex);
-            for (auto& obj : _objects)
-            {
-                auto texture = dynamic_pointer_cast<Texture>(obj.second);
-                if (texture)
+            for (const auto& weakTexture : _renderList.getTextures())
+                if (auto texture = weakTexture.lock())
                     texture->update();
-            }
         }
     }
 
@@ -247,42 +259,25 @@ void Scene::render()
 #ifdef PROFILE
         PROFILEGL("Render loop")
 #endif
-        // Create lists of objects to update and to render
-        map<GraphObject::Priority, vector<shared_ptr<GraphObject>>> objectList{};
+        // We also run all pending tasks for every object
         {
             lock_guard<recursive_mutex> lockObjects(_objectsMutex);
-            for (auto obj = _objects.cbegin(); obj != _objects.cend(); ++obj)
-            {
-                // We also run all pending tasks for every object
-                obj->second->runTasks();
-
-                auto priority = obj->second->getRenderingPriority();
-                if (priority == GraphObject::Priority::NO_RENDER)
-                    continue;
-
-                auto listIt = objectList.find(priority);
-                if (listIt == objectList.end())
-                {
-                    auto entry = objectList.emplace(std::make_pair(priority, vector<shared_ptr<GraphObject>>()));
-                    if (entry.second == true)
-                        listIt = entry.first;
-                    else
-                        continue;
-                }
-
-                listIt->second.push_back(obj->second);
-            }
+            for (const auto& weakObject : _renderList.getObjects())
+                if (auto obj = weakObject.lock())
+                    obj->runTasks();
         }
 
         // Update and render the objects
         // See GraphObject::getRenderingPriority() for precision about priorities
+        const auto& renderedObjects = _renderList.getRenderedObjects();
+        const auto& renderedCategories = _renderList.getRenderedCategories();
         bool firstTextureSync = true; // Sync with the texture upload the first time we need textures
         bool firstWindowSync = true;  // Sync with the texture upload the last time we need textures
         auto textureLock = unique_lock<Spinlock>(_textureMutex, defer_lock);
-        for (auto& objPriority : objectList)
+        for (auto& group : _renderList.getGroups())
         {
             // If the objects needs some Textures, we need to sync
-            if (firstTextureSync && objPriority.first > GraphObject::Priority::BLENDING && objPriority.first < GraphObject::Priority::POST_CAMERA)
+            if (firstTextureSync && group.priority > GraphObject::Priority::BLENDING && group.priority < GraphObject::Priority::POST_CAMERA)
             {
 #ifdef PROFILE
                 PROFILEGL("texture upload lock");
@@ -298,17 +293,28 @@ void Scene::render()
                 firstTextureSync = false;
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() << objPriority.second[0]->getType();
+            Timer::get() << group.timerName;
 
-            for (auto& obj : objPriority.second)
+            // Cameras looking at the same objects are rendered together, after being updated
+            const bool isCameraGroup = group.priority == GraphObject::Priority::CAMERA;
+            if (isCameraGroup)
             {
+                if (!_multiviewRenderer)
+                    _multiviewRenderer = make_unique<MultiviewRenderer>();
+                _multiviewRenderer->setCameras(_renderList.getCameras());
+            }
+
+            for (auto index = group.begin; index < group.end; ++index)
+            {
+                const auto obj = renderedObjects[index].lock();
+                if (!obj)
+                    continue;
 #ifdef PROFILE
                 PROFILEGL("object " + obj->getName());
 #endif
                 obj->update();
 
-                auto objectCategory = obj->getCategory();
+                auto objectCategory = renderedCategories[index];
                 if (objectCategory == GraphObject::Category::MESH)
                     if (obj->wasUpdated())
                     {
@@ -320,13 +326,18 @@ void Scene::render()
                     if (obj->wasUpdated())
                         obj->setNotUpdated();
 
+                if (isCameraGroup && _multiviewRenderer->isRenderedAsView(obj.get()))
+                    continue;
+
                 obj->render();
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() >> objPriority.second[0]->getType();
+            if (isCameraGroup)
+                _multiviewRenderer->render();
 
-            if (firstWindowSync && objPriority.first >= GraphObject::Priority::POST_CAMERA)
+            Timer::get() >> group.timerName;
+
+            if (firstWindowSync && group.priority >= GraphObject::Priority::POST_CAMERA)
             {
 #ifdef PROFILE
                 PROFILEGL("texture upload unlock");
@@ -346,9 +357,9 @@ void Scene::render()
 #endif
             // Swap all buffers at once
             Timer::get() << "swap";
-            for (auto& obj : _objects)
-                if (obj.second->getType() == "window")
-                    dynamic_pointer_cast<Window>(obj.second)->swapBuffers();
+            for (const auto& weakWindow : _renderList.getWindows())
+                if (auto window = weakWindow.lock())
+                    window->swapBuffers();
             Timer::get() >> "swap";
         }
     }
@@ -358,6 +369,20 @@ void Scene::render()
 #endif
 }
 
+/*************/
+void Scene::updateRenderList()
+{
+    auto generation = _graphGeneration.load();
+    if (_renderList.isUpToDate(generation))
+        return;
+
+    vector<shared_ptr<GraphObject>> objects;
+    objects.reserve(_objects.size());
+    for (const auto& obj : _objects)
+        objects.push_back(obj.second);
+    _renderList.rebuild(objects, generation);
+}
+
 /*************/
 void Scene::run()
 {
@@ -473,12 +498,9 @@ void Scene::textureUploadRun()
             if (_objectsCurrentlyUpdated.compare_exchange_strong(expectedAtomicValue, true, std::memory_order_acquire))
             {
                 lock_guard<recursive_mutex> lockObjects(_objectsMutex);
-                for (auto& obj : _objects)
-                {
-                    auto texture = dynamic_pointer_cast<Texture>(obj.second);
-                    if (texture)
-                        textures.emplace_back(texture);
-                }
+                for (const auto& weakTexture : _renderList.getTextures())
+                    if (auto texture = weakTexture.lock())
+                        textures.push_back(texture);
                 _objectsCurrentlyUpdated.store(false, std::memory_order_release);
             }
 
@@ -585,6 +607,8 @@ void Scene::setAsMaster(const string& configFilePath)
     _geometricCalibrator->setName("geometricCalibrator");
     _objects["geometricCalibrator"] = _geometricCalibrator;
 #endif
+
+    signalGraphUpdated();
 }
 
 /*************/
@@ -893,6 +917,7 @@ void Scene::registerAttributes()
                 for (auto& localObject : _objects)
                     unlink(object, localObject.second);
                 _objects.erase(objectName);
+                signalGraphUpdated();
             });
 
             return true;
@@ -954,12 +979,16 @@ void Scene::registerAttributes()
         {'n'});
     setAttributeDescription("logToFile", "If set to 1, the process holding the Scene will try to write log to file");
 
-    addAttribute("ping", [&](const Values&) {
+    addAttribute("ping", [&](const Values& args) {
         signalBufferObjectUpdated();
-        sendMessageToWorld("pong", {_name});
+        // Send back the timestamp if any, for the World to measure the round-trip latency
+        auto answer = Values({_name});
+        if (!args.empty())
+            answer.push_back(args[0]);
+        sendMessageToWorld("pong", answer);
         return true;
     });
-    setAttributeDescription("ping", "Ping the World");
+    setAttributeDescription("ping", "Ping the World, answering with the given timestamp if any");
 
     addAttribute("sync", [&](const Values&) {
         addTask([=]() { sendMessageToWorld("answerMessage", {"sync", _name}); });
@@ -1150,6 +1179,7 @@ void Scene::initializeTree()
     _tree.createBranchAt("/" + _name + "/durations");
     _tree.createBranchAt("/" + _name + "/logs");
     _tree.createBranchAt("/" + _name + "/objects");
+    _tree.createBranchAt("/" + _name + "/stats");
 }
 
 } // namespace Splash
@@ -36,6 +36,7 @@
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
 #include "./core/factory.h"
+#include "./core/render_list.h"
 #include "./core/root_object.h"
 #include "./core/spinlock.h"
 #include "./graphics/gl_window.h"
@@ -46,6 +47,7 @@ namespace Splash
 
 class ControllerObject;
 class Gui;
+class MultiviewRenderer;
 class Scene;
 
 /*************/
@@ -235,6 +237,9 @@ class Scene : public RootObject
     unsigned long long _targetFrameDuration{0}; //!< Duration in microseconds of a frame at the refresh rate of the
                                                 //!< primary monitor
 
+    RenderList _renderList{}; //!< Objects sorted by rendering priority, rebuilt when the graph changes
+    std::unique_ptr<MultiviewRenderer> _multiviewRenderer{nullptr}; //!< Renders the cameras sharing their objects in a single pass
+
     // Texture upload context
     std::future<void> _textureUploadFuture;
     std::shared_ptr<GlWindow> _textureUploadWindow;
@@ -287,6 +292,11 @@ class Scene : public RootObject
      */
     void textureUploadRun();
 
+    /**
+     * \brief Rebuild the render list if the graph changed since it was last built. Objects should be locked first.
+     */
+    void updateRenderList();
+
     /**
      * \brief Register new attributes
      */
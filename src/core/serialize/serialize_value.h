@@ -71,20 +71,26 @@ struct deserializeHelper<T, typename std::enable_if<std::is_same<T, Value::Buffe
 };
 
 // Specialisation of serialization for Splash::Value
+// If the Value has a name, the type is flagged and the name follows it. Otherwise only the type is stored.
+const uint8_t valueNameFlag = 0x80;
+
 template <class T>
 struct getSizeHelper<T, typename std::enable_if<std::is_same<T, Value>::value>::type>
 {
     static uint32_t value(const Value& obj)
     {
         uint32_t acc = sizeof(Value::Type);
+        const auto& objName = obj.getName();
+        if (!objName.empty())
+            acc += getSize(objName);
         auto objType = obj.getType();
 
         if (objType == Value::Type::string)
-            return acc + getSize(obj.as<std::string>());
+            return acc + getSize(obj.asRef<std::string>());
         else if (objType == Value::Type::values)
-            return acc + getSize(obj.as<Values>());
+            return acc + getSize(obj.asRef<Values>());
         else if (objType == Value::Type::buffer)
-            return acc + getSize(obj.as<Value::Buffer>());
+            return acc + getSize(obj.asRef<Value::Buffer>());
         else
             return acc + obj.size();
     }
@@ -96,19 +102,28 @@ struct serializeHelper<T, typename std::enable_if<std::is_same<T, Value>::value>
     static void apply(const Value& obj, std::vector<uint8_t>::iterator& it)
     {
         auto objType = obj.getType();
-        serializer(static_cast<typename std::underlying_type<Value::Type>::type>(objType), it);
+        const auto& objName = obj.getName();
+        if (objName.empty())
+        {
+            serializer(static_cast<typename std::underlying_type<Value::Type>::type>(objType), it);
+        }
+        else
+        {
+            serializer(static_cast<typename std::underlying_type<Value::Type>::type>(objType | valueNameFlag), it);
+            serializer(objName, it);
+        }
 
         if (objType == Value::Type::string)
         {
-            serializer(obj.as<std::string>(), it);
+            serializer(obj.asRef<std::string>(), it);
         }
         else if (objType == Value::Type::values)
         {
-            serializer(obj.as<Values>(), it);
+            serializer(obj.asRef<Values>(), it);
         }
         else if (objType == Value::Type::buffer)
         {
-            serializer(obj.as<Value::Buffer>(), it);
+            serializer(obj.asRef<Value::Buffer>(), it);
         }
         else
         {
@@ -125,9 +140,13 @@ struct deserializeHelper<T, typename std::enable_if<std::is_same<T, Value>::valu
     static Value apply(std::vector<uint8_t>::const_iterator& it)
     {
         T obj;
-        Value::Type type;
-        std::copy(it, it + sizeof(Value::Type), reinterpret_cast<char*>(&type));
-        it += sizeof(Value::Type);
+        auto type = static_cast<Value::Type>(deserializer<typename std::underlying_type<Value::Type>::type>(it));
+        std::string name;
+        if (type & valueNameFlag)
+        {
+            type = static_cast<Value::Type>(type & ~valueNameFlag);
+            name = deserializer<std::string>(it);
+        }
 
         switch (type)
         {
@@ -151,6 +170,9 @@ struct deserializeHelper<T, typename std::enable_if<std::is_same<T, Value>::valu
             break;
         }
 
+        if (!name.empty())
+            obj.setName(name);
+
         return obj;
     }
 };
@@ -25,6 +25,8 @@
 #ifndef SPLASH_SERIALIZED_OBJECT_H
 #define SPLASH_SERIALIZED_OBJECT_H
 
+#include <any>
+
 #include "./core/resizable_array.h"
 
 namespace Splash
@@ -54,6 +56,26 @@ struct SerializedObject
     {
     }
 
+    /**
+     * \brief Constructor taking ownership of an existing array
+     * \param data Array to hold
+     */
+    explicit SerializedObject(ResizableArray<uint8_t>&& data)
+        : _data(std::move(data))
+    {
+    }
+
+    /**
+     * \brief Constructor from a header and a separate payload, which are never concatenated on the sending side
+     * \param data Header array
+     * \param payload Payload array, usually wrapping memory owned by the serialized object itself
+     */
+    SerializedObject(ResizableArray<uint8_t>&& data, ResizableArray<uint8_t>&& payload)
+        : _data(std::move(data))
+        , _payload(std::move(payload))
+    {
+    }
+
     /**
      * \brief Get the pointer to the data
      * \return Return a pointer to the data
@@ -72,6 +94,46 @@ struct SerializedObject
      */
     inline std::size_t size() { return _data.size(); }
 
+    /**
+     * \brief Get the pointer to the payload, if any
+     * \return Return a pointer to the payload
+     */
+    inline uint8_t* payload() { return _payload.data(); }
+
+    /**
+     * \brief Get ownership over the payload. Use with caution, as it invalidates the SerializedObject
+     * \return Return the payload as a rvalue
+     */
+    inline ResizableArray<uint8_t>&& grabPayload() { return std::move(_payload); }
+
+    /**
+     * \brief Get the size of the payload
+     * \return Return the size, 0 if there is no separate payload
+     */
+    inline std::size_t payloadSize() { return _payload.size(); }
+
+    /**
+     * \brief Check whether the object holds an in-process handle
+     * \return Return true if there is a handle
+     */
+    inline bool hasHandle() const { return _handle.has_value(); }
+
+    /**
+     * \brief Get the in-process handle, if it is of the given type
+     * \return Return a pointer to the handle, or nullptr
+     */
+    template <typename T>
+    inline const T* getHandle() const
+    {
+        return std::any_cast<T>(&_handle);
+    }
+
+    /**
+     * \brief Get the size of the data and the payload together
+     * \return Return the total size
+     */
+    inline std::size_t totalSize() { return _data.size() + _payload.size(); }
+
     /**
      * \brief Modify the size of the data
      * \param s New size
@@ -80,6 +142,10 @@ struct SerializedObject
 
     //! Inner buffer
     ResizableArray<uint8_t> _data{};
+    //! Optional payload, following the inner buffer once sent
+    ResizableArray<uint8_t> _payload{};
+    //! Optional handle over the source buffer, only meaningful within the process which created it
+    std::any _handle{};
 };
 
 } // end of namespace
@@ -0,0 +1,289 @@
+#include "./core/shm_ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./utils/log.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+constexpr chrono::seconds ShmRingWriter::_pendingTimeout;
+
+/*************/
+ShmRingWriter::ShmRingWriter(const string& name, uint32_t maxSlotCount)
+    : _name(name)
+    , _maxSlotCount(maxSlotCount)
+{
+}
+
+/*************/
+ShmRingMapping::~ShmRingMapping()
+{
+    if (data)
+        munmap(data, length);
+}
+
+/*************/
+ShmRingWriter::~ShmRingWriter()
+{
+    // Readers keep their mappings valid after the segments are unlinked, as do the slots still held by the writer side
+    for (auto& slot : _slots)
+        shm_unlink(slot.name.c_str());
+}
+
+/*************/
+ResizableArray<uint8_t> ShmRingWriter::acquire(size_t size)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    for (uint32_t i = 0; i < _slots.size(); ++i)
+    {
+        auto index = (_nextSlot + i) % _slots.size();
+        auto data = acquireSlot(index, size);
+        if (data.size() != 0)
+        {
+            _nextSlot = (index + 1) % _slots.size();
+            return data;
+        }
+    }
+
+    // All slots are in use, try to add one
+    if (_slots.size() >= _maxSlotCount || !createSlot(size))
+        return {};
+    return acquireSlot(_slots.size() - 1, size);
+}
+
+/*************/
+ResizableArray<uint8_t> ShmRingWriter::acquireSlot(uint32_t index, size_t size)
+{
+    auto& slot = _slots[index];
+    if (slot.held->load())
+        return {};
+
+    auto header = reinterpret_cast<ShmRingSlotHeader*>(slot.mapping->data);
+    if (header->readers.load() != 0)
+        return {};
+    if (header->pending.load() != 0 && chrono::steady_clock::now() - slot.sendTime < _pendingTimeout)
+        return {};
+
+    // Mark the slot as being written, then check again that nobody grabbed it in between.
+    // A reader increments the readers count before checking the generation, so one of us will notice the other.
+    header->generation.store(slot.generation + 1);
+    if (header->readers.load() != 0)
+    {
+        header->generation.store(slot.generation);
+        return {};
+    }
+
+    if (slot.mapping->length - sizeof(ShmRingSlotHeader) < size && !growSlot(slot, size))
+    {
+        header->generation.store(slot.generation);
+        return {};
+    }
+
+    header = reinterpret_cast<ShmRingSlotHeader*>(slot.mapping->data);
+    header->pending.store(0);
+    slot.held->store(true);
+
+    // The mapping stays valid as long as the array lives, even if the ring is destroyed in between
+    auto mapping = slot.mapping;
+    auto held = slot.held;
+    return ResizableArray<uint8_t>(mapping->data + sizeof(ShmRingSlotHeader), size, [mapping, held](uint8_t*) { held->store(false); });
+}
+
+/*************/
+bool ShmRingWriter::commit(const shared_ptr<SerializedObject>& buffer, uint32_t readerCount, ShmRingDescriptor& descriptor)
+{
+    if (!buffer || buffer->payloadSize() != 0)
+        return false;
+
+    lock_guard<mutex> lock(_mutex);
+
+    auto slotIt = find_if(_slots.begin(), _slots.end(), [&](const Slot& slot) { return slot.held->load() && slot.mapping->data + sizeof(ShmRingSlotHeader) == buffer->data(); });
+    if (slotIt == _slots.end())
+        return false;
+
+    auto& slot = *slotIt;
+    auto header = reinterpret_cast<ShmRingSlotHeader*>(slot.mapping->data);
+    slot.generation += 2;
+    slot.sendTime = chrono::steady_clock::now();
+    header->pending.store(readerCount);
+    header->generation.store(slot.generation);
+
+    descriptor.generation = slot.generation;
+    descriptor.size = buffer->size();
+    descriptor.capacity = slot.mapping->length - sizeof(ShmRingSlotHeader);
+    strncpy(descriptor.segmentName, slot.name.c_str(), ShmRingDescriptor::segmentNameLength - 1);
+    return true;
+}
+
+/*************/
+bool ShmRingWriter::write(const shared_ptr<SerializedObject>& buffer, uint32_t readerCount, ShmRingDescriptor& descriptor)
+{
+    auto data = acquire(buffer->totalSize());
+    if (data.size() == 0)
+        return false;
+
+    memcpy(data.data(), buffer->data(), buffer->size());
+    if (buffer->payloadSize() != 0)
+        memcpy(data.data() + buffer->size(), buffer->payload(), buffer->payloadSize());
+
+    // The slot is released by the writer side right away, it is then held until all readers read it
+    return commit(make_shared<SerializedObject>(std::move(data)), readerCount, descriptor);
+}
+
+/*************/
+bool ShmRingWriter::createSlot(size_t capacity)
+{
+    Slot slot;
+    slot.name = _name + "_" + to_string(_slots.size());
+    if (slot.name.size() >= ShmRingDescriptor::segmentNameLength)
+    {
+        Log::get() << Log::WARNING << "ShmRingWriter::" << __FUNCTION__ << " - Segment name " << slot.name << " is too long" << Log::endl;
+        return false;
+    }
+
+    // Remove any leftover from a previous run
+    shm_unlink(slot.name.c_str());
+    auto fd = shm_open(slot.name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        Log::get() << Log::WARNING << "ShmRingWriter::" << __FUNCTION__ << " - Unable to create shared memory segment " << slot.name << ": " << string(strerror(errno)) << Log::endl;
+        return false;
+    }
+
+    auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto length = ((sizeof(ShmRingSlotHeader) + capacity + pageSize - 1) / pageSize) * pageSize;
+    if (ftruncate(fd, length) == -1)
+    {
+        Log::get() << Log::WARNING << "ShmRingWriter::" << __FUNCTION__ << " - Unable to resize shared memory segment " << slot.name << ": " << string(strerror(errno)) << Log::endl;
+        close(fd);
+        shm_unlink(slot.name.c_str());
+        return false;
+    }
+
+    auto data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        Log::get() << Log::WARNING << "ShmRingWriter::" << __FUNCTION__ << " - Unable to map shared memory segment " << slot.name << ": " << string(strerror(errno)) << Log::endl;
+        shm_unlink(slot.name.c_str());
+        return false;
+    }
+
+    slot.mapping = make_shared<ShmRingMapping>();
+    slot.mapping->data = static_cast<uint8_t*>(data);
+    slot.mapping->length = length;
+    auto header = reinterpret_cast<ShmRingSlotHeader*>(slot.mapping->data);
+    header->generation.store(0);
+    header->readers.store(0);
+    header->pending.store(0);
+
+    _slots.push_back(slot);
+    return true;
+}
+
+/*************/
+bool ShmRingWriter::growSlot(Slot& slot, size_t capacity)
+{
+    auto fd = shm_open(slot.name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+        return false;
+
+    // Segments only ever grow, as shrinking them would invalidate the mappings of the readers
+    auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto length = ((sizeof(ShmRingSlotHeader) + capacity + pageSize - 1) / pageSize) * pageSize;
+    if (ftruncate(fd, length) == -1)
+    {
+        close(fd);
+        return false;
+    }
+
+    auto data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    // The previous mapping is released once not used anymore
+    auto mapping = make_shared<ShmRingMapping>();
+    mapping->data = static_cast<uint8_t*>(data);
+    mapping->length = length;
+    slot.mapping = mapping;
+    return true;
+}
+
+/*************/
+shared_ptr<SerializedObject> ShmRingReader::read(const ShmRingDescriptor& descriptor)
+{
+    auto name = string(descriptor.segmentName, strnlen(descriptor.segmentName, ShmRingDescriptor::segmentNameLength));
+    auto mapping = getMapping(name, sizeof(ShmRingSlotHeader) + descriptor.capacity);
+    if (!mapping)
+        return {};
+
+    auto header = reinterpret_cast<ShmRingSlotHeader*>(mapping->data);
+    header->readers.fetch_add(1);
+    if (header->generation.load() != descriptor.generation)
+    {
+        // The slot has been reused since the descriptor was sent, which only happens if it was not read in time
+        header->readers.fetch_sub(1);
+        return {};
+    }
+
+    // Acknowledge the descriptor, the slot being then only held through the readers count
+    auto pending = header->pending.load();
+    while (pending != 0 && !header->pending.compare_exchange_weak(pending, pending - 1))
+        ;
+
+    auto data = ResizableArray<uint8_t>(mapping->data + sizeof(ShmRingSlotHeader), descriptor.size, [mapping](uint8_t*) {
+        reinterpret_cast<ShmRingSlotHeader*>(mapping->data)->readers.fetch_sub(1);
+    });
+    return make_shared<SerializedObject>(std::move(data));
+}
+
+/*************/
+shared_ptr<ShmRingMapping> ShmRingReader::getMapping(const string& name, size_t capacity)
+{
+    auto mappingIt = _mappings.find(name);
+    if (mappingIt != _mappings.end() && mappingIt->second->length >= capacity)
+        return mappingIt->second;
+
+    // Either the segment is not mapped yet, or it has grown since
+    auto fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+    {
+        Log::get() << Log::WARNING << "ShmRingReader::" << __FUNCTION__ << " - Unable to open shared memory segment " << name << ": " << string(strerror(errno)) << Log::endl;
+        return {};
+    }
+
+    struct stat segmentStat;
+    if (fstat(fd, &segmentStat) == -1 || static_cast<size_t>(segmentStat.st_size) < capacity)
+    {
+        close(fd);
+        return {};
+    }
+
+    auto length = static_cast<size_t>(segmentStat.st_size);
+    auto data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        Log::get() << Log::WARNING << "ShmRingReader::" << __FUNCTION__ << " - Unable to map shared memory segment " << name << ": " << string(strerror(errno)) << Log::endl;
+        return {};
+    }
+
+    auto mapping = make_shared<ShmRingMapping>();
+    mapping->data = static_cast<uint8_t*>(data);
+    mapping->length = length;
+    _mappings[name] = mapping;
+    return mapping;
+}
+
+} // namespace Splash
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @shm_ring.h
+ * Ring of POSIX shared memory slots, used by the Link to transmit buffers without copying them through sockets
+ *
+ * Each slot is a shared memory segment starting with a small header holding a generation counter, a
+ * readers counter and the number of readers which still have to read it. The writer only reuses a slot once
+ * all readers it was sent to read it and released it, and readers check the generation of the slot against
+ * the one of the descriptor they received to detect outdated frames.
+ */
+
+#ifndef SPLASH_SHM_RING_H
+#define SPLASH_SHM_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "./core/serialized_object.h"
+
+namespace Splash
+{
+
+/*************/
+//! Descriptor of a buffer stored in a shared memory slot, sent to the peers instead of the buffer itself
+struct ShmRingDescriptor
+{
+    static const size_t segmentNameLength = 128;
+
+    uint64_t generation{0};                //!< Generation of the slot when the buffer was written
+    uint64_t size{0};                      //!< Size of the buffer
+    uint64_t capacity{0};                  //!< Capacity of the slot
+    char segmentName[segmentNameLength]{}; //!< Name of the shared memory segment
+};
+
+/*************/
+//! Header stored at the beginning of each shared memory slot
+struct alignas(64) ShmRingSlotHeader
+{
+    std::atomic<uint64_t> generation; //!< Odd while the slot is being written to
+    std::atomic<uint32_t> readers;    //!< Number of readers currently holding the slot
+    std::atomic<uint32_t> pending;    //!< Number of readers the slot has been sent to, and which did not read it yet
+};
+
+static_assert(sizeof(ShmRingSlotHeader) == 64, "ShmRingSlotHeader should fit in a cache line");
+
+/*************/
+//! Mapping of a shared memory segment, unmapped once not used anymore
+struct ShmRingMapping
+{
+    ~ShmRingMapping();
+    uint8_t* data{nullptr};
+    size_t length{0};
+};
+
+/*************/
+class ShmRingWriter
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param name Base name for the shared memory segments, has to start with a '/'
+     * \param maxSlotCount Maximum number of slots in the ring
+     */
+    ShmRingWriter(const std::string& name, uint32_t maxSlotCount = 32);
+
+    /**
+     * \brief Destructor, unlinks all segments
+     */
+    ~ShmRingWriter();
+
+    /**
+     * \brief Get a free slot to serialize a buffer into, so that it is written only once. The slot is held until the
+     * array is destroyed, and is sent to the readers with commit().
+     * \param size Buffer size
+     * \return Return an array mapping the slot, or an empty array if no slot is available
+     */
+    ResizableArray<uint8_t> acquire(size_t size);
+
+    /**
+     * \brief Publish a buffer serialized into a slot acquired from this ring
+     * \param buffer Buffer to publish
+     * \param readerCount Number of readers the descriptor is sent to. The slot is not reused before they all read it.
+     * \param descriptor Descriptor to send to the readers
+     * \return Return false if the buffer is not held in a slot of this ring
+     */
+    bool commit(const std::shared_ptr<SerializedObject>& buffer, uint32_t readerCount, ShmRingDescriptor& descriptor);
+
+    /**
+     * \brief Copy the given buffer in the first free slot, its payload being appended to its data
+     * \param buffer Buffer to write
+     * \param readerCount Number of readers the descriptor is sent to. The slot is not reused before they all read it.
+     * \param descriptor Descriptor to send to the readers
+     * \return Return false if no slot is available, in which case the buffer has to be sent by other means
+     */
+    bool write(const std::shared_ptr<SerializedObject>& buffer, uint32_t readerCount, ShmRingDescriptor& descriptor);
+
+    /**
+     * \brief Get the number of slots currently allocated
+     * \return Return the slot count
+     */
+    size_t getSlotCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _slots.size();
+    }
+
+  private:
+    struct Slot
+    {
+        std::string name{""};
+        std::shared_ptr<ShmRingMapping> mapping{};
+        std::shared_ptr<std::atomic_bool> held{std::make_shared<std::atomic_bool>(false)}; //!< True while acquired by the writer side
+        uint64_t generation{0};                                                          //!< Generation of the last buffer committed
+        std::chrono::steady_clock::time_point sendTime{};                                //!< Time the last buffer was committed
+    };
+
+    //! Readers which did not read a slot after this delay are considered gone, e.g. if they dropped the descriptor
+    static constexpr std::chrono::seconds _pendingTimeout{1};
+
+    std::string _name{""};
+    uint32_t _maxSlotCount{32};
+    mutable std::mutex _mutex{};
+    std::vector<Slot> _slots{};
+    uint32_t _nextSlot{0};
+
+    /**
+     * \brief Try to acquire the given slot
+     * \param index Slot index
+     * \param size Buffer size
+     * \return Return an array mapping the slot, or an empty array if it is not free
+     */
+    ResizableArray<uint8_t> acquireSlot(uint32_t index, size_t size);
+
+    /**
+     * \brief Create a new slot, at the end of the ring
+     * \param capacity Slot capacity
+     * \return Return true if the slot has been created
+     */
+    bool createSlot(size_t capacity);
+
+    /**
+     * \brief Grow a slot so that it can hold the given capacity. It must not be held by any reader.
+     * \param slot Slot to grow
+     * \param capacity New capacity
+     * \return Return true if all went well
+     */
+    bool growSlot(Slot& slot, size_t capacity);
+};
+
+/*************/
+class ShmRingReader
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    ShmRingReader() = default;
+
+    /**
+     * \brief Get the buffer described by the descriptor. The returned object holds the slot until destroyed, and its data is not copied.
+     * \param descriptor Buffer descriptor
+     * \return Return the buffer, or an empty shared_ptr if it is not available anymore
+     */
+    std::shared_ptr<SerializedObject> read(const ShmRingDescriptor& descriptor);
+
+  private:
+    std::map<std::string, std::shared_ptr<ShmRingMapping>> _mappings{};
+
+    /**
+     * \brief Get the mapping for the given segment, mapping it if needed
+     * \param name Segment name
+     * \param capacity Minimum capacity of the mapping
+     * \return Return the mapping, or an empty shared_ptr if it failed
+     */
+    std::shared_ptr<ShmRingMapping> getMapping(const std::string& name, size_t capacity);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_SHM_RING_H
@@ -0,0 +1,135 @@
+#include "./core/thread_pool.h"
+
+#include <algorithm>
+
+#include "./utils/osutils.h"
+#include "./utils/timer.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+namespace
+{
+//! Pool and index of the worker running on the current thread, if any
+thread_local ThreadPool* currentPool{nullptr};
+thread_local size_t currentWorker{0};
+} // namespace
+
+/*************/
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+    if (workerCount == 0)
+        workerCount = static_cast<unsigned int>(max(Utils::getCoreCount(), 1));
+
+    for (unsigned int i = 0; i < workerCount; ++i)
+        _workers.push_back(make_unique<Worker>());
+    for (size_t i = 0; i < _workers.size(); ++i)
+        _workers[i]->thread = thread([this, i]() { run(i); });
+}
+
+/*************/
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(_sleepMutex);
+        _running = false;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+        if (worker->thread.joinable())
+            worker->thread.join();
+}
+
+/*************/
+void ThreadPool::push(function<void()>&& task)
+{
+    auto index = currentPool == this ? currentWorker : _nextWorker.fetch_add(1, memory_order_relaxed) % _workers.size();
+
+    _pendingTasks.fetch_add(1, memory_order_acq_rel);
+    {
+        lock_guard<mutex> lock(_workers[index]->mutex);
+        _workers[index]->tasks.push_back(std::move(task));
+    }
+
+    {
+        lock_guard<mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+/*************/
+bool ThreadPool::pop(size_t index, function<void()>& task)
+{
+    // Own tasks are run from the most recent one, as its data is more likely to still be in cache
+    {
+        auto& worker = *_workers[index];
+        lock_guard<mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            _pendingTasks.fetch_sub(1, memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // Other workers tasks are stolen from the oldest one
+    for (size_t i = 1; i < _workers.size(); ++i)
+    {
+        auto& worker = *_workers[(index + i) % _workers.size()];
+        lock_guard<mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            _pendingTasks.fetch_sub(1, memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*************/
+void ThreadPool::run(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    const auto durationName = "threadpool_worker_" + to_string(index);
+    const auto period = chrono::duration_cast<chrono::microseconds>(_utilisationPeriod).count();
+    auto periodStart = Timer::getTime();
+    int64_t busyTime = 0;
+
+    while (true)
+    {
+        function<void()> task;
+        if (pop(index, task))
+        {
+            auto start = Timer::getTime();
+            task();
+            busyTime += Timer::getTime() - start;
+        }
+        else
+        {
+            unique_lock<mutex> lock(_sleepMutex);
+            if (!_running && _pendingTasks.load(memory_order_acquire) == 0)
+                break;
+            _sleepCondition.wait_for(lock, _utilisationPeriod, [&]() { return !_running || _pendingTasks.load(memory_order_acquire) != 0; });
+        }
+
+        // The utilisation is given as the busy time per second, in us
+        auto now = Timer::getTime();
+        if (now - periodStart >= period)
+        {
+            Timer::get().setDuration(durationName, busyTime * 1000000 / (now - periodStart));
+            periodStart = now;
+            busyTime = 0;
+        }
+    }
+}
+
+} // namespace Splash
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @thread_pool.h
+ * Pool of persistent worker threads, each one stealing tasks from the others when idle
+ */
+
+#ifndef SPLASH_THREAD_POOL_H
+#define SPLASH_THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Splash
+{
+
+/*************/
+class ThreadPool
+{
+  public:
+    /**
+     * \brief Get the singleton, with one worker per core
+     * \return Return the ThreadPool singleton
+     */
+    static ThreadPool& get()
+    {
+        static auto instance = new ThreadPool;
+        return *instance;
+    }
+
+    /**
+     * \brief Constructor
+     * \param workerCount Number of workers, defaults to the number of cores if 0
+     */
+    explicit ThreadPool(unsigned int workerCount = 0);
+
+    /**
+     * \brief Destructor, runs all the remaining tasks before returning
+     */
+    ~ThreadPool();
+
+    /**
+     * \brief Add a task to the pool. Tasks added from a worker go to its own queue.
+     * Note that waiting for a task from within another task can block all the workers.
+     * \param task Task to run
+     * \return Return a future to wait for the task
+     */
+    template <typename T>
+    std::future<void> enqueue(T&& task)
+    {
+        auto packagedTask = std::make_shared<std::packaged_task<void()>>(std::forward<T>(task));
+        auto future = packagedTask->get_future();
+        push([packagedTask]() { (*packagedTask)(); });
+        return future;
+    }
+
+    /**
+     * \brief Get the number of workers
+     * \return Return the number of workers
+     */
+    size_t getWorkerCount() const { return _workers.size(); }
+
+  private:
+    static constexpr std::chrono::milliseconds _utilisationPeriod{1000}; //!< Period over which the workers utilisation is measured
+
+    struct Worker
+    {
+        std::thread thread{};
+        std::mutex mutex{};
+        std::deque<std::function<void()>> tasks{};
+    };
+
+    std::vector<std::unique_ptr<Worker>> _workers{};
+    std::atomic<size_t> _nextWorker{0};
+    std::atomic<int64_t> _pendingTasks{0};
+    std::mutex _sleepMutex{};
+    std::condition_variable _sleepCondition{};
+    bool _running{true}; //!< Protected by _sleepMutex
+
+    ThreadPool(const ThreadPool&) = delete;
+    const ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \brief Add a task to the queue of a worker, and wake a worker up
+     * \param task Task to add
+     */
+    void push(std::function<void()>&& task);
+
+    /**
+     * \brief Get the next task for the given worker, stealing from the other workers if its own queue is empty
+     * \param index Worker index
+     * \param task Task to run
+     * \return Return true if a task was found
+     */
+    bool pop(size_t index, std::function<void()>& task);
+
+    /**
+     * \brief Worker loop, which also publishes the worker utilisation to the Timer
+     * \param index Worker index
+     */
+    void run(size_t index);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_THREAD_POOL_H
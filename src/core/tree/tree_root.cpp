@@ -1,6 +1,9 @@
 #include "./core/tree/tree_root.h"
 
+#include <algorithm>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_set>
 
 #include "./utils/log.h"
 
@@ -19,6 +22,13 @@ RootHandle::RootHandle(Root* root)
 {
 }
 
+/*************/
+LeafHandle::LeafHandle(const string& path)
+    : _path(path)
+    , _parts(Root::processPath(path))
+{
+}
+
 /*************/
 Root::Root()
     : _rootBranch(new Branch(""))
@@ -43,11 +53,13 @@ bool Root::addBranchAt(const string& path, unique_ptr<Branch>&& branch, bool sil
     if (!holdingBranch->addBranch(move(branch)))
         return false;
 
+    ++_generation;
+
     if (!silent)
     {
         auto seeds = generateSeedsForBranch(getBranchAt(branchPath));
         lock_guard<recursive_mutex> lock(_updatesMutex);
-        _updates.merge(seeds, [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+        mergeSeeds(_updates, std::move(seeds));
     }
 
     return true;
@@ -65,11 +77,13 @@ bool Root::addLeafAt(const string& path, unique_ptr<Leaf>&& leaf, bool silent)
     if (!holdingBranch->addLeaf(move(leaf)))
         return false;
 
+    ++_generation;
+
     if (!silent)
     {
         auto seeds = generateSeedsForLeaf(getLeafAt(leafPath));
         lock_guard<recursive_mutex> lock(_updatesMutex);
-        _updates.merge(seeds, [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+        mergeSeeds(_updates, std::move(seeds));
     }
 
     return true;
@@ -126,16 +140,19 @@ bool Root::removeCallbackFromLeafAt(const string& path, int id)
 /*************/
 void Root::addSeedToQueue(Tree::Task taskType, Values args, chrono::system_clock::time_point timestamp)
 {
-    auto seed = make_tuple(taskType, args, timestamp, UUID(false));
+    auto seed = make_tuple(taskType, std::move(args), timestamp, UUID(false));
     lock_guard<mutex> lock(_taskMutex);
-    _seedQueue.push_back(seed);
+    _seedQueue.emplace_back(std::move(seed));
 }
 
 /*************/
-void Root::addSeedsToQueue(list<Seed> seeds)
+void Root::addSeedsToQueue(SeedList seeds)
 {
     lock_guard<mutex> lock(_taskMutex);
-    _seedQueue.merge(seeds, [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+    if (_seedQueue.empty())
+        _seedQueue = std::move(seeds);
+    else
+        _seedQueue.insert(_seedQueue.end(), make_move_iterator(seeds.begin()), make_move_iterator(seeds.end()));
 }
 
 /*************/
@@ -149,6 +166,7 @@ void Root::clearSeedList()
 void Root::cutdown()
 {
     _rootBranch = make_unique<Tree::Branch>("");
+    ++_generation;
     _seedQueue.clear();
     _updates.clear();
     _branchCallbacksToRegister.clear();
@@ -194,6 +212,8 @@ bool Root::createBranchAt(const string& path, bool silent)
         return false;
     }
 
+    ++_generation;
+
     if (!silent)
     {
         lock_guard<recursive_mutex> lock(_updatesMutex);
@@ -243,6 +263,8 @@ bool Root::createLeafAt(const std::string& path, Values value, bool silent)
         return false;
     }
 
+    ++_generation;
+
     if (!silent)
     {
         lock_guard<recursive_mutex> lock(_updatesMutex);
@@ -279,6 +301,7 @@ unique_ptr<Branch> Root::cutBranchAt(const string& path, bool silent)
         _updates.emplace_back(make_tuple(Task::RemoveBranch, Values({path}), chrono::system_clock::now(), _uuid));
     }
 
+    ++_generation;
     return holdingBranch->cutBranch(branchName);
 }
 
@@ -308,6 +331,7 @@ unique_ptr<Leaf> Root::cutLeafAt(const string& path, bool silent)
         _updates.emplace_back(make_tuple(Task::RemoveLeaf, Values({path}), chrono::system_clock::now(), _uuid));
     }
 
+    ++_generation;
     return holdingBranch->cutLeaf(leafName);
 }
 
@@ -397,6 +421,18 @@ bool Root::getValueForLeafAt(const string& path, Value& value) const
     return true;
 }
 
+/*************/
+bool Root::getValueForLeaf(const LeafHandle& handle, Value& value) const
+{
+    lock_guard<recursive_mutex> lockTree(_treeMutex);
+    auto leaf = getLeaf(handle);
+    if (!leaf)
+        return false;
+
+    value = leaf->get();
+    return true;
+}
+
 /*************/
 bool Root::hasBranchAt(const string& path) const
 {
@@ -444,6 +480,13 @@ bool Root::hasLeafAt(const string& path) const
         return false;
 }
 
+/*************/
+bool Root::hasLeaf(const LeafHandle& handle) const
+{
+    lock_guard<recursive_mutex> lockTree(_treeMutex);
+    return getLeaf(handle) != nullptr;
+}
+
 /*************/
 bool Root::setValueForLeafAt(const string& path, const Value& value, int64_t timestamp, bool silent)
 {
@@ -481,14 +524,101 @@ bool Root::setValueForLeafAt(const string& path, const Value& value, chrono::sys
 }
 
 /*************/
-list<Seed> Root::getUpdateSeedList()
+bool Root::setValueForLeaf(const LeafHandle& handle, const Value& value, chrono::system_clock::time_point timestamp, bool silent)
 {
-    list<Seed> updates;
-    lock_guard<recursive_mutex> lock(_updatesMutex);
-    swap(updates, _updates);
+    lock_guard<recursive_mutex> lockTree(_treeMutex);
+    auto leaf = getLeaf(handle);
+    if (!leaf)
+        return false;
+
+    if (value == leaf->get())
+        return true;
+
+    if (!leaf->set(value, timestamp))
+        return false;
+
+    if (!silent)
+    {
+        lock_guard<recursive_mutex> lock(_updatesMutex);
+        auto seed = make_tuple(Task::SetLeaf, Values({handle._path, value}), timestamp, _uuid);
+        _updates.emplace_back(move(seed));
+    }
+
+    return true;
+}
+
+/*************/
+SeedList Root::getUpdateSeedList()
+{
+    SeedList updates;
+    {
+        lock_guard<recursive_mutex> lock(_updatesMutex);
+        swap(updates, _updates);
+    }
+
+    _generatedSeedCount += updates.size();
+    coalesceSeeds(updates);
+    _coalescedSeedCount += updates.size();
     return updates;
 }
 
+/*************/
+void Root::coalesceSeeds(SeedList& seeds)
+{
+    // Walk the seeds backward, so that the last SetLeaf seed for each leaf is the one kept.
+    // The paths point into the seeds, which are not moved until the compaction.
+    unordered_set<string_view> setLeafPaths;
+    vector<bool> keep(seeds.size(), true);
+    bool hasDuplicates = false;
+    for (size_t index = seeds.size(); index-- > 0;)
+    {
+        const auto& seed = seeds[index];
+        if (std::get<0>(seed) != Task::SetLeaf)
+        {
+            setLeafPaths.clear();
+            continue;
+        }
+
+        const auto& args = std::get<1>(seed).asRef<Values>();
+        if (args.empty() || args[0].getType() != Value::Type::string)
+            continue;
+
+        if (!setLeafPaths.insert(string_view(args[0].asRef<string>())).second)
+        {
+            keep[index] = false;
+            hasDuplicates = true;
+        }
+    }
+
+    if (!hasDuplicates)
+        return;
+
+    size_t kept = 0;
+    for (size_t index = 0; index < seeds.size(); ++index)
+    {
+        if (!keep[index])
+            continue;
+        if (kept != index)
+            seeds[kept] = std::move(seeds[index]);
+        ++kept;
+    }
+    seeds.erase(seeds.begin() + kept, seeds.end());
+}
+
+/*************/
+void Root::mergeSeeds(SeedList& seeds, SeedList&& other)
+{
+    if (seeds.empty())
+    {
+        seeds = std::move(other);
+        return;
+    }
+
+    auto middle = seeds.size();
+    seeds.insert(seeds.end(), make_move_iterator(other.begin()), make_move_iterator(other.end()));
+    inplace_merge(seeds.begin(), seeds.begin() + middle, seeds.end(), [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+}
+
 /*************/
 string Root::print() const
 {
@@ -502,17 +632,18 @@ string Root::print() const
 bool Root::processQueue(bool propagate)
 {
     _taskMutex.lock();
-    list<Seed> tasks;
+    SeedList tasks;
     swap(tasks, _seedQueue);
     _taskMutex.unlock();
 
-    tasks.sort([](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+    stable_sort(tasks.begin(), tasks.end(), [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
 
+    // Apply all the seeds in a single pass, holding the tree lock
     lock_guard<recursive_mutex> lockTree(_treeMutex);
     for (const auto& seed : tasks)
     {
         auto& task = std::get<0>(seed);
-        auto args = std::get<1>(seed).as<Values>();
+        const auto& args = std::get<1>(seed).asRef<Values>();
         auto& timestamp = std::get<2>(seed);
         auto& sourceTreeUUID = std::get<3>(seed);
 
@@ -657,7 +788,10 @@ bool Root::processQueue(bool propagate)
     }
 
     if (propagate)
-        _updates.merge(tasks, [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+    {
+        lock_guard<recursive_mutex> lock(_updatesMutex);
+        mergeSeeds(_updates, std::move(tasks));
+    }
 
     registerPendingCallbacks();
     return true;
@@ -697,6 +831,8 @@ bool Root::removeBranchAt(const string& path, bool silent)
         return false;
     }
 
+    ++_generation;
+
     if (!silent)
     {
         lock_guard<recursive_mutex> lock(_updatesMutex);
@@ -740,6 +876,8 @@ bool Root::removeLeafAt(const string& path, bool silent)
         return false;
     }
 
+    ++_generation;
+
     if (!silent)
     {
         lock_guard<recursive_mutex> lock(_updatesMutex);
@@ -783,6 +921,8 @@ bool Root::renameBranchAt(const string& path, const string& name, bool silent)
         return false;
     }
 
+    ++_generation;
+
     if (!silent)
     {
         lock_guard<recursive_mutex> lock(_updatesMutex);
@@ -826,6 +966,8 @@ bool Root::renameLeafAt(const string& path, const string& name, bool silent)
         return false;
     }
 
+    ++_generation;
+
     if (!silent)
     {
         lock_guard<recursive_mutex> lock(_updatesMutex);
@@ -837,9 +979,9 @@ bool Root::renameLeafAt(const string& path, const string& name, bool silent)
 }
 
 /*************/
-list<Seed> Root::generateSeedsForBranch(Branch* branch)
+SeedList Root::generateSeedsForBranch(Branch* branch)
 {
-    list<Seed> seeds;
+    SeedList seeds;
     if (!branch)
         return seeds;
 
@@ -848,22 +990,22 @@ list<Seed> Root::generateSeedsForBranch(Branch* branch)
     for (const auto& branchName : branch->getBranchList())
     {
         auto childBranch = getBranchAt(branch->getPath() + branchName);
-        seeds.merge(generateSeedsForBranch(childBranch), [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+        mergeSeeds(seeds, generateSeedsForBranch(childBranch));
     }
 
     for (const auto& leafName : branch->getLeafList())
     {
         auto leaf = getLeafAt(branch->getPath() + leafName);
-        seeds.merge(generateSeedsForLeaf(leaf), [](const auto& a, const auto& b) { return std::get<2>(a) < std::get<2>(b); });
+        mergeSeeds(seeds, generateSeedsForLeaf(leaf));
     }
 
     return seeds;
 }
 
 /*************/
-list<Seed> Root::generateSeedsForLeaf(Leaf* leaf)
+SeedList Root::generateSeedsForLeaf(Leaf* leaf)
 {
-    list<Seed> seeds;
+    SeedList seeds;
     if (!leaf)
         return seeds;
 
@@ -874,7 +1016,7 @@ list<Seed> Root::generateSeedsForLeaf(Leaf* leaf)
 }
 
 /*************/
-list<Seed> Root::getSeedsForPath(const string& path)
+SeedList Root::getSeedsForPath(const string& path)
 {
     lock_guard<recursive_mutex> lockTree(_treeMutex);
 
@@ -965,6 +1107,24 @@ Leaf* Root::getLeafAt(const vector<string>& path) const
     return leaf;
 }
 
+/*************/
+Leaf* Root::getLeaf(const LeafHandle& handle) const
+{
+    if (handle._parts.empty())
+        return nullptr;
+
+    // The cached leaf is only valid if nothing has been added, removed or renamed since it was resolved
+    auto generation = _generation.load();
+    if (handle._root != this || handle._generation != generation)
+    {
+        handle._leaf = getLeafAt(handle._parts);
+        handle._root = this;
+        handle._generation = generation;
+    }
+
+    return handle._leaf;
+}
+
 /*************/
 vector<string> Root::processPath(const string& path)
 {
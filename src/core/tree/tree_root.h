@@ -25,6 +25,7 @@
 #ifndef SPLASH_TREE_ROOT_H
 #define SPLASH_TREE_ROOT_H
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <list>
@@ -34,6 +35,7 @@
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "./config.h"
 
@@ -73,6 +75,11 @@ using CallbackID = int;
  */
 using Seed = std::tuple<Task, Value, std::chrono::system_clock::time_point, UUID>;
 
+/**
+ * Seeds are stored contiguously, as they are created, sorted and sent in batches
+ */
+using SeedList = std::vector<Seed>;
+
 class Root;
 
 /**
@@ -89,6 +96,44 @@ class RootHandle
     std::unique_lock<std::recursive_mutex> _rootLock;
 };
 
+/**
+ * Leaf handle, holding a path already split in its parts and the leaf it resolved to.
+ * The leaf is resolved again whenever the structure of the tree changed since the last access,
+ * so a handle can be kept and reused as long as needed
+ */
+class LeafHandle
+{
+    friend Root;
+
+  public:
+    LeafHandle() = default;
+
+    /**
+     * Constructor
+     * \param path Path to the leaf
+     */
+    explicit LeafHandle(const std::string& path);
+
+    /**
+     * Get the path to the leaf
+     * \return Return the path
+     */
+    const std::string& getPath() const { return _path; }
+
+    /**
+     * Get whether the handle points to a valid path. It does not mean that the leaf exists.
+     * \return Return true if the path is valid
+     */
+    bool isValid() const { return !_parts.empty(); }
+
+  private:
+    std::string _path{};
+    std::vector<std::string> _parts{};
+    mutable const Root* _root{nullptr}; //!< Root the leaf has been resolved from
+    mutable Leaf* _leaf{nullptr};
+    mutable uint64_t _generation{0};    //!< Structure generation of the root when the leaf has been resolved
+};
+
 /**
  * Tree::Root class, which holds the main branch
  * All commands should be applied to this class directly, otherwise
@@ -97,6 +142,7 @@ class RootHandle
 class Root
 {
     friend RootHandle;
+    friend LeafHandle;
 
   public:
     /**
@@ -158,10 +204,10 @@ class Root
     void addSeedToQueue(Tree::Task taskType, Values args, std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now());
 
     /**
-     * Add a list of seeds to the queue
+     * Add a list of seeds to the queue, in a single batch
      * \param seeds Tasks and arguments list to add to the queue
      */
-    void addSeedsToQueue(std::list<Seed> seeds);
+    void addSeedsToQueue(SeedList seeds);
 
     /**
      * Clear the seed list
@@ -211,7 +257,7 @@ class Root
      * \param path Path to generate the seed for
      * \return Return the seeds list
      */
-    std::list<Seed> getSeedsForPath(const std::string& path);
+    SeedList getSeedsForPath(const std::string& path);
 
     /**
      * Get whether an error is set
@@ -233,6 +279,13 @@ class Root
      */
     bool hasLeafAt(const std::string& path) const;
 
+    /**
+     * Return whether the leaf pointed to by the given handle exists
+     * \param handle Handle to the leaf
+     * \return Return true if the leaf exists
+     */
+    bool hasLeaf(const LeafHandle& handle) const;
+
     /**
      * Get the oldest error, and resets the error flag
      * \param error Error string
@@ -276,6 +329,14 @@ class Root
      */
     bool getValueForLeafAt(const std::string& path, Value& value) const;
 
+    /**
+     * Get the value held by the leaf pointed to by the given handle
+     * \param handle Handle to the leaf
+     * \param value The value of the leaf, or an empty value
+     * \return Return true if the leaf was found
+     */
+    bool getValueForLeaf(const LeafHandle& handle, Value& value) const;
+
     /**
      * Set the value for the leaf at the given path
      * \param path Path to the leaf
@@ -296,12 +357,33 @@ class Root
         return setValueForLeafAt(path, Value(value), timestamp, silent);
     }
 
+    /**
+     * Set the value for the leaf pointed to by the given handle, avoiding to parse the path again
+     * \param handle Handle to the leaf
+     * \param value Leaf value
+     * \param timestamp Timestamp
+     * \param silent do not add this action to the update list
+     * \return Return true if all went well
+     */
+    bool setValueForLeaf(const LeafHandle& handle, const Value& value, std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now(), bool silent = false);
+    bool setValueForLeaf(const LeafHandle& handle, const Values& value, std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now(), bool silent = false)
+    {
+        return setValueForLeaf(handle, Value(value), timestamp, silent);
+    }
+
+    /**
+     * Get the seed counts, before and after coalescing, since the creation of the tree
+     * \return Return a pair holding the generated and the returned seed counts
+     */
+    std::pair<uint64_t, uint64_t> getSeedCounts() const { return {_generatedSeedCount, _coalescedSeedCount}; }
+
     /**
      * Get the seeds generated while modifying the tree
+     * Successive SetLeaf seeds for the same leaf are coalesced, only the last value being kept.
      * This clears the updates queue.
      * \return Return the list of updates
      */
-    std::list<Seed> getUpdateSeedList();
+    SeedList getUpdateSeedList();
 
     /**
      * Process the seeds queue to update the tree. Also register pending leaf callbacks
@@ -381,8 +463,11 @@ class Root
     std::unique_ptr<Branch> _rootBranch{nullptr};
     mutable std::mutex _taskMutex{};
     mutable std::recursive_mutex _updatesMutex{};
-    std::list<Seed> _seedQueue{}; //!< Queue of seeds to be applied to the tree by calling processQueue()
-    std::list<Seed> _updates{};   //!< Queue of seeds generated by operations done onto the tree
+    SeedList _seedQueue{};                        //!< Queue of seeds to be applied to the tree by calling processQueue()
+    SeedList _updates{};                          //!< Queue of seeds generated by operations done onto the tree
+    std::atomic<uint64_t> _generation{1};         //!< Incremented each time the structure of the tree changes, invalidating the leaf handles
+    std::atomic<uint64_t> _generatedSeedCount{0}; //!< Number of seeds retrieved through getUpdateSeedList, before coalescing
+    std::atomic<uint64_t> _coalescedSeedCount{0}; //!< Number of seeds returned by getUpdateSeedList, after coalescing
 
     std::list<std::tuple<std::string, Branch::Task, Branch::UpdateCallback>> _branchCallbacksToRegister{};
     std::list<std::pair<std::string, Leaf::UpdateCallback>> _leafCallbacksToRegister{};
@@ -395,14 +480,28 @@ class Root
      * \param branch Branch to recreate
      * \param Return the seed list
      */
-    std::list<Seed> generateSeedsForBranch(Branch* branch);
+    SeedList generateSeedsForBranch(Branch* branch);
 
     /**
      * Generate a seed list to recreate the given leaf
      * \param branch leaf to recreate
      * \param Return the seed list
      */
-    std::list<Seed> generateSeedsForLeaf(Leaf* leaf);
+    SeedList generateSeedsForLeaf(Leaf* leaf);
+
+    /**
+     * Drop the SetLeaf seeds superseded by a later SetLeaf seed on the same leaf
+     * A seed is only dropped if no structural change happened in between, as it could have moved the leaf.
+     * \param seeds Seeds to coalesce, sorted by timestamp
+     */
+    static void coalesceSeeds(SeedList& seeds);
+
+    /**
+     * Merge a list of seeds into another one, keeping them sorted by timestamp
+     * \param seeds Seeds to merge into
+     * \param other Seeds to merge
+     */
+    static void mergeSeeds(SeedList& seeds, SeedList&& other);
 
     /**
      * Get a pointer to the branch at the given path
@@ -432,6 +531,14 @@ class Root
      */
     Leaf* getLeafAt(const std::vector<std::string>& path) const;
 
+    /**
+     * Get a pointer to the leaf pointed to by the given handle, resolving it again if needed
+     * Must be called with the tree locked
+     * \param handle Handle to the leaf
+     * \return Return the leaf, or nullptr
+     */
+    Leaf* getLeaf(const LeafHandle& handle) const;
+
     /**
      * Extract the multiple parts of the given path
      * \param path Path
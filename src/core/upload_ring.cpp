@@ -0,0 +1,161 @@
+#include "./core/upload_ring.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace Splash
+{
+
+namespace
+{
+//! Rings published by the textures of this process, by image name
+mutex registryMutex;
+unordered_map<string, weak_ptr<UploadRing>> registry;
+//! Rings closed while some of their slots may still be held
+vector<weak_ptr<UploadRing>> closedRings;
+} // namespace
+
+/*************/
+shared_ptr<UploadRing> UploadRing::create(const vector<uint8_t*>& slots, size_t slotSize)
+{
+    auto ring = shared_ptr<UploadRing>(new UploadRing, [](UploadRing* ring) { delete ring; });
+    ring->_slotSize = slotSize;
+    for (auto pixels : slots)
+    {
+        auto slot = make_unique<Slot>();
+        slot->pixels = pixels;
+        ring->_slots.push_back(std::move(slot));
+    }
+    return ring;
+}
+
+/*************/
+void UploadRing::publish(const string& name, const shared_ptr<UploadRing>& ring)
+{
+    lock_guard<mutex> lock(registryMutex);
+    registry[name] = ring;
+}
+
+/*************/
+void UploadRing::withdraw(const string& name, const UploadRing* ring)
+{
+    lock_guard<mutex> lock(registryMutex);
+    auto ringIt = registry.find(name);
+    if (ringIt == registry.end())
+        return;
+
+    auto publishedRing = ringIt->second.lock();
+    if (!publishedRing || publishedRing.get() == ring)
+        registry.erase(ringIt);
+}
+
+/*************/
+shared_ptr<UploadRing> UploadRing::find(const string& name)
+{
+    lock_guard<mutex> lock(registryMutex);
+    auto ringIt = registry.find(name);
+    if (ringIt == registry.end())
+        return {};
+    return ringIt->second.lock();
+}
+
+/*************/
+bool UploadRing::isClosedSlot(const void* data)
+{
+    lock_guard<mutex> lock(registryMutex);
+    if (closedRings.empty())
+        return false;
+
+    closedRings.erase(remove_if(closedRings.begin(), closedRings.end(), [](const auto& ring) { return ring.expired(); }), closedRings.end());
+    for (const auto& closedRing : closedRings)
+    {
+        auto ring = closedRing.lock();
+        if (ring && ring->getSlotIndex(data) >= 0)
+            return true;
+    }
+    return false;
+}
+
+/*************/
+ResizableArray<uint8_t> UploadRing::acquire(size_t size)
+{
+    if (_closed || size == 0 || size > _slotSize)
+        return {};
+
+    // Slots are tried in turn, starting after the last one acquired
+    auto start = _nextSlot.load(memory_order_relaxed);
+    for (size_t i = 0; i < _slots.size(); ++i)
+    {
+        auto index = (start + i) % _slots.size();
+        auto& slot = *_slots[index];
+        if (slot.busy.load(memory_order_acquire))
+            continue;
+
+        auto expected = false;
+        if (!slot.acquired.compare_exchange_strong(expected, true, memory_order_acq_rel))
+            continue;
+
+        // The GPU may have started reading the slot between the two checks
+        if (slot.busy.load(memory_order_acquire))
+        {
+            slot.acquired.store(false, memory_order_release);
+            continue;
+        }
+
+        _nextSlot.store(index + 1, memory_order_relaxed);
+        auto ring = shared_from_this();
+        return ResizableArray<uint8_t>(slot.pixels, size, [ring, index](uint8_t*) { ring->_slots[index]->acquired.store(false, memory_order_release); });
+    }
+
+    return {};
+}
+
+/*************/
+int UploadRing::getSlotIndex(const void* data) const
+{
+    auto ptr = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < _slots.size(); ++i)
+        if (ptr >= _slots[i]->pixels && ptr < _slots[i]->pixels + _slotSize)
+            return static_cast<int>(i);
+    return -1;
+}
+
+/*************/
+void UploadRing::setSlotBusy(int index, bool busy)
+{
+    if (index < 0 || static_cast<size_t>(index) >= _slots.size())
+        return;
+    _slots[index]->busy.store(busy, memory_order_release);
+}
+
+/*************/
+bool UploadRing::isSlotBusy(int index) const
+{
+    if (index < 0 || static_cast<size_t>(index) >= _slots.size())
+        return false;
+    return _slots[index]->busy.load(memory_order_acquire);
+}
+
+/*************/
+void UploadRing::close()
+{
+    if (_closed.exchange(true))
+        return;
+
+    lock_guard<mutex> lock(registryMutex);
+    closedRings.push_back(weak_from_this());
+}
+
+/*************/
+bool UploadRing::isIdle() const
+{
+    for (const auto& slot : _slots)
+        if (slot->acquired.load(memory_order_acquire) || slot->busy.load(memory_order_acquire))
+            return false;
+    return true;
+}
+
+} // namespace Splash
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @upload_ring.h
+ * Ring of upload slots, i.e. memory mapped to the GPU by a texture, which image sources living in the
+ * same process can write their frames into. Rings are published under the name of the image feeding
+ * the texture, so that sources do not need to know about the textures.
+ */
+
+#ifndef SPLASH_UPLOAD_RING_H
+#define SPLASH_UPLOAD_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./core/resizable_array.h"
+
+namespace Splash
+{
+
+/*************/
+class UploadRing : public std::enable_shared_from_this<UploadRing>
+{
+  public:
+    /**
+     * \brief Create a ring over the given slots. The memory is owned by the caller, and must stay valid until the ring is idle.
+     * \param slots Pointers to the slots
+     * \param slotSize Size of each slot, in bytes
+     * \return Return the ring
+     */
+    static std::shared_ptr<UploadRing> create(const std::vector<uint8_t*>& slots, size_t slotSize);
+
+    /**
+     * \brief Publish a ring for the given image name, replacing any ring previously published for it
+     * \param name Image name
+     * \param ring Ring to publish
+     */
+    static void publish(const std::string& name, const std::shared_ptr<UploadRing>& ring);
+
+    /**
+     * \brief Withdraw the ring published for the given name, if it is the given one
+     * \param name Image name
+     * \param ring Ring to withdraw
+     */
+    static void withdraw(const std::string& name, const UploadRing* ring);
+
+    /**
+     * \brief Find the ring published for the given name
+     * \param name Image name
+     * \return Return the ring, or nullptr
+     */
+    static std::shared_ptr<UploadRing> find(const std::string& name);
+
+    /**
+     * \brief Check whether the given data is in a slot of a closed ring. Sources holding such data should copy it
+     * and release the slot, as the ring memory is released only once all its slots are.
+     * \param data Pointer to the data
+     * \return Return true if the data is in the slot of a closed ring
+     */
+    static bool isClosedSlot(const void* data);
+
+    /**
+     * \brief Get a free slot to write a frame into. The slot goes back to the ring once the array is destroyed.
+     * \param size Frame size, which must not exceed the slot size
+     * \return Return an array mapping the slot, or an empty array if no slot is available
+     */
+    ResizableArray<uint8_t> acquire(size_t size);
+
+    /**
+     * \brief Get the slot holding the given data
+     * \param data Pointer to the data
+     * \return Return the slot index, or -1 if the data is not in a slot of this ring
+     */
+    int getSlotIndex(const void* data) const;
+
+    /**
+     * \brief Mark a slot as being read by the GPU. A busy slot can not be acquired.
+     * \param index Slot index
+     * \param busy True if the GPU is reading the slot
+     */
+    void setSlotBusy(int index, bool busy);
+
+    /**
+     * \brief Check whether a slot is being read by the GPU
+     * \param index Slot index
+     * \return Return true if the slot is busy
+     */
+    bool isSlotBusy(int index) const;
+
+    /**
+     * \brief Get the slot count
+     * \return Return the slot count
+     */
+    size_t getSlotCount() const { return _slots.size(); }
+
+    /**
+     * \brief Get the size of the slots
+     * \return Return the slot size in bytes
+     */
+    size_t getSlotSize() const { return _slotSize; }
+
+    /**
+     * \brief Prevent any further acquisition, i.e. before the slots memory is released
+     */
+    void close();
+
+    /**
+     * \brief Check whether no slot is acquired nor busy
+     * \return Return true if the slots memory can be released
+     */
+    bool isIdle() const;
+
+  private:
+    struct Slot
+    {
+        uint8_t* pixels{nullptr};
+        std::atomic_bool acquired{false};
+        std::atomic_bool busy{false};
+    };
+
+    std::vector<std::unique_ptr<Slot>> _slots{};
+    size_t _slotSize{0};
+    std::atomic_bool _closed{false};
+    std::atomic<size_t> _nextSlot{0};
+
+    UploadRing() = default;
+    UploadRing(const UploadRing&) = delete;
+    const UploadRing& operator=(const UploadRing&) = delete;
+};
+
+} // namespace Splash
+
+#endif // SPLASH_UPLOAD_RING_H
@@ -28,7 +28,9 @@
 #include <cassert>
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <variant>
 
 #include "./core/resizable_array.h"
@@ -60,7 +62,7 @@ struct Value
 
     template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
+        : _name(internName(name))
         , _type(Type::integer)
         , _data(static_cast<int64_t>(v))
     {
@@ -68,7 +70,7 @@ struct Value
 
     template <class T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
+        : _name(internName(name))
         , _type(Type::real)
         , _data(static_cast<double>(v))
     {
@@ -76,15 +78,23 @@ struct Value
 
     template <class T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
+        : _name(internName(name))
         , _type(Type::string)
         , _data(v)
     {
     }
 
+    template <class T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
+    Value(T&& v, const std::string& name = "")
+        : _name(internName(name))
+        , _type(Type::string)
+        , _data(std::move(v))
+    {
+    }
+
     template <class T, typename std::enable_if<std::is_same<T, const char*>::value>::type* = nullptr>
     Value(T c, const std::string& name = "")
-        : _name(name)
+        : _name(internName(name))
         , _type(Type::string)
         , _data(c)
     {
@@ -92,36 +102,44 @@ struct Value
 
     template <class T, typename std::enable_if<std::is_same<T, Values>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
+        : _name(internName(name))
         , _type(Type::values)
         , _data(v)
     {
     }
 
+    template <class T, typename std::enable_if<std::is_same<T, Values>::value>::type* = nullptr>
+    Value(T&& v, const std::string& name = "")
+        : _name(internName(name))
+        , _type(Type::values)
+        , _data(std::move(v))
+    {
+    }
+
     template <class T, typename std::enable_if<std::is_same<T, Buffer>::value>::type* = nullptr>
     Value(const T& v, const std::string& name = "")
-        : _name(name)
+        : _name(internName(name))
         , _type(Type::buffer)
         , _data(v)
     {
     }
 
-    Value(const Value& v) { operator=(v); }
-    Value& operator=(const Value& v)
+    template <class T, typename std::enable_if<std::is_same<T, Buffer>::value>::type* = nullptr>
+    Value(T&& v, const std::string& name = "")
+        : _name(internName(name))
+        , _type(Type::buffer)
+        , _data(std::move(v))
     {
-        if (this != &v)
-        {
-            _name = v._name;
-            _type = v._type;
-            _data = v._data;
-        }
-
-        return *this;
     }
 
+    Value(const Value& v) = default;
+    Value& operator=(const Value& v) = default;
+    Value(Value&& v) noexcept = default;
+    Value& operator=(Value&& v) noexcept = default;
+
     Value& operator[](const std::string& name)
     {
-        _name = name;
+        _name = internName(name);
         return *this;
     }
 
@@ -137,7 +155,8 @@ struct Value
         if (_type != v._type)
             return false;
 
-        if (_name != v._name)
+        // Names are interned, comparing their contents is only needed if they come from different name sets
+        if (_name != v._name && (!_name || !v._name || *_name != *v._name))
             return false;
 
         switch (_type)
@@ -176,7 +195,7 @@ struct Value
         }
     }
 
-    bool operator==(const Values v) const
+    bool operator==(const Values& v) const
     {
         if (_type != Type::values)
             return false;
@@ -344,9 +363,23 @@ struct Value
         }
     }
 
-    std::string getName() const { return _name; }
-    void setName(const std::string& name) { _name = name; }
-    bool isNamed() const { return !_name.empty(); }
+    /**
+     * Get a reference to the held data, without any conversion nor copy. The Value must hold this type.
+     * \return Return a reference to the data
+     */
+    template <class T>
+    const T& asRef() const
+    {
+        return std::get<T>(_data);
+    }
+
+    const std::string& getName() const
+    {
+        static const std::string emptyName{};
+        return _name ? *_name : emptyName;
+    }
+    void setName(const std::string& name) { _name = internName(name); }
+    bool isNamed() const { return _name != nullptr; }
 
     Type getType() const { return _type; }
     char getTypeAsChar() const
@@ -390,9 +423,25 @@ struct Value
     }
 
   private:
-    std::string _name{""};
+    const std::string* _name{nullptr}; //!< Interned name, nullptr if the value is not named
     Type _type{Type::integer};
     std::variant<int64_t, double, std::string, Values, Buffer> _data;
+
+    /**
+     * Get the interned version of the given name. Names are never freed, which is fine as the set of names used is small.
+     * \param name Name
+     * \return Return a pointer to the interned name, or nullptr if the name is empty
+     */
+    static const std::string* internName(const std::string& name)
+    {
+        if (name.empty())
+            return nullptr;
+
+        static auto names = new std::unordered_set<std::string>;
+        static auto namesMutex = new std::mutex;
+        std::lock_guard<std::mutex> lock(*namesMutex);
+        return &*names->insert(name).first;
+    }
 }; // namespace Splash
 
 } // namespace Splash
@@ -15,6 +15,7 @@
 #include "./core/link.h"
 #include "./core/scene.h"
 #include "./core/serializer.h"
+#include "./core/thread_pool.h"
 #include "./image/image.h"
 #include "./image/queue.h"
 #include "./mesh/mesh.h"
@@ -78,6 +79,9 @@ void World::run()
         _tree.processQueue(true);
         Timer::get() >> "tree_process";
 
+        // Messages sent by the tasks and objects are batched, and sent all at once
+        _link->startMessageBatch();
+
         // Execute waiting tasks
         executeTreeCommands();
         runTasks();
@@ -101,7 +105,7 @@ void World::run()
                     if (!serializedObjectIt.second)
                         continue; // Error while inserting the object in the map
 
-                    threads.push_back(async(launch::async, [=]() {
+                    threads.push_back(ThreadPool::get().enqueue([=]() {
                         // Update the local objects
                         o.second->update();
 
@@ -110,7 +114,8 @@ void World::run()
                         {
                             if (bufferObj->wasUpdated()) // if the buffer has been updated
                             {
-                                auto obj = bufferObj->serialize();
+                                // Scenes living in this process only need a handle over the buffer
+                                auto obj = _link->isConnectedToOuter() ? _link->serialize(bufferObj) : bufferObj->share();
                                 bufferObj->setNotUpdated();
                                 if (obj)
                                     serializedObjectIt.first->second = obj;
@@ -118,9 +123,14 @@ void World::run()
                         }
                     }));
                 }
+
+                for (auto& thread : threads)
+                    thread.wait();
             }
             Timer::get() >> "serialize";
 
+            _link->flushMessageBatch();
+
             // Wait for previous buffers to be uploaded
             _link->waitForBufferSending(chrono::milliseconds(50)); // Maximum time to wait for frames to arrive
             sendMessage(SPLASH_ALL_PEERS, "uploadTextures", {});
@@ -684,6 +694,15 @@ void World::init()
 
         registerAttributes();
         initializeTree();
+
+        // Regularly measure the round-trip latency to the Scenes, published in /world/durations
+        addPeriodicTask("roundtrip",
+            [this]() {
+                auto now = Timer::getTime();
+                for (auto& scene : _scenes)
+                    sendMessage(scene.first, "ping", {now});
+            },
+            1000);
     }
 }
 
@@ -1288,10 +1307,15 @@ void World::registerAttributes()
 
     addAttribute("pong",
         [&](const Values& args) {
-            Timer::get() >> ("pingScene " + args[0].as<string>());
+            auto sceneName = args[0].as<string>();
+            if (args.size() > 1)
+                Timer::get().setDuration("roundtrip_" + sceneName, Timer::getTime() - args[1].as<int64_t>());
+            else
+                Timer::get() >> ("pingScene " + sceneName);
             return true;
         },
         {'s'});
+    setAttributeDescription("pong", "Answer from a Scene to a ping, with the timestamp sent along if any");
 
     addAttribute("quit", [&](const Values&) {
         _quit = true;
@@ -1523,6 +1547,22 @@ void World::registerAttributes()
         {'n'});
     setAttributeDescription("framerate", "Set the minimum refresh rate for the world (adapted to video framerate)");
 
+    addAttribute("bufferTransport",
+        [&](const Values& args) {
+            auto transport = args[0].as<string>();
+            if (transport == "shm")
+                _link->setBufferTransport(Link::BufferTransport::shm);
+            else if (transport == "ipc")
+                _link->setBufferTransport(Link::BufferTransport::ipc);
+            else
+                return false;
+            return true;
+        },
+        [&]() -> Values { return {_link->getBufferTransport() == Link::BufferTransport::shm ? "shm" : "ipc"}; },
+        {'s'});
+    setAttributeDescription("bufferTransport",
+        "Transport used to send buffers to the Scenes: 'ipc' to send them through sockets, 'shm' to write them once in shared memory and read them in place");
+
 #if HAVE_PORTAUDIO
     addAttribute("clockDeviceName",
         [&](const Values& args) {
@@ -1545,6 +1585,7 @@ void World::registerAttributes()
 
     addAttribute("configurationPath", [&](const Values& /*args*/) { return true; }, [&]() -> Values { return {_configurationPath}; }, {'s'});
     setAttributeDescription("configurationPath", "Path to the configuration files");
+    setAttributeVolatile("configurationPath", true);
 
     addAttribute("mediaPath",
         [&](const Values& args) {
@@ -1567,6 +1608,7 @@ void World::registerAttributes()
 
     addAttribute("clock", [&](const Values& /*args*/) { return true; }, [&]() -> Values { return {Timer::getTime()}; }, {});
     setAttributeDescription("clock", "Current World clock (not settable)");
+    setAttributeVolatile("clock", true);
 
     addAttribute("masterClock",
         [&](const Values& /*args*/) { return true; },
@@ -1579,6 +1621,7 @@ void World::registerAttributes()
         },
         {});
     setAttributeDescription("masterClock", "Current World master clock (not settable)");
+    setAttributeVolatile("masterClock", true);
 
     RootObject::registerAttributes();
 }
@@ -1,5 +1,6 @@
 #include "./graphics/camera.h"
 
+#include <cstddef>
 #include <fstream>
 #include <limits>
 
@@ -89,11 +90,77 @@ Camera::Camera(RootObject* root)
 /*************/
 Camera::~Camera()
 {
+    if (_cameraBlockBuffer != 0)
+        glDeleteBuffers(1, &_cameraBlockBuffer);
+
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Camera::~Camera - Destructor" << Log::endl;
 #endif
 }
 
+/*************/
+Camera::CameraBlock Camera::getCameraBlock(bool withColorLUT) const
+{
+    vec2 colorBalance = colorBalanceFromTemperature(_colorTemperature);
+
+    CameraBlock block;
+    block.attributes = vec4(_blendWidth, _brightness, _saturation, _contrast);
+    block.fovAndColorBalance = vec4(_fov * _width / _height * M_PI / 180.0, _fov * M_PI / 180.0, colorBalance.x, colorBalance.y);
+    block.wireframeColor = vec4(_wireframeColor);
+    block.showCameraCount = _showCameraCount;
+    block.isColorLUT = _colorLUT.size() == 768 && _isColorLUTActivated;
+    block.padding[0] = block.padding[1] = 0;
+    for (int u = 0; u < 3; ++u)
+        block.colorMixMatrix[u] = vec4(_colorMixMatrix[u], 0.f);
+
+    if (block.isColorLUT && withColorLUT)
+        for (int i = 0; i < 256; ++i)
+            block.colorLUT[i] = vec4(_colorLUT[i * 3].as<float>(), _colorLUT[i * 3 + 1].as<float>(), _colorLUT[i * 3 + 2].as<float>(), 0.f);
+
+    return block;
+}
+
+/*************/
+void Camera::updateCameraBlock()
+{
+    if (_cameraBlockBuffer == 0)
+    {
+        glCreateBuffers(1, &_cameraBlockBuffer);
+        glNamedBufferStorage(_cameraBlockBuffer, sizeof(CameraBlock), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    }
+
+    auto block = getCameraBlock();
+
+    // The LUT is only sent when used, the shader does not read it otherwise
+    size_t blockSize = block.isColorLUT ? sizeof(CameraBlock) : offsetof(CameraBlock, colorLUT);
+    glNamedBufferSubData(_cameraBlockBuffer, 0, blockSize, &block);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::cameraBlockBinding, _cameraBlockBuffer);
+}
+
+/*************/
+bool Camera::canRenderAsView() const
+{
+    if (!_multiview || _hidden || _drawFrame || _flashBG)
+        return false;
+
+    // Calibration markers and additional models are specific to each camera
+    if (_displayCalibration || _displayAllCalibrations || !_drawables.empty())
+        return false;
+
+    // Pending framebuffer changes are applied by a regular render
+    if (_updateColorDepth || _newWidth != 0 || _newHeight != 0)
+        return false;
+
+    for (auto& o : _objects)
+    {
+        auto obj = o.lock();
+        if (obj && !obj->supportsMultiview())
+            return false;
+    }
+
+    return true;
+}
+
 /*************/
 void Camera::computeBlendingContribution()
 {
@@ -528,11 +595,8 @@ Values Camera::pickVertexOrCalibrationPoint(float x, float y)
 }
 
 /*************/
-void Camera::render()
+bool Camera::updateFramebuffers()
 {
-    // Keep the timestamp of the newest object
-    int64_t timestamp{0};
-
     if (_updateColorDepth)
     {
         _msFbo->setParameters(_multisample, _render16bits, false);
@@ -551,7 +615,7 @@ void Camera::render()
     }
 
     if (!_msFbo || !_outFbo)
-        return;
+        return false;
 
     ImageBufferSpec spec = _msFbo->getColorTexture()->getSpec();
     if (spec.width != _width || spec.height != _height)
@@ -560,6 +624,18 @@ void Camera::render()
         _outFbo->setSize(spec.width, spec.height);
     }
 
+    return true;
+}
+
+/*************/
+void Camera::render()
+{
+    // Keep the timestamp of the newest object
+    int64_t timestamp{0};
+
+    if (!updateFramebuffers())
+        return;
+
 #ifdef DEBUG
     glGetError();
 #endif
@@ -587,6 +663,9 @@ void Camera::render()
 
     if (!_hidden)
     {
+        // Camera-wide shader state is sent once, and shared by all objects
+        updateCameraBlock();
+
         // Draw the objects
         for (auto& o : _objects)
         {
@@ -597,28 +676,6 @@ void Camera::render()
             timestamp = std::max(timestamp, obj->getTimestamp());
             obj->activate();
 
-            vec2 colorBalance = colorBalanceFromTemperature(_colorTemperature);
-            obj->getShader()->setAttribute("uniform", {"_wireframeColor", _wireframeColor.x, _wireframeColor.y, _wireframeColor.z, _wireframeColor.w});
-            obj->getShader()->setAttribute("uniform", {"_cameraAttributes", _blendWidth, _brightness, _saturation, _contrast});
-            obj->getShader()->setAttribute("uniform", {"_fovAndColorBalance", _fov * _width / _height * M_PI / 180.0, _fov * M_PI / 180.0, colorBalance.x, colorBalance.y});
-            obj->getShader()->setAttribute("uniform", {"_showCameraCount", (int)_showCameraCount});
-            if (_colorLUT.size() == 768 && _isColorLUTActivated)
-            {
-                obj->getShader()->setAttribute("uniform", {"_colorLUT", _colorLUT});
-                obj->getShader()->setAttribute("uniform", {"_isColorLUT", 1});
-
-                Values m(10);
-                m[0] = "_colorMixMatrix";
-                for (int u = 0; u < 3; ++u)
-                    for (int v = 0; v < 3; ++v)
-                        m[u * 3 + v + 1] = _colorMixMatrix[u][v];
-                obj->getShader()->setAttribute("uniform", m);
-            }
-            else
-            {
-                obj->getShader()->setAttribute("uniform", {"_isColorLUT", 0});
-            }
-
             obj->setViewProjectionMatrix(computeViewMatrix(), computeProjectionMatrix());
             obj->draw();
             obj->deactivate();
@@ -741,13 +798,31 @@ void Camera::render()
         _outFbo->unbindDraw();
     }
 
+    finalizeOutput(timestamp);
+}
+
+/*************/
+void Camera::setOutputFromView(GLuint fbo, int64_t timestamp)
+{
+    glBlitNamedFramebuffer(fbo, _outFbo->getFboId(), 0, 0, _outFbo->getWidth(), _outFbo->getHeight(), 0, 0, _outFbo->getWidth(), _outFbo->getHeight(),
+        GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    finalizeOutput(timestamp);
+}
+
+/*************/
+void Camera::finalizeOutput(int64_t timestamp)
+{
     if (_grabMipmapLevel >= 0)
     {
         auto colorTexture = _outFbo->getColorTexture();
         colorTexture->generateMipmap();
-        _mipmapBuffer = colorTexture->grabMipmap(_grabMipmapLevel).getRawBuffer();
-        auto spec = colorTexture->getSpec();
-        _mipmapBufferSpec = {spec.width, spec.height, spec.channels, spec.bpp, spec.format};
+        auto image = colorTexture->grabMipmap(_grabMipmapLevel);
+        if (!image.empty())
+        {
+            _mipmapBuffer = image.getRawBuffer();
+            auto spec = image.getSpec();
+            _mipmapBufferSpec = {spec.width, spec.height, spec.channels, spec.bpp, spec.format};
+        }
     }
 
     // Set the timestamp for the output texture
@@ -758,8 +833,6 @@ void Camera::render()
     if (error)
         Log::get() << Log::WARNING << _type << "::" << __FUNCTION__ << " - Error while rendering the camera: " << error << Log::endl;
 #endif
-
-    return;
 }
 
 /*************/
@@ -1553,6 +1626,15 @@ void Camera::registerAttributes()
         {'n'});
     setAttributeDescription("hide", "If set to 1, prevent from drawing this camera");
 
+    addAttribute("multiview",
+        [&](const Values& args) {
+            _multiview = args[0].as<bool>();
+            return true;
+        },
+        [&]() -> Values { return {_multiview}; },
+        {'n'});
+    setAttributeDescription("multiview", "If set to 1, render in a single pass along with the other cameras looking at the same objects with the same output parameters");
+
     addAttribute("wireframe",
         [&](const Values& args) {
             string primitive;
@@ -1593,10 +1675,12 @@ void Camera::registerAttributes()
     setAttributeDescription("grabMipmapLevel", "If set to 0 or superior, sync the rendered texture to the 'buffer' attribute, at the given mipmap level");
 
     addAttribute("buffer", [&](const Values&) { return true; }, [&]() -> Values { return {_mipmapBuffer}; }, {});
-    setAttributeDescription("buffer", "Getter attribute which gives access to the mipmap image, if grabMipmapLevel is greater or equal to 0");
+    setAttributeDescription("buffer", "Getter attribute which gives access to the last mipmap image read back, if grabMipmapLevel is greater or equal to 0");
+    setAttributeVolatile("buffer", true);
 
     addAttribute("bufferSpec", [&](const Values&) { return true; }, [&]() -> Values { return _mipmapBufferSpec; }, {});
     setAttributeDescription("bufferSpec", "Getter attribute to the specs of the attribute buffer");
+    setAttributeVolatile("bufferSpec", true);
 
     //
     // Various options
@@ -66,6 +66,20 @@ class Camera : public GraphObject
         viewAll = 1
     };
 
+    // Camera-wide shader state, laid out as the _cameraBlock uniform block (std140)
+    struct CameraBlock
+    {
+        glm::vec4 attributes;         //!< Blend width, brightness, saturation, contrast
+        glm::vec4 fovAndColorBalance; //!< Horizontal and vertical FOV in radians, color balance
+        glm::vec4 wireframeColor;
+        int32_t showCameraCount;
+        int32_t isColorLUT;
+        int32_t padding[2];
+        glm::vec4 colorMixMatrix[3]; //!< Columns of the mat3, each padded to a vec4
+        glm::vec4 colorLUT[256];
+    };
+    static_assert(sizeof(CameraBlock) == 4208, "CameraBlock must match the std140 layout of _cameraBlock");
+
     /**
      * \brief Constructor
      * \param root Root object
@@ -123,6 +137,31 @@ class Camera : public GraphObject
      */
     void drawModelOnce(const std::string& modelName, const glm::dmat4& rtMatrix);
 
+    /**
+     * \brief Check whether this camera can be rendered along with other cameras in a single multiview pass
+     * \return Return true if multiview is enabled, and nothing specific to this camera has to be drawn
+     */
+    bool canRenderAsView() const;
+
+    /**
+     * \brief Get the camera-wide shader state
+     * \param withColorLUT If true, fill the color LUT, which is only read by the shaders when activated
+     * \return Return the camera block
+     */
+    CameraBlock getCameraBlock(bool withColorLUT = true) const;
+
+    /**
+     * \brief Get the multisampling value
+     * \return Return the number of samples, 0 if disabled
+     */
+    int getMultisample() const { return _multisample; }
+
+    /**
+     * \brief Get the objects linked to this camera
+     * \return Return the objects
+     */
+    const std::vector<std::weak_ptr<Object>>& getObjects() const { return _objects; }
+
     /**
      * \brief Get the output texture for this camera
      * \return Return a pointer to the output textures
@@ -179,6 +218,13 @@ class Camera : public GraphObject
      */
     void render() override;
 
+    /**
+     * \brief Set the output of this camera from a multiview pass
+     * \param fbo Framebuffer holding the view of this camera as its first color layer and depth layer
+     * \param timestamp Timestamp of the newest object rendered
+     */
+    void setOutputFromView(GLuint fbo, int64_t timestamp);
+
     /**
      * \brief Set the given calibration point. This point is then selected
      * \return Return true if the point has been added or if it already existed
@@ -234,6 +280,7 @@ class Camera : public GraphObject
     bool _hidden{false};
     bool _flashBG{false};
     bool _render16bits{true};
+    bool _multiview{false}; //!< If true, render along with the other cameras looking at the same objects
     int _multisample{0};
     bool _updateColorDepth{false}; // Set to true if the _render16bits has been updated
     glm::dvec4 _clearColor{0.6, 0.6, 0.6, 1.0};
@@ -249,6 +296,8 @@ class Camera : public GraphObject
     bool _isColorLUTActivated{false};
     glm::mat3 _colorMixMatrix;
 
+    GLuint _cameraBlockBuffer{0};
+
     // Camera parameters
     float _fov{35.f};                      //!< Vertical FOV
     float _width{512.f}, _height{512.f};   //!< Current width and height
@@ -325,6 +374,23 @@ class Camera : public GraphObject
      */
     void removeCalibrationPointsFromObjects();
 
+    /**
+     * \brief Upload the camera-wide shader state and bind it to the camera block binding point
+     */
+    void updateCameraBlock();
+
+    /**
+     * \brief Apply the pending size and color depth changes to the framebuffers
+     * \return Return false if the framebuffers are not available
+     */
+    bool updateFramebuffers();
+
+    /**
+     * \brief Finalize the output texture once rendered, i.e. set its timestamp and grab its mipmap if needed
+     * \param timestamp Timestamp of the newest object rendered
+     */
+    void finalizeOutput(int64_t timestamp);
+
     /**
      * \brief Register new functors to modify attributes
      */
@@ -220,16 +220,21 @@ void Filter::render()
     _fbo->getColorTexture()->generateMipmap();
     if (_grabMipmapLevel >= 0)
     {
-        auto colorTexture = _fbo->getColorTexture();
-        _mipmapBuffer = colorTexture->grabMipmap(_grabMipmapLevel).getRawBuffer();
-        auto spec = colorTexture->getSpec();
-        _mipmapBufferSpec = {spec.width, spec.height, spec.channels, spec.bpp, spec.format};
+        auto image = _fbo->getColorTexture()->grabMipmap(_grabMipmapLevel);
+        if (!image.empty())
+        {
+            _mipmapBuffer = image.getRawBuffer();
+            auto spec = image.getSpec();
+            _mipmapBufferSpec = {spec.width, spec.height, spec.channels, spec.bpp, spec.format};
+        }
     }
 
     // Automatic black level stuff
-    if (_autoBlackLevelTargetValue != 0.f)
+    // The mean value is read back asynchronously, and is not available on every frame
+    auto meanValue = _autoBlackLevelTargetValue != 0.f ? _fbo->getColorTexture()->getMeanValue() : nullopt;
+    if (meanValue)
     {
-        auto luminance = _fbo->getColorTexture()->getMeanValue().luminance();
+        auto luminance = meanValue->luminance();
         auto deltaLuminance = _autoBlackLevelTargetValue - luminance;
         auto newBlackLevel = _autoBlackLevel + deltaLuminance / 2.f;
 
@@ -686,6 +691,7 @@ void Filter::registerDefaultShaderAttributes()
         },
         {});
     setAttributeDescription("size", "Size of the input texture");
+    setAttributeVolatile("size", true);
 
     addAttribute("sizeOverride",
         [&](const Values& args) {
@@ -711,10 +717,12 @@ void Filter::registerDefaultShaderAttributes()
     setAttributeDescription("grabMipmapLevel", "If set to 0 or superior, sync the rendered texture to the tree, at the given mipmap level");
 
     addAttribute("buffer", [&](const Values&) { return true; }, [&]() -> Values { return {_mipmapBuffer}; }, {});
-    setAttributeDescription("buffer", "Getter attribute which gives access to the mipmap image, if grabMipmapLevel is greater or equal to 0");
+    setAttributeDescription("buffer", "Getter attribute which gives access to the last mipmap image read back, if grabMipmapLevel is greater or equal to 0");
+    setAttributeVolatile("buffer", true);
 
     addAttribute("bufferSpec", [&](const Values&) { return true; }, [&]() -> Values { return _mipmapBufferSpec; }, {});
     setAttributeDescription("bufferSpec", "Getter attribute to the specs of the attribute buffer");
+    setAttributeVolatile("bufferSpec", true);
 }
 
 } // namespace Splash
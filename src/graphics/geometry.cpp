@@ -144,6 +144,50 @@ void Geometry::deactivateFeedback()
     _temporaryVerticesNumber = drawnPrimitives * 3;
 }
 
+/*************/
+void Geometry::drawVisible(const dmat4& modelViewMatrix, const dmat4& projectionMatrix, int faceCulling)
+{
+    // The hierarchy describes the mesh, not the buffers output by the tessellation
+    if (!_bvh || _useAlternativeBuffers || _bvh->getVertexCount() != static_cast<uint32_t>(_verticesNumber))
+    {
+        glDrawArrays(GL_TRIANGLES, 0, getVerticesNumber());
+        return;
+    }
+
+    // Face culling depends on the position of the eye, which only makes sense with a perspective projection
+    vec3 eye(0.f);
+    if (faceCulling != 0 && projectionMatrix[3][3] == 0.0)
+    {
+        eye = vec3(inverse(modelViewMatrix) * dvec4(0.0, 0.0, 0.0, 1.0));
+        // Mirroring transformations swap front and back faces
+        if (determinant(dmat3(modelViewMatrix)) < 0.0)
+            faceCulling = -faceCulling;
+    }
+    else
+    {
+        faceCulling = 0;
+    }
+
+    _bvh->cull(mat4(projectionMatrix * modelViewMatrix), eye, faceCulling, _visibleRanges);
+    if (_visibleRanges.empty())
+        return;
+
+    if (_visibleRanges.size() == 1)
+    {
+        glDrawArrays(GL_TRIANGLES, _visibleRanges[0].first, _visibleRanges[0].count);
+        return;
+    }
+
+    _visibleFirsts.resize(_visibleRanges.size());
+    _visibleCounts.resize(_visibleRanges.size());
+    for (size_t i = 0; i < _visibleRanges.size(); ++i)
+    {
+        _visibleFirsts[i] = _visibleRanges[i].first;
+        _visibleCounts[i] = _visibleRanges[i].count;
+    }
+    glMultiDrawArrays(GL_TRIANGLES, _visibleFirsts.data(), _visibleCounts.data(), _visibleRanges.size());
+}
+
 /*************/
 shared_ptr<SerializedObject> Geometry::serialize() const
 {
@@ -192,23 +236,10 @@ bool Geometry::linkIt(const shared_ptr<GraphObject>& obj)
 /*************/
 float Geometry::pickVertex(dvec3 p, dvec3& v)
 {
-    float distance = numeric_limits<float>::max();
-    dvec3 closestVertex;
-
     assert(_mesh);
-    vector<float> vertices = _mesh->getVertCoords();
-    for (uint32_t i = 0; i < vertices.size(); i += 4)
-    {
-        dvec3 vertex(vertices[i], vertices[i + 1], vertices[i + 2]);
-        float dist = length(p - vertex);
-        if (dist < distance)
-        {
-            closestVertex = vertex;
-            distance = dist;
-        }
-    }
-
-    v = closestVertex;
+    vec3 closestVertex(0.f);
+    float distance = _mesh->pickVertex(vec3(p), closestVertex);
+    v = dvec3(closestVertex);
 
     return distance;
 }
@@ -280,6 +311,7 @@ void Geometry::update()
             glDeleteVertexArrays(1, &(v.second));
         _vertexArray.clear();
 
+        _bvh = _mesh->getBVH();
         _timestamp = _mesh->getTimestamp();
 
         _buffersDirty = true;
@@ -87,6 +87,15 @@ class Geometry : public BufferObject
      */
     void deactivateFeedback();
 
+    /**
+     * \brief Draw the geometry, skipping the parts of the mesh which can not be seen through the given matrices.
+     * Must be called between activate() and deactivate().
+     * \param modelViewMatrix Model view matrix
+     * \param projectionMatrix Projection matrix
+     * \param faceCulling Set to 1 if back faces are culled, -1 for front faces, 0 if none are
+     */
+    void drawVisible(const glm::dmat4& modelViewMatrix, const glm::dmat4& projectionMatrix, int faceCulling);
+
     /**
      * \brief Get the number of vertices for this geometry
      * \return Return the vertice count
@@ -164,6 +173,12 @@ class Geometry : public BufferObject
     bool _onMasterScene{false};
 
     std::shared_ptr<Mesh> _mesh;
+    std::shared_ptr<const MeshBVH> _bvh{nullptr}; //!< Hierarchy of the mesh, matching _glBuffers
+
+    // Ranges of vertices drawn by drawVisible, kept to not allocate them for every draw
+    std::vector<MeshBVH::Range> _visibleRanges{};
+    std::vector<GLint> _visibleFirsts{};
+    std::vector<GLsizei> _visibleCounts{};
 
     std::map<GLFWwindow*, GLuint> _vertexArray;
     std::vector<std::shared_ptr<GpuBuffer>> _glBuffers{};
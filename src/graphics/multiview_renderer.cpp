@@ -0,0 +1,241 @@
+#include "./graphics/multiview_renderer.h"
+
+#include <algorithm>
+
+#include "./graphics/object.h"
+#include "./graphics/shader.h"
+#include "./utils/log.h"
+#include "./utils/timer.h"
+
+using namespace std;
+using namespace glm;
+
+namespace Splash
+{
+
+/*************/
+MultiviewRenderer::~MultiviewRenderer()
+{
+    for (auto& target : _targets)
+        deleteTarget(target);
+    if (_viewBuffer != 0)
+        glDeleteBuffers(1, &_viewBuffer);
+}
+
+/*************/
+void MultiviewRenderer::setCameras(const vector<weak_ptr<Camera>>& cameras)
+{
+    _frameCameras.clear();
+    _groups.clear();
+
+    for (const auto& weakCamera : cameras)
+    {
+        auto camera = weakCamera.lock();
+        if (!camera || !camera->canRenderAsView())
+            continue;
+
+        auto texture = camera->getTexture();
+        if (!texture)
+            continue;
+
+        Group candidate;
+        for (const auto& o : camera->getObjects())
+            if (auto obj = o.lock())
+                candidate.objects.push_back(obj);
+        if (candidate.objects.empty())
+            continue;
+
+        auto spec = texture->getSpec();
+        candidate.width = spec.width;
+        candidate.height = spec.height;
+        candidate.render16bits = spec.bpp == 64;
+        candidate.multisample = camera->getMultisample();
+
+        auto groupIt = find_if(_groups.begin(), _groups.end(), [&](const Group& group) {
+            return group.cameras.size() < static_cast<size_t>(_maxViewCount) && group.objects == candidate.objects && group.width == candidate.width && group.height == candidate.height &&
+                   group.render16bits == candidate.render16bits && group.multisample == candidate.multisample;
+        });
+
+        if (groupIt == _groups.end())
+        {
+            _groups.push_back(candidate);
+            groupIt = prev(_groups.end());
+        }
+        groupIt->cameras.push_back(camera.get());
+        _frameCameras.push_back(camera);
+    }
+
+    // A single camera is rendered as usual
+    _groups.erase(remove_if(_groups.begin(), _groups.end(), [](const Group& group) { return group.cameras.size() < 2; }), _groups.end());
+}
+
+/*************/
+bool MultiviewRenderer::isRenderedAsView(const GraphObject* camera) const
+{
+    for (const auto& group : _groups)
+        if (find(group.cameras.begin(), group.cameras.end(), camera) != group.cameras.end())
+            return true;
+    return false;
+}
+
+/*************/
+void MultiviewRenderer::render()
+{
+    static_assert(sizeof(View) == 4336, "View must match the std430 layout of CameraView");
+
+    if (_groups.empty())
+    {
+        _frameCameras.clear();
+        return;
+    }
+
+    Timer::get() << "multiview";
+
+    if (_targets.size() < _groups.size())
+        _targets.resize(_groups.size());
+
+    for (size_t groupIndex = 0; groupIndex < _groups.size(); ++groupIndex)
+    {
+        const auto& group = _groups[groupIndex];
+        auto& target = _targets[groupIndex];
+        updateTarget(target, group);
+        if (target.drawFbo == 0)
+        {
+            for (auto camera : group.cameras)
+                camera->render();
+            continue;
+        }
+
+        // Gather the state of all views in a storage buffer
+        _views.resize(group.cameras.size());
+        for (size_t i = 0; i < group.cameras.size(); ++i)
+        {
+            auto camera = group.cameras[i];
+            auto viewMatrix = camera->computeViewMatrix();
+            _views[i].viewProjectionMatrix = mat4(camera->computeProjectionMatrix() * viewMatrix);
+            _views[i].viewNormalMatrix = mat4(transpose(inverse(viewMatrix)));
+            _views[i].camera = camera->getCameraBlock();
+        }
+
+        const size_t viewsSize = _views.size() * sizeof(View);
+        if (_viewBufferSize < viewsSize)
+        {
+            if (_viewBuffer != 0)
+                glDeleteBuffers(1, &_viewBuffer);
+            glCreateBuffers(1, &_viewBuffer);
+            glNamedBufferStorage(_viewBuffer, viewsSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+            _viewBufferSize = viewsSize;
+        }
+        glNamedBufferSubData(_viewBuffer, 0, viewsSize, _views.data());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, Shader::cameraBlockBinding, _viewBuffer);
+
+        // Draw all objects once, for all views
+        GLint previousFbo;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.drawFbo);
+        if (target.multisample)
+            glEnable(GL_MULTISAMPLE);
+        glViewport(0, 0, target.width, target.height);
+        glEnable(GL_DEPTH_TEST);
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        const int viewCount = static_cast<int>(group.cameras.size());
+        int64_t timestamp{0};
+        for (const auto& obj : group.objects)
+        {
+            timestamp = std::max(timestamp, obj->getTimestamp());
+            obj->activate(viewCount);
+            // Views are applied by the geometry stage, only the model matrix is needed
+            obj->setViewProjectionMatrix(dmat4(1.0), dmat4(1.0));
+            obj->draw();
+            obj->deactivate();
+        }
+
+        glDisable(GL_DEPTH_TEST);
+        if (target.multisample)
+            glDisable(GL_MULTISAMPLE);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousFbo);
+
+        // Copy each layer to the output of its camera, resolving the multisampling if needed
+        for (size_t i = 0; i < group.cameras.size(); ++i)
+        {
+            glNamedFramebufferTextureLayer(target.readFbo, GL_COLOR_ATTACHMENT0, target.color, 0, i);
+            glNamedFramebufferTextureLayer(target.readFbo, GL_DEPTH_ATTACHMENT, target.depth, 0, i);
+            group.cameras[i]->setOutputFromView(target.readFbo, timestamp);
+        }
+    }
+
+    Timer::get() >> "multiview";
+
+    _frameCameras.clear();
+}
+
+/*************/
+void MultiviewRenderer::updateTarget(Target& target, const Group& group)
+{
+    const int layers = static_cast<int>(group.cameras.size());
+    if (target.drawFbo != 0 && target.width == group.width && target.height == group.height && target.layers == layers && target.render16bits == group.render16bits &&
+        target.multisample == group.multisample)
+        return;
+
+    deleteTarget(target);
+
+    target.width = group.width;
+    target.height = group.height;
+    target.layers = layers;
+    target.render16bits = group.render16bits;
+    target.multisample = group.multisample;
+
+    // Same formats as the camera framebuffers (RGBA16 or RGBA, see Framebuffer), so that copying a layer is a plain copy
+    const GLenum colorFormat = target.render16bits ? GL_RGBA16 : GL_RGBA8;
+    if (target.multisample)
+    {
+        glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE_ARRAY, 1, &target.color);
+        glTextureStorage3DMultisample(target.color, target.multisample, colorFormat, target.width, target.height, layers, GL_FALSE);
+        glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE_ARRAY, 1, &target.depth);
+        glTextureStorage3DMultisample(target.depth, target.multisample, GL_DEPTH_COMPONENT24, target.width, target.height, layers, GL_FALSE);
+    }
+    else
+    {
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &target.color);
+        glTextureStorage3D(target.color, 1, colorFormat, target.width, target.height, layers);
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &target.depth);
+        glTextureStorage3D(target.depth, 1, GL_DEPTH_COMPONENT24, target.width, target.height, layers);
+    }
+
+    // Attaching the whole arrays makes the framebuffer layered
+    glCreateFramebuffers(1, &target.drawFbo);
+    glNamedFramebufferTexture(target.drawFbo, GL_COLOR_ATTACHMENT0, target.color, 0);
+    glNamedFramebufferTexture(target.drawFbo, GL_DEPTH_ATTACHMENT, target.depth, 0);
+    GLenum fboBuffers[1] = {GL_COLOR_ATTACHMENT0};
+    glNamedFramebufferDrawBuffers(target.drawFbo, 1, fboBuffers);
+
+    glCreateFramebuffers(1, &target.readFbo);
+    glNamedFramebufferTextureLayer(target.readFbo, GL_COLOR_ATTACHMENT0, target.color, 0, 0);
+    glNamedFramebufferTextureLayer(target.readFbo, GL_DEPTH_ATTACHMENT, target.depth, 0, 0);
+    glNamedFramebufferReadBuffer(target.readFbo, GL_COLOR_ATTACHMENT0);
+
+    GLenum status = glCheckNamedFramebufferStatus(target.drawFbo, GL_DRAW_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        Log::get() << Log::ERROR << "MultiviewRenderer::" << __FUNCTION__ << " - Error while initializing the layered framebuffer object: " << status << Log::endl;
+        deleteTarget(target);
+    }
+}
+
+/*************/
+void MultiviewRenderer::deleteTarget(Target& target)
+{
+    if (target.drawFbo != 0)
+        glDeleteFramebuffers(1, &target.drawFbo);
+    if (target.readFbo != 0)
+        glDeleteFramebuffers(1, &target.readFbo);
+    if (target.color != 0)
+        glDeleteTextures(1, &target.color);
+    if (target.depth != 0)
+        glDeleteTextures(1, &target.depth);
+    target = Target();
+}
+
+} // namespace Splash
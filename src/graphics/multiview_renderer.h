@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @multiview_renderer.h
+ * The MultiviewRenderer class, rendering in a single pass the cameras looking at the same objects
+ * All views are drawn into the layers of a layered framebuffer, each object being drawn once for all
+ * of them, then each layer is copied to the output of its camera.
+ */
+
+#ifndef SPLASH_MULTIVIEW_RENDERER_H
+#define SPLASH_MULTIVIEW_RENDERER_H
+
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "./config.h"
+
+#include "./core/coretypes.h"
+#include "./graphics/camera.h"
+
+namespace Splash
+{
+
+/*************/
+class MultiviewRenderer
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    MultiviewRenderer() = default;
+
+    /**
+     * \brief Destructor. Must be called from the GL context the renderer was used in.
+     */
+    ~MultiviewRenderer();
+
+    /**
+     * No copy constructor
+     */
+    MultiviewRenderer(const MultiviewRenderer&) = delete;
+    MultiviewRenderer& operator=(const MultiviewRenderer&) = delete;
+
+    /**
+     * \brief Group the cameras which can be rendered in a single pass, i.e. with multiview enabled, looking at
+     * the same objects, and with the same output parameters. Groups need at least two cameras.
+     * \param cameras Cameras to render this frame, the ones which do not exist anymore being ignored
+     */
+    void setCameras(const std::vector<std::weak_ptr<Camera>>& cameras);
+
+    /**
+     * \brief Check whether the given camera is rendered by this renderer
+     * \param camera Camera
+     * \return Return true if the camera is part of a group
+     */
+    bool isRenderedAsView(const GraphObject* camera) const;
+
+    /**
+     * \brief Render the groups of cameras
+     */
+    void render();
+
+  private:
+    // Per view state, laid out as the CameraView struct of the _cameraViews storage buffer (std430)
+    struct View
+    {
+        glm::mat4 viewProjectionMatrix;
+        glm::mat4 viewNormalMatrix;
+        Camera::CameraBlock camera;
+    };
+
+    struct Group
+    {
+        std::vector<Camera*> cameras{};
+        std::vector<std::shared_ptr<Object>> objects{};
+        int width{0};
+        int height{0};
+        bool render16bits{false};
+        int multisample{0};
+    };
+
+    // Layered framebuffer, holding one layer per view
+    struct Target
+    {
+        GLuint drawFbo{0};
+        GLuint readFbo{0}; //!< Framebuffer reading a single layer, to copy it to the camera output
+        GLuint color{0};
+        GLuint depth{0};
+        int width{0};
+        int height{0};
+        int layers{0};
+        bool render16bits{false};
+        int multisample{0};
+    };
+
+    static constexpr int _maxViewCount{32}; //!< Minimum value of GL_MAX_GEOMETRY_SHADER_INVOCATIONS
+
+    std::vector<std::shared_ptr<Camera>> _frameCameras{}; //!< Cameras of the current frame, kept alive until rendered
+    std::vector<Group> _groups{};
+    std::vector<Target> _targets{};
+    std::vector<View> _views{};
+    GLuint _viewBuffer{0};
+    size_t _viewBufferSize{0};
+
+    /**
+     * \brief Make sure the target matches the group, recreating it if needed
+     * \param target Target
+     * \param group Group of cameras to render into the target
+     */
+    void updateTarget(Target& target, const Group& group);
+
+    /**
+     * \brief Delete the GL objects of a target
+     * \param target Target
+     */
+    void deleteTarget(Target& target);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_MULTIVIEW_RENDERER_H
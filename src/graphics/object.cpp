@@ -50,19 +50,24 @@ Object::~Object()
 }
 
 /*************/
-void Object::activate()
+void Object::activate(int viewCount)
 {
     if (_geometries.size() == 0)
         return;
 
     _mutex.lock();
 
+    _activeViewCount = viewCount;
+    _hasDrawMatrices = false;
+
     // Create and store the shader depending on its type
-    auto shaderIt = _graphicsShaders.find(_fill);
+    // Multiview rendering gets its own shader, to not switch programs when also rendered by a regular camera
+    const auto shaderName = viewCount > 0 ? _fill + "_multiview" : _fill;
+    auto shaderIt = _graphicsShaders.find(shaderName);
     if (shaderIt == _graphicsShaders.end())
     {
         _shader = make_shared<Shader>();
-        _graphicsShaders[_fill] = _shader;
+        _graphicsShaders[shaderName] = _shader;
     }
     else
     {
@@ -82,6 +87,11 @@ void Object::activate()
     {
         if (_vertexBlendingActive)
             shaderParameters.push_back("VERTEXBLENDING");
+        if (viewCount > 0)
+        {
+            shaderParameters.push_back("MULTIVIEW");
+            shaderParameters.push_back("VIEW_COUNT " + to_string(viewCount));
+        }
         if (_textures.size() > 0 && _textures[0]->getType() == "texture_syphon")
             shaderParameters.push_back("TEXTURE_RECT");
 
@@ -202,7 +212,19 @@ void Object::draw()
         return;
 
     _shader->updateUniforms();
-    glDrawArrays(GL_TRIANGLES, 0, _geometries[0]->getVerticesNumber());
+
+    // Only the fills projecting the vertices with the object matrices can be culled. Multiview draws
+    // project the vertices for each view in the geometry stage, the matrices then do not describe any view.
+    const bool isCullable = _fill == "texture" || _fill == "color" || _fill == "primitiveId" || _fill == "uv" || _fill == "wireframe";
+    if (_hasDrawMatrices && _activeViewCount == 0 && isCullable)
+    {
+        const int faceCulling = _sideness == Shader::singleSided ? 1 : (_sideness == Shader::inverted ? -1 : 0);
+        _geometries[0]->drawVisible(_drawModelViewMatrix, _drawProjectionMatrix, faceCulling);
+    }
+    else
+    {
+        glDrawArrays(GL_TRIANGLES, 0, _geometries[0]->getVerticesNumber());
+    }
 }
 
 /*************/
@@ -557,7 +579,10 @@ void Object::computeCameraContribution(glm::dmat4 viewMatrix, glm::dmat4 project
 /*************/
 void Object::setViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp)
 {
-    _shader->setModelViewProjectionMatrix(mv * computeModelMatrix(), mp);
+    _drawModelViewMatrix = mv * computeModelMatrix();
+    _drawProjectionMatrix = mp;
+    _hasDrawMatrices = true;
+    _shader->setModelViewProjectionMatrix(_drawModelViewMatrix, mp);
 }
 
 /*************/
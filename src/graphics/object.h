@@ -64,8 +64,9 @@ class Object : public GraphObject
 
     /**
      * \brief Activate this object for rendering
+     * \param viewCount Number of views rendered at once into the layers of the framebuffer, 0 for a regular render
      */
-    void activate();
+    void activate(int viewCount = 0);
 
     /**
      * \brief Compute the visibility for the mvp specified with setViewProjectionMatrix, for blending purposes
@@ -116,6 +117,12 @@ class Object : public GraphObject
      */
     void draw();
 
+    /**
+     * \brief Check whether this object can be drawn for multiple views at once
+     * \return Return true if the fill has a multiview variant
+     */
+    bool supportsMultiview() const { return _fill == "texture"; }
+
     /**
      * \brief Get a reference to all the calibration points set
      * \return Return a reference to the vector containing all calibration points
@@ -254,6 +261,12 @@ class Object : public GraphObject
     glm::dvec3 _scale{1.0, 1.0, 1.0};
     glm::dmat4 _modelMatrix;
 
+    // State of the current draw, used to skip the parts of the geometry which can not be seen
+    int _activeViewCount{0};
+    bool _hasDrawMatrices{false};
+    glm::dmat4 _drawModelViewMatrix{1.0};
+    glm::dmat4 _drawProjectionMatrix{1.0};
+
     std::string _fill{"texture"};
     std::vector<std::string> _fillParameters{};
     int _sideness{0};
@@ -0,0 +1,479 @@
+#include "./graphics/program_cache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "./utils/log.h"
+#include "./utils/timer.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+namespace
+{
+constexpr char binaryMagic[8] = {'S', 'P', 'L', 'P', 'R', 'G', 'B', '\0'};
+constexpr uint32_t binaryVersion = 1;
+
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t format;
+    uint64_t keySize;
+    uint64_t binarySize;
+};
+
+// FNV-1a, used to name the binary files as it does not depend on the standard library implementation
+uint64_t hashKey(const string& key)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (auto c : key)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+} // namespace
+
+/*************/
+ProgramCache& ProgramCache::get()
+{
+    static ProgramCache cache;
+    return cache;
+}
+
+/*************/
+ProgramCache::ProgramCache()
+{
+    auto cacheEnv = getenv(SPLASH_SHADER_CACHE_ENV);
+    if (cacheEnv != nullptr)
+    {
+        // An empty value disables the binary cache
+        _cacheDirectory = string(cacheEnv);
+    }
+    else if (auto xdgCache = getenv("XDG_CACHE_HOME"); xdgCache != nullptr && strlen(xdgCache) != 0)
+    {
+        _cacheDirectory = string(xdgCache) + "/splash/shaders";
+    }
+    else if (auto home = getenv("HOME"); home != nullptr && strlen(home) != 0)
+    {
+        _cacheDirectory = string(home) + "/.cache/splash/shaders";
+    }
+}
+
+/*************/
+GLuint ProgramCache::getProgram(const map<GLenum, string>& sources, const vector<string>& feedbackVaryings, const string& name)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    if (!_driverQueried)
+        queryDriver();
+
+    string key;
+    for (const auto& source : sources)
+        key += to_string(source.first) + "\n" + source.second + '\0';
+    for (const auto& varying : feedbackVaryings)
+        key += varying + '\0';
+
+    auto programIt = _programs.find(key);
+    if (programIt != _programs.end())
+        return programIt->second;
+
+    Timer::get() << "programCache";
+
+    const string binaryKey = _driver + '\0' + key;
+    GLuint program = loadBinary(binaryKey);
+    if (program == 0)
+    {
+        program = buildProgram(sources, feedbackVaryings, name);
+        if (program != 0)
+            saveBinary(binaryKey, program);
+    }
+#ifdef DEBUG
+    else
+    {
+        Log::get() << Log::DEBUGGING << "ProgramCache::" << __FUNCTION__ << " - Program " << name << " loaded from its binary" << Log::endl;
+    }
+#endif
+
+    Timer::get() >> "programCache";
+
+    // Failed programs are cached too, to not try building them again and again
+    _programs[key] = program;
+    if (program != 0)
+    {
+        _programUsers[program] = 0;
+        _uniformValues[program] = readUniformValues(program);
+    }
+
+    return program;
+}
+
+/*************/
+bool ProgramCache::setUser(GLuint program, uint64_t userId)
+{
+    lock_guard<mutex> lock(_mutex);
+    auto userIt = _programUsers.find(program);
+    if (userIt == _programUsers.end())
+        return true;
+
+    if (userIt->second == userId)
+        return false;
+
+    userIt->second = userId;
+    return true;
+}
+
+/*************/
+unordered_map<string, Values> ProgramCache::getUniformValues(GLuint program)
+{
+    lock_guard<mutex> lock(_mutex);
+    auto valuesIt = _uniformValues.find(program);
+    if (valuesIt == _uniformValues.end())
+        return {};
+    return valuesIt->second;
+}
+
+/*************/
+void ProgramCache::clear()
+{
+    lock_guard<mutex> lock(_mutex);
+    for (auto& program : _programs)
+        if (program.second != 0)
+            glDeleteProgram(program.second);
+    _programs.clear();
+    _programUsers.clear();
+    _uniformValues.clear();
+    _driverQueried = false;
+}
+
+/*************/
+GLuint ProgramCache::buildProgram(const map<GLenum, string>& sources, const vector<string>& feedbackVaryings, const string& name)
+{
+    GLuint program = glCreateProgram();
+    vector<GLuint> shaders;
+    bool status = true;
+
+    for (const auto& source : sources)
+    {
+        GLuint shader = glCreateShader(source.first);
+        const char* shaderSrc = source.second.c_str();
+        glShaderSource(shader, 1, (const GLchar**)&shaderSrc, 0);
+        glCompileShader(shader);
+
+        GLint compileStatus;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+        if (compileStatus)
+        {
+            glAttachShader(program, shader);
+            shaders.push_back(shader);
+        }
+        else
+        {
+            Log::get() << Log::WARNING << "ProgramCache::" << __FUNCTION__ << " - Error while compiling a shader of type " << stringFromShaderType(source.first) << " for program "
+                       << name << Log::endl;
+            GLint length;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            string log(length, '\0');
+            glGetShaderInfoLog(shader, length, &length, log.data());
+            Log::get() << Log::WARNING << "ProgramCache::" << __FUNCTION__ << " - Error log: \n" << log << Log::endl;
+            glDeleteShader(shader);
+            status = false;
+        }
+    }
+
+    if (status)
+    {
+        if (!feedbackVaryings.empty())
+        {
+            vector<const GLchar*> varyings;
+            for (const auto& varying : feedbackVaryings)
+                varyings.push_back(varying.c_str());
+            glTransformFeedbackVaryings(program, varyings.size(), varyings.data(), GL_SEPARATE_ATTRIBS);
+        }
+
+        if (!_cacheDirectory.empty())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+        GLint linkStatus;
+        glLinkProgram(program);
+        glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+        if (!linkStatus)
+        {
+            Log::get() << Log::WARNING << "ProgramCache::" << __FUNCTION__ << " - Error while linking the shader program " << name << Log::endl;
+            GLint length;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+            string log(length, '\0');
+            glGetProgramInfoLog(program, length, &length, log.data());
+            Log::get() << Log::WARNING << "ProgramCache::" << __FUNCTION__ << " - Error log: \n" << log << Log::endl;
+            status = false;
+        }
+#ifdef DEBUG
+        else
+        {
+            Log::get() << Log::DEBUGGING << "ProgramCache::" << __FUNCTION__ << " - Shader program " << name << " linked successfully" << Log::endl;
+        }
+#endif
+    }
+
+    // Shaders are not needed anymore once the program is linked
+    for (auto shader : shaders)
+    {
+        glDetachShader(program, shader);
+        glDeleteShader(shader);
+    }
+
+    if (!status)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+/*************/
+void ProgramCache::queryDriver()
+{
+    _driverQueried = true;
+
+    auto glString = [](GLenum name) {
+        auto value = glGetString(name);
+        return value ? string(reinterpret_cast<const char*>(value)) : string();
+    };
+    _driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount == 0 && !_cacheDirectory.empty())
+    {
+        Log::get() << Log::MESSAGE << "ProgramCache::" << __FUNCTION__ << " - The GL driver does not support program binaries, they will not be cached" << Log::endl;
+        _cacheDirectory.clear();
+    }
+}
+
+/*************/
+string ProgramCache::getBinaryPath(const string& key) const
+{
+    stringstream filename;
+    filename << hex << setw(16) << setfill('0') << hashKey(key) << ".bin";
+    return _cacheDirectory + "/" + filename.str();
+}
+
+/*************/
+GLuint ProgramCache::loadBinary(const string& key)
+{
+    if (_cacheDirectory.empty())
+        return 0;
+
+    ifstream file(getBinaryPath(key), ios::in | ios::binary);
+    if (!file.is_open())
+        return 0;
+
+    BinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return 0;
+
+    if (memcmp(header.magic, binaryMagic, sizeof(binaryMagic)) != 0 || header.version != binaryVersion)
+        return 0;
+
+    // The key is stored along the binary to rule out hash collisions
+    if (header.keySize != key.size())
+        return 0;
+    string storedKey(header.keySize, '\0');
+    if (!file.read(storedKey.data(), storedKey.size()) || storedKey != key)
+        return 0;
+
+    vector<char> binary(header.binarySize);
+    if (!file.read(binary.data(), binary.size()))
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, header.format, binary.data(), binary.size());
+
+    // The driver can reject a binary even if it matches, e.g. after an update keeping the same version string
+    GLint linkStatus;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+    if (!linkStatus)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+/*************/
+bool ProgramCache::saveBinary(const string& key, GLuint program)
+{
+    if (_cacheDirectory.empty())
+        return false;
+
+    GLint binarySize = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize == 0)
+        return false;
+
+    vector<char> binary(binarySize);
+    GLenum format;
+    glGetProgramBinary(program, binarySize, &binarySize, &format, binary.data());
+
+    error_code errorCode;
+    filesystem::create_directories(_cacheDirectory, errorCode);
+    if (errorCode)
+    {
+        Log::get() << Log::WARNING << "ProgramCache::" << __FUNCTION__ << " - Unable to create the shader cache directory " << _cacheDirectory << ", binaries will not be cached"
+                   << Log::endl;
+        _cacheDirectory.clear();
+        return false;
+    }
+
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+    header.version = binaryVersion;
+    header.format = format;
+    header.keySize = key.size();
+    header.binarySize = binarySize;
+
+    // Write to a temporary file first, as other processes may be reading the cache
+    const auto path = getBinaryPath(key);
+    const auto tmpPath = path + "." + to_string(getpid()) + ".tmp";
+    {
+        ofstream file(tmpPath, ios::out | ios::binary | ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(key.data(), key.size());
+        file.write(binary.data(), binarySize);
+        if (!file.good())
+        {
+            file.close();
+            filesystem::remove(tmpPath, errorCode);
+            return false;
+        }
+    }
+
+    filesystem::rename(tmpPath, path, errorCode);
+    if (errorCode)
+    {
+        filesystem::remove(tmpPath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+/*************/
+unordered_map<string, Values> ProgramCache::readUniformValues(GLuint program)
+{
+    unordered_map<string, Values> uniformValues;
+
+    GLint uniformCount = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    for (GLint index = 0; index < uniformCount; ++index)
+    {
+        string name(maxLength, '\0');
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, index, maxLength, &length, &size, &type, name.data());
+        name.resize(length);
+
+        // Uniforms in blocks have no location
+        GLint location = glGetUniformLocation(program, name.c_str());
+        if (location == -1)
+            continue;
+
+        // Arrays are reported by their first element, of which the value is read
+        if (auto bracket = name.find('['); bracket != string::npos)
+            name = name.substr(0, bracket);
+
+        auto readInts = [&](int count) {
+            GLint v[4];
+            glGetUniformiv(program, location, v);
+            Values values;
+            for (int i = 0; i < count; ++i)
+                values.push_back(v[i]);
+            return values;
+        };
+
+        auto readFloats = [&](int count) {
+            GLfloat v[4];
+            glGetUniformfv(program, location, v);
+            Values values;
+            for (int i = 0; i < count; ++i)
+                values.push_back(v[i]);
+            return values;
+        };
+
+        switch (type)
+        {
+        default:
+            break;
+        case GL_INT:
+            uniformValues[name] = readInts(1);
+            break;
+        case GL_INT_VEC2:
+            uniformValues[name] = readInts(2);
+            break;
+        case GL_INT_VEC3:
+            uniformValues[name] = readInts(3);
+            break;
+        case GL_INT_VEC4:
+            uniformValues[name] = readInts(4);
+            break;
+        case GL_FLOAT:
+            uniformValues[name] = readFloats(1);
+            break;
+        case GL_FLOAT_VEC2:
+            uniformValues[name] = readFloats(2);
+            break;
+        case GL_FLOAT_VEC3:
+            uniformValues[name] = readFloats(3);
+            break;
+        case GL_FLOAT_VEC4:
+            uniformValues[name] = readFloats(4);
+            break;
+        }
+    }
+
+    return uniformValues;
+}
+
+/*************/
+string ProgramCache::stringFromShaderType(GLenum type)
+{
+    switch (type)
+    {
+    default:
+        return string();
+    case GL_VERTEX_SHADER:
+        return "vertex";
+    case GL_TESS_CONTROL_SHADER:
+        return "tess_ctrl";
+    case GL_TESS_EVALUATION_SHADER:
+        return "tess_eval";
+    case GL_GEOMETRY_SHADER:
+        return "geometry";
+    case GL_FRAGMENT_SHADER:
+        return "fragment";
+    case GL_COMPUTE_SHADER:
+        return "compute";
+    }
+}
+
+} // namespace Splash
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @program_cache.h
+ * The ProgramCache class, holding the shader programs linked in this process
+ * Programs are keyed by their stage sources (defines included), so that all shaders
+ * built from the same sources share a single program. Program binaries are also
+ * stored on disk, to skip compilation on the next run with the same driver.
+ * The initial uniform values of each program are read once when it is created, as the
+ * current values of a shared program depend on which shader used it last.
+ */
+
+#ifndef SPLASH_PROGRAM_CACHE_H
+#define SPLASH_PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./config.h"
+
+#include "./core/coretypes.h"
+#include "./core/value.h"
+
+namespace Splash
+{
+
+/*************/
+class ProgramCache
+{
+  public:
+    /**
+     * \brief Get the process-wide cache
+     * \return Return the cache
+     */
+    static ProgramCache& get();
+
+    /**
+     * \brief Get a linked program for the given sources, building it if it is not cached yet
+     * This must be called from a GL context
+     * \param sources Stage sources, keyed by GL shader type (GL_VERTEX_SHADER...)
+     * \param feedbackVaryings Transform feedback varyings, if any
+     * \param name Program name, used for logging
+     * \return Return the program, or 0 if it could not be built
+     */
+    GLuint getProgram(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings, const std::string& name);
+
+    /**
+     * \brief Set the user of a program. As uniform values are part of the program state, a new user has to send all its uniforms again.
+     * \param program Program
+     * \param userId Unique id of the user
+     * \return Return true if the program was last used by another user
+     */
+    bool setUser(GLuint program, uint64_t userId);
+
+    /**
+     * \brief Get the initial values of the uniforms of a program, as set by their initializers in the sources
+     * \param program Program
+     * \return Return the values, keyed by uniform name. Only int and float scalars and vectors are included.
+     */
+    std::unordered_map<std::string, Values> getUniformValues(GLuint program);
+
+    /**
+     * \brief Delete all programs. This must be called from the GL context the programs were created in, before it is destroyed.
+     */
+    void clear();
+
+    /**
+     * \brief Get the directory holding the program binaries
+     * \return Return the directory, or an empty string if binaries are not stored
+     */
+    std::string getCacheDirectory() const { return _cacheDirectory; }
+
+  private:
+    std::mutex _mutex{};
+    std::unordered_map<std::string, GLuint> _programs{};  //!< Programs, keyed by their sources
+    std::unordered_map<GLuint, uint64_t> _programUsers{}; //!< Last user of each program
+    std::unordered_map<GLuint, std::unordered_map<std::string, Values>> _uniformValues{}; //!< Initial uniform values of each program
+
+    bool _driverQueried{false};
+    std::string _driver{};         //!< Vendor, renderer and version of the GL driver, as binaries are only valid for a given driver
+    std::string _cacheDirectory{}; //!< Directory holding the program binaries, empty if disabled
+
+    ProgramCache();
+    ProgramCache(const ProgramCache&) = delete;
+    const ProgramCache& operator=(const ProgramCache&) = delete;
+
+    /**
+     * \brief Compile and link a program
+     * \param sources Stage sources
+     * \param feedbackVaryings Transform feedback varyings
+     * \param name Program name, used for logging
+     * \return Return the program, or 0 if it failed
+     */
+    GLuint buildProgram(const std::map<GLenum, std::string>& sources, const std::vector<std::string>& feedbackVaryings, const std::string& name);
+
+    /**
+     * \brief Query the driver, which the binaries depend on. Binaries are not stored if the driver does not support any binary format.
+     */
+    void queryDriver();
+
+    /**
+     * \brief Get the path to the binary file for the given key
+     * \param key Program key, including the driver
+     * \return Return the path
+     */
+    std::string getBinaryPath(const std::string& key) const;
+
+    /**
+     * \brief Create a program from its binary stored on disk
+     * \param key Program key, including the driver
+     * \return Return the program, or 0 if no valid binary was found
+     */
+    GLuint loadBinary(const std::string& key);
+
+    /**
+     * \brief Store the binary of a linked program on disk
+     * \param key Program key, including the driver
+     * \param program Program
+     * \return Return true if the binary was written
+     */
+    bool saveBinary(const std::string& key, GLuint program);
+
+    /**
+     * \brief Read the uniform values of a program which has just been linked or loaded, before any user modifies them
+     * \param program Program
+     * \return Return the values, keyed by uniform name
+     */
+    static std::unordered_map<std::string, Values> readUniformValues(GLuint program);
+
+    /**
+     * \brief Get a string expression of the GL shader type, used for logging
+     * \param type GL shader type
+     * \return Return the shader type as a string
+     */
+    static std::string stringFromShaderType(GLenum type);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_PROGRAM_CACHE_H
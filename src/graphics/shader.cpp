@@ -1,5 +1,6 @@
 #include "./graphics/shader.h"
 
+#include <algorithm>
 #include <fstream>
 #include <regex>
 
@@ -7,6 +8,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/string_cast.hpp>
 
+#include "./graphics/program_cache.h"
 #include "./graphics/shaderSources.h"
 #include "./utils/log.h"
 #include "./utils/timer.h"
@@ -25,10 +27,6 @@ Shader::Shader(ProgramType type)
     if (type == prgGraphic)
     {
         _programType = prgGraphic;
-        _shaders[vertex] = glCreateShader(GL_VERTEX_SHADER);
-        _shaders[geometry] = glCreateShader(GL_GEOMETRY_SHADER);
-        _shaders[fragment] = glCreateShader(GL_FRAGMENT_SHADER);
-
         registerGraphicAttributes();
 
         setAttribute("fill", {"texture"});
@@ -36,8 +34,6 @@ Shader::Shader(ProgramType type)
     else if (type == prgCompute)
     {
         _programType = prgCompute;
-        _shaders[compute] = glCreateShader(GL_COMPUTE_SHADER);
-
         registerComputeAttributes();
 
         setAttribute("computePhase", {"resetVisibility"});
@@ -45,11 +41,6 @@ Shader::Shader(ProgramType type)
     else if (type == prgFeedback)
     {
         _programType = prgFeedback;
-        _shaders[vertex] = glCreateShader(GL_VERTEX_SHADER);
-        _shaders[tess_ctrl] = glCreateShader(GL_TESS_CONTROL_SHADER);
-        _shaders[tess_eval] = glCreateShader(GL_TESS_EVALUATION_SHADER);
-        _shaders[geometry] = glCreateShader(GL_GEOMETRY_SHADER);
-
         registerFeedbackAttributes();
 
         setAttribute("feedbackPhase", {"tessellateFromCamera"});
@@ -61,11 +52,9 @@ Shader::Shader(ProgramType type)
 /*************/
 Shader::~Shader()
 {
-    if (glIsProgram(_program))
-        glDeleteProgram(_program);
-    for (auto& shader : _shaders)
-        if (glIsShader(shader.second))
-            glDeleteShader(shader.second);
+    // The program belongs to the program cache, as it can be shared with other shaders
+    if (_objectBlockBuffer != 0)
+        glDeleteBuffers(1, &_objectBlockBuffer);
 
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Shader::~Shader - Destructor" << Log::endl;
@@ -88,11 +77,13 @@ void Shader::activate()
 
         for (auto& u : _uniforms)
         {
-            if (u.second.type == "buffer")
-                glUniformBlockBinding(_program, u.second.glIndex, 1);
+            if (u.second.type == UniformType::buffer)
+                glUniformBlockBinding(_program, u.second.glIndex, userBlockBinding);
         }
 
         glUseProgram(_program);
+        if (ProgramCache::get().setUser(_program, _programUserId))
+            resendUniforms();
 
         if (_sideness == singleSided)
         {
@@ -116,6 +107,8 @@ void Shader::activate()
 
         _activated = true;
         glUseProgram(_program);
+        if (ProgramCache::get().setUser(_program, _programUserId))
+            resendUniforms();
         updateUniforms();
         glEnable(GL_RASTERIZER_DISCARD);
         glBeginTransformFeedback(GL_TRIANGLES);
@@ -163,6 +156,8 @@ void Shader::doCompute(GLuint numGroupsX, GLuint numGroupsY)
 
     _activated = true;
     glUseProgram(_program);
+    if (ProgramCache::get().setUser(_program, _programUserId))
+        resendUniforms();
     updateUniforms();
     glDispatchCompute(numGroupsX, numGroupsY, 1);
     _activated = false;
@@ -180,36 +175,11 @@ map<string, Values> Shader::getUniforms() const
 /*************/
 bool Shader::setSource(const std::string& src, const ShaderType type)
 {
-    GLuint shader = _shaders[type];
-
     auto parsedSources = src;
     parseIncludes(parsedSources);
-    const char* shaderSrc = parsedSources.c_str();
-    glShaderSource(shader, 1, (const GLchar**)&shaderSrc, 0);
-    glCompileShader(shader);
-
-    GLint status;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-    if (status)
-    {
-#ifdef DEBUG
-        Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader of type " << stringFromShaderType(type) << " compiled successfully" << Log::endl;
-#endif
-    }
-    else
-    {
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while compiling a shader of type " << stringFromShaderType(type) << Log::endl;
-        GLint length;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
-        char* log = (char*)malloc(length);
-        glGetShaderInfoLog(shader, length, &length, log);
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error log: \n" << (const char*)log << Log::endl;
-        free(log);
-    }
-
     _shadersSource[type] = parsedSources;
     _isLinked = false;
-    return status;
+    return true;
 }
 
 /*************/
@@ -220,14 +190,13 @@ bool Shader::setSource(const map<ShaderType, string>& sources)
     resetShader(fragment);
     _shadersSource.clear();
 
-    bool status = true;
     if (sources.find(ShaderType::vertex) == sources.end())
-        status = setSource(ShaderSources.VERSION_DIRECTIVE_GL4 + ShaderSources.VERTEX_SHADER_DEFAULT, ShaderType::vertex);
+        setSource(ShaderSources.VERSION_DIRECTIVE_GL4 + ShaderSources.VERTEX_SHADER_DEFAULT, ShaderType::vertex);
     for (auto& source : sources)
-        status = status && setSource(source.second, source.first);
+        setSource(source.second, source.first);
 
-    compileProgram();
-    return status;
+    // Build the program right away to report errors to the caller
+    return linkProgram();
 }
 
 /*************/
@@ -284,6 +253,25 @@ void Shader::setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4
     glm::mat4 floatMp = (glm::mat4)mp;
     glm::mat4 floatMvp = (glm::mat4)(mp * mv);
 
+    // Built-in shaders get all the matrices at once through a uniform block
+    if (_hasObjectBlock)
+    {
+        if (_objectBlockBuffer == 0)
+        {
+            glCreateBuffers(1, &_objectBlockBuffer);
+            glNamedBufferStorage(_objectBlockBuffer, sizeof(ObjectBlock), nullptr, GL_DYNAMIC_STORAGE_BIT);
+        }
+
+        ObjectBlock block;
+        block.modelViewProjectionMatrix = floatMvp;
+        block.modelViewMatrix = floatMv;
+        block.projectionMatrix = floatMp;
+        block.normalMatrix = glm::transpose(glm::inverse(floatMv));
+        glNamedBufferSubData(_objectBlockBuffer, 0, sizeof(ObjectBlock), &block);
+        glBindBufferBase(GL_UNIFORM_BUFFER, objectBlockBinding, _objectBlockBuffer);
+        return;
+    }
+
     auto uniformIt = _uniforms.find("_modelViewProjectionMatrix");
     if (uniformIt != _uniforms.end())
         if (uniformIt->second.glIndex != -1)
@@ -302,63 +290,28 @@ void Shader::setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4
             glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(floatMv))));
 }
 
-/*************/
-void Shader::compileProgram()
-{
-    GLint status;
-    if (glIsProgram(_program) == GL_TRUE)
-        glDeleteProgram(_program);
-
-    _program = glCreateProgram();
-    for (auto& shader : _shaders)
-    {
-        if (glIsShader(shader.second))
-        {
-            glGetShaderiv(shader.second, GL_COMPILE_STATUS, &status);
-            if (status == GL_TRUE)
-            {
-                glAttachShader(_program, shader.second);
-#ifdef DEBUG
-                Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader of type " << stringFromShaderType(shader.first) << " successfully attached to the program"
-                           << Log::endl;
-#endif
-            }
-        }
-    }
-}
-
 /*************/
 bool Shader::linkProgram()
 {
-    GLint status;
-    glLinkProgram(_program);
-    glGetProgramiv(_program, GL_LINK_STATUS, &status);
-    if (status == GL_TRUE)
-    {
-#ifdef DEBUG
-        Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader program " << _currentProgramName << " linked successfully" << Log::endl;
-#endif
+    map<GLenum, string> sources;
+    for (const auto& source : _shadersSource)
+        sources[glShaderTypeFromShaderType(source.first)] = source.second;
 
-        for (auto src : _shadersSource)
-            parseUniforms(src.second);
-
-        _isLinked = true;
-        return true;
-    }
-    else
+    _program = ProgramCache::get().getProgram(sources, _feedbackVaryings, _currentProgramName);
+    if (_program == 0)
     {
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while linking the shader program " << _currentProgramName << Log::endl;
-
-        GLint length;
-        glGetProgramiv(_program, GL_INFO_LOG_LENGTH, &length);
-        char* log = (char*)malloc(length);
-        glGetProgramInfoLog(_program, length, &length, log);
-        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error log: \n" << (const char*)log << Log::endl;
-        free(log);
-
         _isLinked = false;
         return false;
     }
+
+    // The program may be shared with other shaders, so its current uniform values are not read back
+    const auto initialValues = ProgramCache::get().getUniformValues(_program);
+    for (auto src : _shadersSource)
+        parseUniforms(src.second, initialValues);
+    _hasObjectBlock = glGetUniformBlockIndex(_program, "_objectBlock") != GL_INVALID_INDEX;
+
+    _isLinked = true;
+    return true;
 }
 
 /*************/
@@ -399,7 +352,7 @@ void Shader::parseIncludes(std::string& src)
 }
 
 /*************/
-void Shader::parseUniforms(const std::string& src)
+void Shader::parseUniforms(const std::string& src, const unordered_map<string, Values>& initialValues)
 {
     istringstream input(src);
     for (string line; getline(input, line);)
@@ -416,7 +369,7 @@ void Shader::parseUniforms(const std::string& src)
             string next = line.substr(position + 23, string::npos);
             string name = next.substr(0, next.find(" "));
 
-            _uniforms[name].type = "buffer";
+            _uniforms[name].type = UniformType::buffer;
             _uniforms[name].glIndex = glGetUniformBlockIndex(_program, name.c_str());
             glGenBuffers(1, &_uniforms[name].glBuffer);
             _uniforms[name].glBufferReady = false;
@@ -469,76 +422,63 @@ void Shader::parseUniforms(const std::string& src)
                 continue;
             }
 
-            _uniforms[name].type = type;
-            _uniforms[name].glIndex = glGetUniformLocation(_program, name.c_str());
-            _uniforms[name].elementSize = type.find("mat") != string::npos ? elementSize * elementSize : elementSize;
-            _uniforms[name].arraySize = arraySize;
+            auto& uniform = _uniforms[name];
+            uniform.type = uniformTypeFromString(type);
+            uniform.glIndex = glGetUniformLocation(_program, name.c_str());
+            uniform.elementSize = type.find("mat") != string::npos ? elementSize * elementSize : elementSize;
+            uniform.arraySize = arraySize;
             _uniformsDocumentation[name] = documentation;
 
-            if (type == "int")
-            {
-                int v;
-                glGetUniformiv(_program, _uniforms[name].glIndex, &v);
-                _uniforms[name].values = {v};
-            }
-            else if (type == "float")
-            {
-                float v;
-                glGetUniformfv(_program, _uniforms[name].glIndex, &v);
-                _uniforms[name].values = {v};
-            }
-            else if (type == "vec2")
-            {
-                float v[2];
-                glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1]};
-            }
-            else if (type == "vec3")
-            {
-                float v[3];
-                glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2]};
-            }
-            else if (type == "vec4")
-            {
-                float v[4];
-                glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2], v[3]};
-            }
-            else if (type == "ivec2")
-            {
-                int v[2];
-                glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1]};
-            }
-            else if (type == "ivec3")
-            {
-                int v[3];
-                glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2]};
-            }
-            else if (type == "ivec4")
-            {
-                int v[4];
-                glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                _uniforms[name].values = {v[0], v[1], v[2], v[3]};
-            }
-            else if (type == "mat3")
-            {
-                _uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-            }
-            else if (type == "mat4")
-            {
-                _uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-            }
-            else if (type.find("sampler") != string::npos)
-            {
-                _uniforms[name].values = {};
-            }
-            else
-            {
-                _uniforms[name].glIndex = -1;
+            // Uniforms without an initial value, e.g. inactive ones, default to zero
+            auto valuesIt = initialValues.find(name);
+            auto initialValue = [&](auto zero, uint32_t size) {
+                if (valuesIt != initialValues.end() && valuesIt->second.size() == size)
+                    return valuesIt->second;
+                Values values;
+                for (uint32_t i = 0; i < size; ++i)
+                    values.push_back(zero);
+                return values;
+            };
+
+            switch (uniform.type)
+            {
+            case UniformType::int1:
+                uniform.values = initialValue(0, 1);
+                break;
+            case UniformType::float1:
+                uniform.values = initialValue(0.f, 1);
+                break;
+            case UniformType::vec2:
+                uniform.values = initialValue(0.f, 2);
+                break;
+            case UniformType::vec3:
+                uniform.values = initialValue(0.f, 3);
+                break;
+            case UniformType::vec4:
+                uniform.values = initialValue(0.f, 4);
+                break;
+            case UniformType::ivec2:
+                uniform.values = initialValue(0, 2);
+                break;
+            case UniformType::ivec3:
+                uniform.values = initialValue(0, 3);
+                break;
+            case UniformType::ivec4:
+                uniform.values = initialValue(0, 4);
+                break;
+            case UniformType::mat3:
+                uniform.values = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+                break;
+            case UniformType::mat4:
+                uniform.values = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+                break;
+            case UniformType::sampler:
+                uniform.values = {};
+                break;
+            default:
+                uniform.glIndex = -1;
                 Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while parsing uniforms: " << name << " is of unhandled type " << type << Log::endl;
+                break;
             }
         }
     }
@@ -547,7 +487,7 @@ void Shader::parseUniforms(const std::string& src)
     for (auto& u : _uniforms)
     {
         string name = u.first;
-        if (u.second.type != "buffer")
+        if (u.second.type != UniformType::buffer)
         {
             if (glGetUniformLocation(_program, name.c_str()) == -1)
                 u.second.glIndex = -1;
@@ -561,24 +501,58 @@ void Shader::parseUniforms(const std::string& src)
 }
 
 /*************/
-string Shader::stringFromShaderType(int type)
+Shader::UniformType Shader::uniformTypeFromString(const string& type)
+{
+    static const unordered_map<string, UniformType> types{{"int", UniformType::int1},
+        {"ivec2", UniformType::ivec2},
+        {"ivec3", UniformType::ivec3},
+        {"ivec4", UniformType::ivec4},
+        {"float", UniformType::float1},
+        {"vec2", UniformType::vec2},
+        {"vec3", UniformType::vec3},
+        {"vec4", UniformType::vec4},
+        {"mat3", UniformType::mat3},
+        {"mat4", UniformType::mat4}};
+
+    auto typeIt = types.find(type);
+    if (typeIt != types.end())
+        return typeIt->second;
+    if (type.find("sampler") != string::npos)
+        return UniformType::sampler;
+    return UniformType::unknown;
+}
+
+/*************/
+GLenum Shader::glShaderTypeFromShaderType(int type)
 {
     switch (type)
     {
     default:
-        return string();
     case vertex:
-        return "vertex";
+        return GL_VERTEX_SHADER;
     case tess_ctrl:
-        return "tess_ctrl";
+        return GL_TESS_CONTROL_SHADER;
     case tess_eval:
-        return "tess_eval";
+        return GL_TESS_EVALUATION_SHADER;
     case geometry:
-        return "geometry";
+        return GL_GEOMETRY_SHADER;
     case fragment:
-        return "fragment";
+        return GL_FRAGMENT_SHADER;
     case compute:
-        return "compute";
+        return GL_COMPUTE_SHADER;
+    }
+}
+
+/*************/
+void Shader::resendUniforms()
+{
+    for (const auto& u : _uniforms)
+    {
+        if (u.second.glIndex == -1 || u.second.values.empty())
+            continue;
+        if (u.second.type == UniformType::sampler || u.second.type == UniformType::unknown)
+            continue;
+        _uniformsToUpdate.push_back(u.first);
     }
 }
 
@@ -589,7 +563,7 @@ void Shader::updateUniforms()
     {
         for (uint32_t i = 0; i < _uniformsToUpdate.size(); ++i)
         {
-            string u = _uniformsToUpdate[i];
+            const auto& u = _uniformsToUpdate[i];
 
             auto uniformIt = _uniforms.find(u);
             if (uniformIt == _uniforms.end())
@@ -602,106 +576,139 @@ void Shader::updateUniforms()
                 continue;
             }
 
-            auto type = uniform.type;
-            assert(!type.empty());
+            if (uniform.type == UniformType::buffer)
+            {
+                if (uniform.values.empty())
+                    continue;
 
-            if (uniform.arraySize == 0)
+                // Blocks hold either integers or floats, as told by their first value
+                vector<int> intData;
+                vector<float> floatData;
+                const void* data = nullptr;
+                size_t dataSize = 0;
+                if (uniform.values[0].getType() == Value::Type::integer)
+                {
+                    for (auto& v : uniform.values)
+                        intData.push_back(v.as<int>());
+                    data = intData.data();
+                    dataSize = intData.size() * sizeof(int);
+                }
+                else
+                {
+                    for (auto& v : uniform.values)
+                        floatData.push_back(v.as<float>());
+                    data = floatData.data();
+                    dataSize = floatData.size() * sizeof(float);
+                }
+
+                glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
+                if (!uniform.glBufferReady)
+                {
+                    glBufferData(GL_UNIFORM_BUFFER, dataSize, NULL, GL_STATIC_DRAW);
+                    uniform.glBufferReady = true;
+                }
+                glBufferSubData(GL_UNIFORM_BUFFER, 0, dataSize, data);
+                glBindBuffer(GL_UNIFORM_BUFFER, 0);
+                glBindBufferRange(GL_UNIFORM_BUFFER, userBlockBinding, uniform.glBuffer, 0, dataSize);
+            }
+            else if (uniform.arraySize == 0)
             {
                 if (uniform.elementSize != uniform.values.size())
                     continue;
 
-                if (type == "int")
-                    glUniform1i(uniform.glIndex, uniform.values[0].as<int>());
-                else if (type == "ivec2")
-                    glUniform2i(uniform.glIndex, uniform.values[0].as<int>(), uniform.values[1].as<int>());
-                else if (type == "ivec3")
-                    glUniform3i(uniform.glIndex, uniform.values[0].as<int>(), uniform.values[1].as<int>(), uniform.values[2].as<int>());
-                else if (type == "ivec4")
-                    glUniform4i(uniform.glIndex, uniform.values[0].as<int>(), uniform.values[1].as<int>(), uniform.values[2].as<int>(), uniform.values[3].as<int>());
-                else if (type == "float")
-                    glUniform1f(uniform.glIndex, uniform.values[0].as<float>());
-                else if (type == "vec2")
-                    glUniform2f(uniform.glIndex, uniform.values[0].as<float>(), uniform.values[1].as<float>());
-                else if (type == "vec3")
-                    glUniform3f(uniform.glIndex, uniform.values[0].as<float>(), uniform.values[1].as<float>(), uniform.values[2].as<float>());
-                else if (type == "vec4")
-                    glUniform4f(uniform.glIndex, uniform.values[0].as<float>(), uniform.values[1].as<float>(), uniform.values[2].as<float>(), uniform.values[3].as<float>());
-                else if (type == "mat3")
+                const auto& values = uniform.values;
+                switch (uniform.type)
+                {
+                case UniformType::int1:
+                    glUniform1i(uniform.glIndex, values[0].as<int>());
+                    break;
+                case UniformType::ivec2:
+                    glUniform2i(uniform.glIndex, values[0].as<int>(), values[1].as<int>());
+                    break;
+                case UniformType::ivec3:
+                    glUniform3i(uniform.glIndex, values[0].as<int>(), values[1].as<int>(), values[2].as<int>());
+                    break;
+                case UniformType::ivec4:
+                    glUniform4i(uniform.glIndex, values[0].as<int>(), values[1].as<int>(), values[2].as<int>(), values[3].as<int>());
+                    break;
+                case UniformType::float1:
+                    glUniform1f(uniform.glIndex, values[0].as<float>());
+                    break;
+                case UniformType::vec2:
+                    glUniform2f(uniform.glIndex, values[0].as<float>(), values[1].as<float>());
+                    break;
+                case UniformType::vec3:
+                    glUniform3f(uniform.glIndex, values[0].as<float>(), values[1].as<float>(), values[2].as<float>());
+                    break;
+                case UniformType::vec4:
+                    glUniform4f(uniform.glIndex, values[0].as<float>(), values[1].as<float>(), values[2].as<float>(), values[3].as<float>());
+                    break;
+                case UniformType::mat3:
                 {
-                    vector<float> m(9);
+                    float m[9];
                     for (unsigned int i = 0; i < 9; ++i)
-                        m[i] = uniform.values[i].as<float>();
-                    glUniformMatrix3fv(uniform.glIndex, 1, GL_FALSE, m.data());
+                        m[i] = values[i].as<float>();
+                    glUniformMatrix3fv(uniform.glIndex, 1, GL_FALSE, m);
+                    break;
                 }
-                else if (type == "mat4")
+                case UniformType::mat4:
                 {
-                    vector<float> m(16);
+                    float m[16];
                     for (unsigned int i = 0; i < 16; ++i)
-                        m[i] = uniform.values[i].as<float>();
-                    glUniformMatrix4fv(uniform.glIndex, 1, GL_FALSE, m.data());
+                        m[i] = values[i].as<float>();
+                    glUniformMatrix4fv(uniform.glIndex, 1, GL_FALSE, m);
+                    break;
+                }
+                default:
+                    break;
                 }
             }
             else
             {
-                if (type == "int" || type.find("ivec") != string::npos)
+                switch (uniform.type)
+                {
+                case UniformType::int1:
+                case UniformType::ivec2:
+                case UniformType::ivec3:
+                case UniformType::ivec4:
                 {
                     vector<int> data;
+                    data.reserve(uniform.values.size());
                     for (auto& v : uniform.values)
                         data.push_back(v.as<int>());
 
-                    if (uniform.type == "buffer")
-                    {
-                        glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
-                        if (!uniform.glBufferReady)
-                        {
-                            glBufferData(GL_UNIFORM_BUFFER, data.size() * sizeof(int), NULL, GL_STATIC_DRAW);
-                            uniform.glBufferReady = true;
-                        }
-                        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(int), data.data());
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                        glBindBufferRange(GL_UNIFORM_BUFFER, 1, uniform.glBuffer, 0, data.size() * sizeof(int));
-                    }
+                    if (uniform.type == UniformType::int1)
+                        glUniform1iv(uniform.glIndex, data.size(), data.data());
+                    else if (uniform.type == UniformType::ivec2)
+                        glUniform2iv(uniform.glIndex, data.size() / 2, data.data());
+                    else if (uniform.type == UniformType::ivec3)
+                        glUniform3iv(uniform.glIndex, data.size() / 3, data.data());
                     else
-                    {
-                        if (uniform.type == "int")
-                            glUniform1iv(uniform.glIndex, data.size(), data.data());
-                        else if (uniform.type == "ivec2")
-                            glUniform2iv(uniform.glIndex, data.size() / 2, data.data());
-                        else if (uniform.type == "ivec3")
-                            glUniform3iv(uniform.glIndex, data.size() / 3, data.data());
-                        else if (uniform.type == "ivec4")
-                            glUniform4iv(uniform.glIndex, data.size() / 4, data.data());
-                    }
+                        glUniform4iv(uniform.glIndex, data.size() / 4, data.data());
+                    break;
                 }
-                else if (type == "float" || type.find("vec") != string::npos)
+                case UniformType::float1:
+                case UniformType::vec2:
+                case UniformType::vec3:
+                case UniformType::vec4:
                 {
                     vector<float> data;
+                    data.reserve(uniform.values.size());
                     for (auto& v : uniform.values)
                         data.push_back(v.as<float>());
 
-                    if (uniform.type == "buffer")
-                    {
-                        glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
-                        if (!uniform.glBufferReady)
-                        {
-                            glBufferData(GL_UNIFORM_BUFFER, data.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-                            uniform.glBufferReady = true;
-                        }
-                        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(float), data.data());
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                        glBindBufferRange(GL_UNIFORM_BUFFER, 1, uniform.glBuffer, 0, data.size() * sizeof(float));
-                    }
+                    if (uniform.type == UniformType::float1)
+                        glUniform1fv(uniform.glIndex, data.size(), data.data());
+                    else if (uniform.type == UniformType::vec2)
+                        glUniform2fv(uniform.glIndex, data.size() / 2, data.data());
+                    else if (uniform.type == UniformType::vec3)
+                        glUniform3fv(uniform.glIndex, data.size() / 3, data.data());
                     else
-                    {
-                        if (uniform.type == "float")
-                            glUniform1fv(uniform.glIndex, data.size(), data.data());
-                        else if (uniform.type == "vec2")
-                            glUniform2fv(uniform.glIndex, data.size() / 2, data.data());
-                        else if (uniform.type == "vec3")
-                            glUniform3fv(uniform.glIndex, data.size() / 3, data.data());
-                        else if (uniform.type == "vec4")
-                            glUniform4fv(uniform.glIndex, data.size() / 4, data.data());
-                    }
+                        glUniform4fv(uniform.glIndex, data.size() / 4, data.data());
+                    break;
+                }
+                default:
+                    break;
                 }
             }
         }
@@ -713,16 +720,8 @@ void Shader::updateUniforms()
 /*************/
 void Shader::resetShader(ShaderType type)
 {
-    glDeleteShader(_shaders[type]);
-
-    if (type == vertex)
-        _shaders[type] = glCreateShader(GL_VERTEX_SHADER);
-    else if (type == geometry)
-        _shaders[type] = glCreateShader(GL_GEOMETRY_SHADER);
-    else if (type == fragment)
-        _shaders[type] = glCreateShader(GL_FRAGMENT_SHADER);
-    else
-        return;
+    _shadersSource.erase(type);
+    _isLinked = false;
 }
 
 /*************/
@@ -775,9 +774,12 @@ void Shader::registerGraphicAttributes()
                 _fill = texture;
                 _shaderOptions = options;
                 setSource(options + ShaderSources.VERTEX_SHADER_TEXTURE, vertex);
-                resetShader(geometry);
+                // Multiview rendering replicates the primitives for each view in the geometry stage
+                if (find(args.begin() + 1, args.end(), Value("MULTIVIEW")) != args.end())
+                    setSource(options + ShaderSources.GEOMETRY_SHADER_TEXTURE_MULTIVIEW, geometry);
+                else
+                    resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_TEXTURE, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "object_cubemap" && (_fill != object_cubemap || _shaderOptions != options))
             {
@@ -787,7 +789,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_OBJECT_CUBEMAP, vertex);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_OBJECT_CUBEMAP, geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_OBJECT_CUBEMAP, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "cubemap_projection" && (_fill != cubemap_projection || _shaderOptions != options))
             {
@@ -797,7 +798,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_CUBEMAP_PROJECTION, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_CUBEMAP_PROJECTION, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "filter" && (_fill != filter || _shaderOptions != options))
             {
@@ -807,7 +807,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_FILTER, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_FILTER, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "color" && (_fill != color || _shaderOptions != options))
             {
@@ -817,7 +816,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_MODELVIEW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_COLOR, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "primitiveId" && (_fill != primitiveId || _shaderOptions != options))
             {
@@ -827,7 +825,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_MODELVIEW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_PRIMITIVEID, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "userDefined" && (_fill != userDefined || _shaderOptions != options))
             {
@@ -839,7 +836,6 @@ void Shader::registerGraphicAttributes()
                 resetShader(geometry);
                 if (_shadersSource.find(ShaderType::fragment) == _shadersSource.end())
                     setSource(options + ShaderSources.FRAGMENT_SHADER_FILTER, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "uv" && (_fill != uv || _shaderOptions != options))
             {
@@ -849,7 +845,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_MODELVIEW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_UV, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "warp" && (_fill != warp || _shaderOptions != options))
             {
@@ -859,7 +854,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WARP, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WARP, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "warpControl" && (_fill != warpControl || _shaderOptions != options))
             {
@@ -869,7 +863,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WARP_WIREFRAME, vertex);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_WARP_WIREFRAME, geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WARP_WIREFRAME, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "wireframe" && (_fill != wireframe || _shaderOptions != options))
             {
@@ -879,7 +872,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WIREFRAME, vertex);
                 setSource(options + ShaderSources.GEOMETRY_SHADER_WIREFRAME, geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WIREFRAME, fragment);
-                compileProgram();
             }
             else if (args[0].as<string>() == "window" && (_fill != window || _shaderOptions != options))
             {
@@ -889,7 +881,6 @@ void Shader::registerGraphicAttributes()
                 setSource(options + ShaderSources.VERTEX_SHADER_WINDOW, vertex);
                 resetShader(geometry);
                 setSource(options + ShaderSources.FRAGMENT_SHADER_WINDOW, fragment);
-                compileProgram();
             }
             return true;
         },
@@ -938,25 +929,21 @@ void Shader::registerComputeAttributes()
         {
             _currentProgramName = args[0].as<string>();
             setSource(options + ShaderSources.COMPUTE_SHADER_RESET_VISIBILITY, compute);
-            compileProgram();
         }
         else if ("resetBlending" == args[0].as<string>())
         {
             _currentProgramName = args[0].as<string>();
             setSource(options + ShaderSources.COMPUTE_SHADER_RESET_BLENDING, compute);
-            compileProgram();
         }
         else if ("computeCameraContribution" == args[0].as<string>())
         {
             _currentProgramName = args[0].as<string>();
             setSource(options + ShaderSources.COMPUTE_SHADER_COMPUTE_CAMERA_CONTRIBUTION, compute);
-            compileProgram();
         }
         else if ("transferVisibilityToAttr" == args[0].as<string>())
         {
             _currentProgramName = args[0].as<string>();
             setSource(options + ShaderSources.COMPUTE_SHADER_TRANSFER_VISIBILITY_TO_ATTR, compute);
-            compileProgram();
         }
 
         return true;
@@ -984,7 +971,6 @@ void Shader::registerFeedbackAttributes()
             setSource(options + ShaderSources.TESS_CTRL_SHADER_FEEDBACK_TESSELLATE_FROM_CAMERA, tess_ctrl);
             setSource(options + ShaderSources.TESS_EVAL_SHADER_FEEDBACK_TESSELLATE_FROM_CAMERA, tess_eval);
             setSource(options + ShaderSources.GEOMETRY_SHADER_FEEDBACK_TESSELLATE_FROM_CAMERA, geometry);
-            compileProgram();
         }
 
         return true;
@@ -994,19 +980,11 @@ void Shader::registerFeedbackAttributes()
         if (args.size() < 1)
             return false;
 
-        GLchar* feedbackVaryings[args.size()];
-        vector<string> varyingNames;
-        for (uint32_t i = 0; i < args.size(); ++i)
-        {
-            varyingNames.push_back(args[i].as<string>());
-            feedbackVaryings[i] = new GLchar[256];
-            strcpy(feedbackVaryings[i], varyingNames[i].c_str());
-        }
-
-        glTransformFeedbackVaryings(_program, args.size(), const_cast<const GLchar**>(feedbackVaryings), GL_SEPARATE_ATTRIBS);
-
-        for (uint32_t i = 0; i < args.size(); ++i)
-            delete feedbackVaryings[i];
+        // Varyings are set before linking, they are part of the program
+        _feedbackVaryings.clear();
+        for (const auto& arg : args)
+            _feedbackVaryings.push_back(arg.as<string>());
+        _isLinked = false;
 
         return true;
     });
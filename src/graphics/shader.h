@@ -69,6 +69,14 @@ class Shader : public GraphObject
         inverted
     };
 
+    // Binding points of the uniform blocks
+    enum UniformBlockBinding : GLuint
+    {
+        userBlockBinding = 1,   // Blocks declared by the shaders, set through the uniform attribute
+        cameraBlockBinding = 2, // Camera-wide state, bound by the camera being rendered
+        objectBlockBinding = 3  // Object matrices, bound by setModelViewProjectionMatrix
+    };
+
     enum Fill
     {
         texture = 0,
@@ -145,17 +153,17 @@ class Shader : public GraphObject
     std::unordered_map<std::string, std::string> getUniformsDocumentation() const { return _uniformsDocumentation; }
 
     /**
-     * \brief Set a shader source
+     * \brief Set a shader source. The program is built, or taken from the program cache, on next activation.
      * \param src Shader string
      * \param type Shader type
-     * \return Return true if the shader was compiled successfully
+     * \return Return true if the source was set
      */
     bool setSource(const std::string& src, const ShaderType type);
 
     /**
-     * \brief Set multiple shaders at once
+     * \brief Set multiple shaders at once, and build the program
      * \param sources Map of shader sources
-     * \return Return true if all shader could be compiled
+     * \return Return true if the program could be built
      */
     bool setSource(const std::map<ShaderType, std::string>& sources);
 
@@ -163,7 +171,7 @@ class Shader : public GraphObject
      * \brief Set a shader source from file
      * \param filename Shader file
      * \param type Shader type
-     * \return Return true if the shader was compiled successfully
+     * \return Return true if the source was set
      */
     bool setSourceFromFile(const std::string& filename, const ShaderType type);
 
@@ -192,14 +200,34 @@ class Shader : public GraphObject
     std::atomic_bool _activated{false};
     ProgramType _programType{prgGraphic};
 
-    std::unordered_map<int, GLuint> _shaders;
     std::unordered_map<int, std::string> _shadersSource;
-    GLuint _program{0};
+    std::vector<std::string> _feedbackVaryings{};
+    GLuint _program{0}; //!< Program from the program cache, possibly shared with other shaders
     bool _isLinked = {false};
 
+    static inline std::atomic<uint64_t> _nextProgramUserId{1};
+    const uint64_t _programUserId{_nextProgramUserId++}; //!< Id of this shader as a program user
+
+    enum class UniformType
+    {
+        unknown,
+        int1,
+        ivec2,
+        ivec3,
+        ivec4,
+        float1,
+        vec2,
+        vec3,
+        vec4,
+        mat3,
+        mat4,
+        sampler,
+        buffer
+    };
+
     struct Uniform
     {
-        std::string type{""};
+        UniformType type{UniformType::unknown};
         uint32_t elementSize{1};
         uint32_t arraySize{0};
         Values values{};
@@ -213,18 +241,25 @@ class Shader : public GraphObject
     std::vector<std::shared_ptr<Texture>> _textures; // Currently used textures
     std::string _currentProgramName{};
 
+    // Object matrices, sent as a uniform block if the program declares it
+    struct ObjectBlock
+    {
+        glm::mat4 modelViewProjectionMatrix;
+        glm::mat4 modelViewMatrix;
+        glm::mat4 projectionMatrix;
+        glm::mat4 normalMatrix;
+    };
+    GLuint _objectBlockBuffer{0};
+    bool _hasObjectBlock{false};
+
     // Rendering parameters
     Fill _fill{texture};
     std::string _shaderOptions{""};
     Sideness _sideness{doubleSided};
 
     /**
-     * \brief Compile the shader program
-     */
-    void compileProgram();
-
-    /**
-     * \brief Link the shader program
+     * \brief Get the program for the current sources from the program cache, and parse its uniforms
+     * \return Return true if the program is usable
      */
     bool linkProgram();
 
@@ -236,18 +271,32 @@ class Shader : public GraphObject
 
     /**
      * \brief Parses the shader to find uniforms
+     * \param src Shader source
+     * \param initialValues Initial uniform values of the program, as given by the ProgramCache
+     */
+    void parseUniforms(const std::string& src, const std::unordered_map<std::string, Values>& initialValues);
+
+    /**
+     * \brief Get the uniform type from its GLSL name
+     * \param type GLSL type
+     * \return Return the uniform type
      */
-    void parseUniforms(const std::string& src);
+    static UniformType uniformTypeFromString(const std::string& type);
 
     /**
-     * \brief Get a string expression of the shader type, used for logging
+     * \brief Get the GL shader type from the shader type
      * \param type Shader type
-     * \return Return the shader type as a string
+     * \return Return the GL shader type
+     */
+    static GLenum glShaderTypeFromShaderType(int type);
+
+    /**
+     * \brief Queue all uniforms for update, as the program was used by another shader since last activation
      */
-    std::string stringFromShaderType(int type);
+    void resendUniforms();
 
     /**
-     * \brief Replace a shader with an empty one
+     * \brief Remove the source of a shader stage
      * \param type Shader type
      */
     void resetShader(ShaderType type);
@@ -165,6 +165,61 @@ struct ShaderSources
                 }
                 return color;
             }
+        )"},
+        //
+        // Camera-wide state, uploaded once per camera and per frame. Layout must match Camera::CameraBlock
+        // With multiview rendering, the state of all views is read from a storage buffer, indexed by the layer
+        // being rendered. Layout must match MultiviewRenderer::View
+        {"cameraBlock", R"(
+        #ifdef MULTIVIEW
+            struct CameraView
+            {
+                mat4 viewProjectionMatrix;
+                mat4 viewNormalMatrix;
+                vec4 cameraAttributes;
+                vec4 fovAndColorBalance;
+                vec4 wireframeColor;
+                int showCameraCount;
+                int isColorLUT;
+                mat3 colorMixMatrix;
+                vec4 colorLUT[256];
+            };
+
+            layout(std430, binding = 2) readonly buffer _cameraViews
+            {
+                CameraView _views[];
+            };
+
+            #define _cameraAttributes _views[gl_Layer].cameraAttributes
+            #define _fovAndColorBalance _views[gl_Layer].fovAndColorBalance
+            #define _wireframeColor _views[gl_Layer].wireframeColor
+            #define _showCameraCount _views[gl_Layer].showCameraCount
+            #define _isColorLUT _views[gl_Layer].isColorLUT
+            #define _colorMixMatrix _views[gl_Layer].colorMixMatrix
+            #define _colorLUT _views[gl_Layer].colorLUT
+        #else
+            layout(std140, binding = 2) uniform _cameraBlock
+            {
+                vec4 _cameraAttributes; // blendWidth, brightness, saturation, contrast
+                vec4 _fovAndColorBalance; // fovX and fovY, r/g and b/g
+                vec4 _wireframeColor;
+                int _showCameraCount;
+                int _isColorLUT;
+                mat3 _colorMixMatrix;
+                vec4 _colorLUT[256]; // Only rgb is used, vec3 arrays being padded to vec4 anyway
+            };
+        #endif
+        )"},
+        //
+        // Object matrices, uploaded by Shader::setModelViewProjectionMatrix. Layout must match Shader::ObjectBlock
+        {"objectBlock", R"(
+            layout(std140, binding = 3) uniform _objectBlock
+            {
+                mat4 _modelViewProjectionMatrix;
+                mat4 _modelViewMatrix;
+                mat4 _projectionMatrix;
+                mat4 _normalMatrix;
+            };
         )"}};
 
     /**
@@ -792,16 +847,13 @@ struct ShaderSources
      */
     const std::string VERTEX_SHADER_MODELVIEW{R"(
         #include getSmoothBlendFromVertex
+        #include objectBlock
 
         layout(location = 0) in vec4 _vertex;
         layout(location = 1) in vec2 _texCoord;
         layout(location = 2) in vec4 _normal;
         layout(location = 3) in vec4 _annexe;
 
-        uniform mat4 _modelViewProjectionMatrix;
-        uniform mat4 _normalMatrix;
-        uniform vec4 _cameraAttributes = vec4(0.05, 1.0, 1.0, 1.0); // blendWidth, brightness, saturation, contrast
-
         out VertexData
         {
             vec4 position;
@@ -861,7 +913,7 @@ struct ShaderSources
         uniform int _tex0_flop = 0;
         // Format specific parameters
         uniform int _tex0_YCoCg = 0;
-        uniform int _tex0_YUV = 0; // 1 = UYVY, 2 = YUYV
+        uniform int _tex0_YUV = 0; // 1 = UYVY, 2 = YUYV, 3 = NV12 or P010, 4 = I420
 
         // Film uniforms
         uniform float _filmDuration = 0.f;
@@ -931,7 +983,7 @@ struct ShaderSources
             }
 
             // If the color format is YUYV
-            if (_tex0_YUV > 0)
+            if (_tex0_YUV == 1 || _tex0_YUV == 2)
             {
                 // Texture coord rounded to the closer even pixel
                 ivec2 yuyvCoords = ivec2((int(realCoords.x * _tex0_size.x) / 2) * 2, int(realCoords.y * _tex0_size.y));
@@ -947,6 +999,34 @@ struct ShaderSources
                 else // Odd pixel
                     color.rgb = yuv2rgb(yuyv.bga);
             }
+            // If the color format is planar, the planes are stacked in a single channel texture
+            else if (_tex0_YUV > 2)
+            {
+                ivec2 size = ivec2(_tex0_size);
+                ivec2 pixel = clamp(ivec2(realCoords * _tex0_size), ivec2(0), size - ivec2(1));
+                ivec2 chroma = pixel / 2;
+
+                // Chroma samples are addressed linearly, as a chroma plane row does not match a texture row
+                int chromaIndex;
+                int chromaStride;
+                if (_tex0_YUV == 3) // Interleaved chroma plane
+                {
+                    chromaIndex = size.x * size.y + chroma.y * size.x + chroma.x * 2;
+                    chromaStride = 1;
+                }
+                else // Separate chroma planes
+                {
+                    chromaIndex = size.x * size.y + chroma.y * (size.x / 2) + chroma.x;
+                    chromaStride = (size.x / 2) * (size.y / 2);
+                }
+
+                vec3 yuv;
+                yuv.r = texelFetch(_tex0, pixel, 0).r;
+                yuv.g = texelFetch(_tex0, ivec2(chromaIndex % size.x, chromaIndex / size.x), 0).r;
+                chromaIndex += chromaStride;
+                yuv.b = texelFetch(_tex0, ivec2(chromaIndex % size.x, chromaIndex / size.x), 0).r;
+                color = vec4(yuv2rgb(yuv), 1.0);
+            }
             
             // Invert channels
             if (_invertChannels == 1)
@@ -1062,6 +1142,7 @@ struct ShaderSources
      */
     const std::string VERTEX_SHADER_OBJECT_CUBEMAP{R"(
         #include getSmoothBlendFromVertex
+        #include objectBlock
 
         layout(location = 0) in vec4 _vertex;
         layout(location = 1) in vec2 _texCoord;
@@ -1072,8 +1153,6 @@ struct ShaderSources
             vec2 texCoord;
         } vertexOut;
 
-        uniform mat4 _modelViewMatrix;
-
         void main(void)
         {
             vertexOut.position = vec4(_vertex.xyz, 1.0);
@@ -1084,6 +1163,8 @@ struct ShaderSources
     )"};
 
     const std::string GEOMETRY_SHADER_OBJECT_CUBEMAP{R"(
+        #include objectBlock
+
         layout(triangles) in;
         layout(triangle_strip, max_vertices = 18) out;
 
@@ -1099,8 +1180,6 @@ struct ShaderSources
             vec2 texCoord;
         } vertexOut;
 
-        uniform mat4 _projectionMatrix;
-
         const mat4 cubemapMat[6] = mat4[](
             mat4(1.0, 0.0, 0.0, 0.0,
                  0.0, 1.0, 0.0, 0.0,
@@ -1180,16 +1259,14 @@ struct ShaderSources
      */
     const std::string VERTEX_SHADER_TEXTURE{R"(
         #include getSmoothBlendFromVertex
+        #include cameraBlock
+        #include objectBlock
 
         layout(location = 0) in vec4 _vertex;
         layout(location = 1) in vec2 _texCoord;
         layout(location = 2) in vec4 _normal;
         layout(location = 3) in vec4 _annexe;
 
-        uniform mat4 _modelViewProjectionMatrix;
-        uniform mat4 _normalMatrix;
-        uniform vec4 _cameraAttributes = vec4(0.05, 1.0, 1.0, 1.0); // blendWidth, brightness, saturation, contrast
-
         out VertexData
         {
             vec4 position;
@@ -1201,6 +1278,15 @@ struct ShaderSources
 
         void main(void)
         {
+        #ifdef MULTIVIEW
+            // Views are projected in the geometry stage, the object matrices only hold the model transformation
+            vertexOut.position = _modelViewMatrix * vec4(_vertex.xyz, 1.0);
+            gl_Position = vertexOut.position;
+            vertexOut.normal = _normalMatrix * _normal;
+            vertexOut.texCoord = _texCoord;
+            vertexOut.annexe = _annexe;
+            vertexOut.blendingValue = 1.0;
+        #else
             vertexOut.position = vec4(_vertex.xyz, 1.0);
             vertexOut.position = _modelViewProjectionMatrix * vertexOut.position;
             gl_Position = vertexOut.position;
@@ -1216,6 +1302,78 @@ struct ShaderSources
                 else
                     vertexOut.blendingValue = min(1.0, getSmoothBlendFromVertex(projectedVertex, _cameraAttributes.x) / _annexe.y);
             }
+        #endif
+        }
+    )"};
+
+    /**
+     * Geometry shader for textured multiview rendering
+     * Each invocation projects the primitive for one view, into the layer of the same index
+     */
+    const std::string GEOMETRY_SHADER_TEXTURE_MULTIVIEW{R"(
+        #include getSmoothBlendFromVertex
+        #include cameraBlock
+
+        layout(triangles, invocations = VIEW_COUNT) in;
+        layout(triangle_strip, max_vertices = 3) out;
+
+        in VertexData
+        {
+            vec4 position;
+            vec2 texCoord;
+            vec4 normal;
+            vec4 annexe;
+            float blendingValue;
+        } vertexIn[];
+
+        out VertexData
+        {
+            vec4 position;
+            vec2 texCoord;
+            vec4 normal;
+            vec4 annexe;
+            float blendingValue;
+        } vertexOut;
+
+        void main()
+        {
+            int view = gl_InvocationID;
+
+            vec4 positions[3];
+            for (int i = 0; i < 3; ++i)
+                positions[i] = _views[view].viewProjectionMatrix * vertexIn[i].position;
+
+            // Skip the primitives lying entirely outside one of the frustum planes of this view
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (positions[0][axis] > positions[0].w && positions[1][axis] > positions[1].w && positions[2][axis] > positions[2].w)
+                    return;
+                if (positions[0][axis] < -positions[0].w && positions[1][axis] < -positions[1].w && positions[2][axis] < -positions[2].w)
+                    return;
+            }
+
+            for (int i = 0; i < 3; ++i)
+            {
+                gl_Layer = view;
+                gl_Position = positions[i];
+                vertexOut.position = positions[i];
+                vertexOut.normal = normalize(_views[view].viewNormalMatrix * vertexIn[i].normal);
+                vertexOut.texCoord = vertexIn[i].texCoord;
+                vertexOut.annexe = vertexIn[i].annexe;
+                vertexOut.blendingValue = vertexIn[i].blendingValue;
+
+                vec4 projectedVertex = positions[i] / positions[i].w;
+                if (projectedVertex.z >= 0.0)
+                {
+                    if (vertexIn[i].annexe.y == 0.0)
+                        vertexOut.blendingValue = 1.0;
+                    else
+                        vertexOut.blendingValue = min(1.0, getSmoothBlendFromVertex(projectedVertex, _views[view].cameraAttributes.x) / vertexIn[i].annexe.y);
+                }
+
+                EmitVertex();
+            }
+            EndPrimitive();
         }
     )"};
 
@@ -1225,6 +1383,7 @@ struct ShaderSources
     const std::string FRAGMENT_SHADER_TEXTURE{R"(
         #include hsv
         #include correctColor
+        #include cameraBlock
 
         #define PI 3.14159265359
 
@@ -1243,16 +1402,8 @@ struct ShaderSources
         uniform vec2 _tex0_size = vec2(1.0);
         uniform vec2 _tex1_size = vec2(1.0);
 
-        uniform int _showCameraCount = 0;
         uniform int _sideness = 0;
-        uniform vec4 _cameraAttributes = vec4(0.05, 1.0, 1.0, 1.0); // blendWidth, brightness, saturation, contrast
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
-        uniform int _isColorLUT = 0;
         uniform vec4 _color = vec4(0.0, 0.0, 0.0, 1.0);
-        uniform vec3 _colorLUT[256];
-        uniform mat3 _colorMixMatrix = mat3(1.0, 0.0, 0.0,
-                                            0.0, 1.0, 0.0,
-                                            0.0, 0.0, 1.0);
         uniform float _normalExp = 0.0;
 
         in VertexData
@@ -1453,9 +1604,10 @@ struct ShaderSources
     )"};
 
     const std::string GEOMETRY_SHADER_WIREFRAME{R"(
+        #include objectBlock
+
         layout(triangles) in;
         layout(triangle_strip, max_vertices = 3) out;
-        uniform mat4 _modelViewProjectionMatrix;
 
         in VertexData
         {
@@ -1498,6 +1650,8 @@ struct ShaderSources
     )"};
 
     const std::string FRAGMENT_SHADER_WIREFRAME{R"(
+        #include cameraBlock
+
         #define PI 3.14159265359
 
         in VertexData
@@ -1507,9 +1661,7 @@ struct ShaderSources
             vec4 position;
         } vertexIn;
 
-        uniform vec4 _wireframeColor = vec4(1.0, 0.0, 0.0, 1.0);
         uniform int _sideness = 0;
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
         out vec4 fragColor;
 
         float edgeFactor()
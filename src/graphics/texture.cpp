@@ -44,6 +44,7 @@ void Texture::registerAttributes()
 
     addAttribute("timestamp", [](const Values&) { return true; }, [&]() -> Values { return {_spec.timestamp}; });
     setAttributeDescription("timestamp", "Timestamp (in µs) for the current texture, which mimicks the timestamp of the input image (if any)");
+    setAttributeVolatile("timestamp", true);
 }
 
 } // namespace Splash
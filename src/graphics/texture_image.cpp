@@ -1,5 +1,7 @@
 #include "./graphics/texture_image.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 
 #include "./image/image.h"
@@ -12,6 +14,9 @@ namespace Splash
 {
 
 constexpr int Texture_Image::_texLevels;
+constexpr int Texture_Image::_readbackPboCount;
+mutex Texture_Image::_orphanedUploadSlotsMutex;
+vector<Texture_Image::UploadSlots> Texture_Image::_orphanedUploadSlots;
 
 /*************/
 Texture_Image::Texture_Image(RootObject* root)
@@ -40,7 +45,21 @@ Texture_Image::~Texture_Image()
 
     lock_guard<mutex> lock(_mutex);
     glDeleteTextures(1, &_glTex);
-    glDeleteBuffers(2, _pbos);
+    for (auto& fence : _pboFences)
+        if (fence)
+            glDeleteSync(fence);
+    glDeleteBuffers(_pbos.size(), _pbos.data());
+    deleteReadback(_mipmapReadback);
+    deleteReadback(_meanValueReadback);
+
+    // Slots still held by a source can not be unmapped yet, they are handed over to the other textures
+    releaseUploadSlots();
+    pollUploadSlots();
+    if (!_retiredUploadSlots.empty())
+    {
+        lock_guard<mutex> lockOrphans(_orphanedUploadSlotsMutex);
+        move(_retiredUploadSlots.begin(), _retiredUploadSlots.end(), back_inserter(_orphanedUploadSlots));
+    }
 }
 
 /*************/
@@ -65,15 +84,21 @@ void Texture_Image::generateMipmap() const
 }
 
 /*************/
-RgbValue Texture_Image::getMeanValue() const
+optional<RgbValue> Texture_Image::getMeanValue()
 {
     int level = _texLevels - 1;
     int width, height;
     glGetTextureLevelParameteriv(_glTex, level, GL_TEXTURE_WIDTH, &width);
     glGetTextureLevelParameteriv(_glTex, level, GL_TEXTURE_HEIGHT, &height);
-    auto size = width * height * 4;
-    ResizableArray<uint8_t> buffer(size);
-    glGetTextureImage(_glTex, level, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, buffer.size(), buffer.data());
+
+    auto image = readbackMipmap(_meanValueReadback, level, ImageBufferSpec(width, height, 4, 32), GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV);
+    if (image.empty())
+        return {};
+
+    // The image may have been read before a resize of the texture
+    width = image.getSpec().width;
+    height = image.getSpec().height;
+    auto buffer = image.data();
 
     RgbValue meanColor;
     for (int y = 0; y < height; ++y)
@@ -102,22 +127,102 @@ unordered_map<string, Values> Texture_Image::getShaderUniforms() const
 }
 
 /*************/
-ImageBuffer Texture_Image::grabMipmap(unsigned int level) const
+ImageBuffer Texture_Image::grabMipmap(unsigned int level)
 {
-    int mipmapLevel = std::min<int>(level, _texLevels);
+    int mipmapLevel = std::min<int>(level, _texLevels - 1);
     GLint width, height;
-    glGetTextureLevelParameteriv(_glTex, level, GL_TEXTURE_WIDTH, &width);
-    glGetTextureLevelParameteriv(_glTex, level, GL_TEXTURE_HEIGHT, &height);
+    glGetTextureLevelParameteriv(_glTex, mipmapLevel, GL_TEXTURE_WIDTH, &width);
+    glGetTextureLevelParameteriv(_glTex, mipmapLevel, GL_TEXTURE_HEIGHT, &height);
 
     auto spec = _spec;
     spec.width = width;
     spec.height = height;
 
-    auto image = ImageBuffer(spec);
-    glGetTextureImage(_glTex, mipmapLevel, _texFormat, _texType, image.getSize(), image.data());
+    return readbackMipmap(_mipmapReadback, mipmapLevel, spec, _texFormat, _texType);
+}
+
+/*************/
+ImageBuffer Texture_Image::readbackMipmap(Readback& readback, int level, const ImageBufferSpec& spec, GLenum format, GLenum type)
+{
+    // Get the most recent read back the GPU is done with. Older ones are dropped.
+    int readyIndex = -1;
+    for (int i = 0; i < static_cast<int>(readback.fences.size()); ++i)
+    {
+        auto index = (readback.writeIndex + i) % readback.fences.size();
+        auto& fence = readback.fences[index];
+        if (!fence)
+            continue;
+
+        auto status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            continue;
+
+        glDeleteSync(fence);
+        fence = nullptr;
+        readyIndex = index;
+    }
+
+    ImageBuffer image;
+    if (readyIndex >= 0)
+    {
+        image = ImageBuffer(readback.specs[readyIndex]);
+        memcpy(image.data(), readback.pixels[readyIndex], image.getSize());
+    }
+
+    size_t size = spec.rawSize();
+    if (size == 0)
+        return image;
+
+    // PBOs are only grown, so that a resize does not throw away the read backs in flight
+    if (size > readback.size)
+    {
+        deleteReadback(readback);
+
+        auto flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        readback.pbos.resize(_readbackPboCount);
+        readback.pixels.assign(_readbackPboCount, nullptr);
+        readback.fences.assign(_readbackPboCount, nullptr);
+        readback.specs.assign(_readbackPboCount, ImageBufferSpec());
+
+        glCreateBuffers(readback.pbos.size(), readback.pbos.data());
+        for (int i = 0; i < _readbackPboCount; ++i)
+        {
+            glNamedBufferStorage(readback.pbos[i], size, 0, flags);
+            readback.pixels[i] = (GLubyte*)glMapNamedBufferRange(readback.pbos[i], 0, size, flags);
+            if (!readback.pixels[i])
+            {
+                Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize read back PBOs" << Log::endl;
+                deleteReadback(readback);
+                return image;
+            }
+        }
+        readback.size = size;
+    }
+
+    // If the GPU is lagging behind, skip this read back rather than waiting for it
+    if (readback.fences[readback.writeIndex])
+        return image;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbos[readback.writeIndex]);
+    glGetTextureImage(_glTex, level, format, type, readback.size, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fences[readback.writeIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.specs[readback.writeIndex] = spec;
+    readback.writeIndex = (readback.writeIndex + 1) % readback.pbos.size();
+
     return image;
 }
 
+/*************/
+void Texture_Image::deleteReadback(Readback& readback)
+{
+    for (auto& fence : readback.fences)
+        if (fence)
+            glDeleteSync(fence);
+    glDeleteBuffers(readback.pbos.size(), readback.pbos.data());
+    readback = Readback();
+}
+
 /*************/
 bool Texture_Image::linkIt(const std::shared_ptr<GraphObject>& obj)
 {
@@ -352,6 +457,8 @@ void Texture_Image::update()
     _shaderUniforms["flip"] = flip;
     _shaderUniforms["flop"] = flop;
 
+    pollUploadSlots();
+
     if (img->getTimestamp() == _spec.timestamp)
         return;
 
@@ -367,6 +474,9 @@ void Texture_Image::update()
     int imageDataSize = spec.rawSize();
     GLenum glChannelOrder = getChannelOrder(spec);
 
+    // Planar images are stored in a single channel texture, chroma planes being below the luma plane
+    uint32_t textureHeight = spec.isPlanar() ? spec.height + spec.height / 2 : spec.height;
+
     // If the texture is compressed, we need to modify a few values
     bool isCompressed = false;
     if (spec.format == "RGB_DXT1")
@@ -390,7 +500,13 @@ void Texture_Image::update()
     GLenum dataFormat = GL_UNSIGNED_BYTE;
     if (!isCompressed)
     {
-        if (spec.channels == 4 && spec.type == ImageBufferSpec::Type::UINT8)
+        if (spec.isPlanar())
+        {
+            // Planes are uploaded as is, conversion to RGB is done in the shader
+            dataFormat = spec.type == ImageBufferSpec::Type::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+            internalFormat = spec.type == ImageBufferSpec::Type::UINT16 ? GL_R16 : GL_R8;
+        }
+        else if (spec.channels == 4 && spec.type == ImageBufferSpec::Type::UINT8)
         {
             dataFormat = GL_UNSIGNED_INT_8_8_8_8_REV;
             if (srgb[0].as<int>() > 0)
@@ -449,8 +565,12 @@ void Texture_Image::update()
         }
     }
 
+    // Planes are tightly packed single channel rows, whose size is not always a multiple of 4 bytes
+    if (spec.isPlanar())
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     // Update the textures if the format changed
-    if (spec != _spec || !spec.videoFrame)
+    if (spec != _spec || !spec.videoFrame || _pbos.size() != _pboCount)
     {
         // glTexStorage2D is immutable, so we have to delete the texture first
         glDeleteTextures(1, &_glTex);
@@ -461,7 +581,7 @@ void Texture_Image::update()
 
         if (_filtering)
         {
-            if (isCompressed)
+            if (isCompressed || spec.isPlanar())
                 glTextureParameteri(_glTex, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             else
                 glTextureParameteri(_glTex, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -480,8 +600,8 @@ void Texture_Image::update()
             Log::get() << Log::DEBUGGING << "Texture_Image::" << __FUNCTION__ << " - Creating a new texture" << Log::endl;
 #endif
             img->lockWrite();
-            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, img->data());
+            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, textureHeight);
+            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, textureHeight, glChannelOrder, dataFormat, img->data());
             img->unlockWrite();
         }
         else if (isCompressed)
@@ -496,45 +616,67 @@ void Texture_Image::update()
             img->unlockWrite();
         }
 
-        if (!updatePbos(spec.width, spec.height, spec.pixelBytes()))
-            return;
-
-        // Fill one of the PBOs right now
-        auto pixels = _pbosPixels[0];
-        if (pixels != NULL)
+        if (!updatePbos(spec.width, textureHeight, spec.pixelBytes()))
         {
-            img->lockWrite();
-            memcpy((void*)pixels, img->data(), imageDataSize);
-            img->unlockWrite();
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            return;
         }
 
-        // And copy it to the second PBO
-        glCopyNamedBufferSubData(_pbos[0], _pbos[1], 0, 0, imageDataSize);
         _spec = spec;
+
+        // Video sources living in this process can write their next frames directly into upload slots
+        if (spec.videoFrame)
+            updateUploadSlots(img->getName(), imageDataSize);
+        else
+            releaseUploadSlots();
     }
     // Update the content of the texture, i.e the image
     else
     {
-        // Copy the pixels from the current PBO to the texture
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[_pboUploadIndex]);
-        if (!isCompressed)
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, 0);
-        else
-            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-
-        _pboUploadIndex = (_pboUploadIndex + 1) % 2;
+        img->lockWrite();
+        auto slotIndex = _uploadSlots.ring ? _uploadSlots.ring->getSlotIndex(img->data()) : -1;
+        if (slotIndex >= 0)
+        {
+            // The source wrote the frame at the beginning of one of the upload slots, which is uploaded as is
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadSlots.pbos[slotIndex]);
+            if (!isCompressed)
+                glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, textureHeight, glChannelOrder, dataFormat, 0);
+            else
+                glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            img->unlockWrite();
 
-        // Fill the next PBO with the image pixels
-        auto pixels = _pbosPixels[_pboUploadIndex];
-        if (pixels != nullptr)
+            // The slot can not be given back to the source until the GPU is done reading it
+            auto& fence = _uploadSlots.fences[slotIndex];
+            if (fence)
+                glDeleteSync(fence);
+            fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            _uploadSlots.ring->setSlotBusy(slotIndex, true);
+        }
+        else
         {
+            img->unlockWrite();
+
+            // Fill the next PBO with the image pixels, and upload it right away: the transfer runs
+            // asynchronously, and the fence tells when the PBO can be overwritten
+            auto pboIndex = acquirePbo();
             img->lockWrite();
-            memcpy(pixels, img->data(), imageDataSize);
+            memcpy(_pbosPixels[pboIndex], img->data(), imageDataSize);
             img->unlockWrite();
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[pboIndex]);
+            if (!isCompressed)
+                glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, textureHeight, glChannelOrder, dataFormat, 0);
+            else
+                glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            _pboFences[pboIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
         }
     }
 
+    if (spec.isPlanar())
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
     _spec.timestamp = spec.timestamp;
 
     // If needed, specify some uniforms for the shader which will use this texture
@@ -548,10 +690,15 @@ void Texture_Image::update()
         _shaderUniforms["YUV"] = {1};
     else if (spec.format == "YUYV")
         _shaderUniforms["YUV"] = {2};
+    else if (spec.format == "NV12" || spec.format == "P010")
+        _shaderUniforms["YUV"] = {3};
+    else if (spec.format == "I420")
+        _shaderUniforms["YUV"] = {4};
     else
         _shaderUniforms["YUV"] = {0};
 
-    if (_filtering && !isCompressed)
+    // Mipmaps of the planes would mix luma and chroma, and the shader only reads the base level
+    if (_filtering && !isCompressed && !spec.isPlanar())
         generateMipmap();
 }
 
@@ -569,27 +716,152 @@ void Texture_Image::init()
 /*************/
 bool Texture_Image::updatePbos(int width, int height, int bytes)
 {
-    glDeleteBuffers(2, _pbos);
+    // Buffers still read by the GPU are only released once it is done with them
+    for (auto& fence : _pboFences)
+        if (fence)
+            glDeleteSync(fence);
+    glDeleteBuffers(_pbos.size(), _pbos.data());
 
     auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
     auto imageDataSize = width * height * bytes;
 
-    glCreateBuffers(2, _pbos);
-    glNamedBufferStorage(_pbos[0], imageDataSize, 0, flags);
-    glNamedBufferStorage(_pbos[1], imageDataSize, 0, flags);
+    _pbos.resize(_pboCount);
+    _pbosPixels.assign(_pboCount, nullptr);
+    _pboFences.assign(_pboCount, nullptr);
+    _pboUploadIndex = 0;
+
+    glCreateBuffers(_pbos.size(), _pbos.data());
+    for (uint32_t i = 0; i < _pboCount; ++i)
+    {
+        glNamedBufferStorage(_pbos[i], imageDataSize, 0, flags);
+        _pbosPixels[i] = (GLubyte*)glMapNamedBufferRange(_pbos[i], 0, imageDataSize, flags);
+        if (!_pbosPixels[i])
+        {
+            Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload PBOs" << Log::endl;
+            glDeleteBuffers(_pbos.size(), _pbos.data());
+            _pbos.clear();
+            _pbosPixels.clear();
+            _pboFences.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
 
-    _pbosPixels[0] = (GLubyte*)glMapNamedBufferRange(_pbos[0], 0, imageDataSize, flags);
-    _pbosPixels[1] = (GLubyte*)glMapNamedBufferRange(_pbos[1], 0, imageDataSize, flags);
+/*************/
+int Texture_Image::acquirePbo()
+{
+    auto index = _pboUploadIndex;
+    _pboUploadIndex = (_pboUploadIndex + 1) % _pbos.size();
 
-    if (!_pbosPixels[0] || !_pbosPixels[1])
+    auto& fence = _pboFences[index];
+    if (!fence)
+        return index;
+
+    auto status = glClientWaitSync(fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
     {
-        Log::get() << Log::ERROR << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload PBOs" << Log::endl;
-        return false;
+        // The GPU is lagging behind the source, the ring may be too short for it
+        ++_pboStalls;
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
     }
 
+    glDeleteSync(fence);
+    fence = nullptr;
+    return index;
+}
+
+/*************/
+bool Texture_Image::updateUploadSlots(const string& imageName, size_t size)
+{
+    if (_uploadSlots.ring && _uploadSlots.ring->getSlotSize() == size && _uploadSlots.ring->getSlotCount() == _pboCount && _uploadSlotsName == imageName)
+        return true;
+
+    releaseUploadSlots();
+
+    // Slots are readable too, as the source may also serialize the frames for other processes
+    auto flags = GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    vector<uint8_t*> slots(_pboCount, nullptr);
+    _uploadSlots.pbos.resize(_pboCount);
+    _uploadSlots.fences.assign(_pboCount, nullptr);
+
+    glCreateBuffers(_uploadSlots.pbos.size(), _uploadSlots.pbos.data());
+    for (uint32_t i = 0; i < _pboCount; ++i)
+    {
+        glNamedBufferStorage(_uploadSlots.pbos[i], size, 0, flags);
+        slots[i] = static_cast<uint8_t*>(glMapNamedBufferRange(_uploadSlots.pbos[i], 0, size, flags));
+        if (!slots[i])
+        {
+            Log::get() << Log::WARNING << "Texture_Image::" << __FUNCTION__ << " - Unable to initialize upload slots, frames will be copied" << Log::endl;
+            glDeleteBuffers(_uploadSlots.pbos.size(), _uploadSlots.pbos.data());
+            _uploadSlots = UploadSlots();
+            return false;
+        }
+    }
+
+    _uploadSlots.ring = UploadRing::create(slots, size);
+    _uploadSlotsName = imageName;
+    UploadRing::publish(_uploadSlotsName, _uploadSlots.ring);
     return true;
 }
 
+/*************/
+void Texture_Image::releaseUploadSlots()
+{
+    if (!_uploadSlots.ring)
+        return;
+
+    UploadRing::withdraw(_uploadSlotsName, _uploadSlots.ring.get());
+    _uploadSlots.ring->close();
+    _retiredUploadSlots.push_back(std::move(_uploadSlots));
+    _uploadSlots = UploadSlots();
+    _uploadSlotsName.clear();
+}
+
+/*************/
+void Texture_Image::pollUploadSlots()
+{
+    auto pollFences = [](UploadSlots& slots) {
+        for (size_t i = 0; i < slots.fences.size(); ++i)
+        {
+            if (!slots.fences[i])
+                continue;
+
+            auto status = glClientWaitSync(slots.fences[i], 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                continue;
+
+            glDeleteSync(slots.fences[i]);
+            slots.fences[i] = nullptr;
+            slots.ring->setSlotBusy(i, false);
+        }
+    };
+
+    auto deleteIdleSlots = [&](vector<UploadSlots>& retiredSlots) {
+        for (auto slotsIt = retiredSlots.begin(); slotsIt != retiredSlots.end();)
+        {
+            pollFences(*slotsIt);
+            if (slotsIt->ring->isIdle())
+            {
+                glDeleteBuffers(slotsIt->pbos.size(), slotsIt->pbos.data());
+                slotsIt = retiredSlots.erase(slotsIt);
+            }
+            else
+            {
+                ++slotsIt;
+            }
+        }
+    };
+
+    if (_uploadSlots.ring)
+        pollFences(_uploadSlots);
+    deleteIdleSlots(_retiredUploadSlots);
+
+    lock_guard<mutex> lockOrphans(_orphanedUploadSlotsMutex);
+    deleteIdleSlots(_orphanedUploadSlots);
+}
+
 /*************/
 void Texture_Image::registerAttributes()
 {
@@ -612,6 +884,22 @@ void Texture_Image::registerAttributes()
         {'n'});
     setAttributeDescription("clampToEdge", "If set to 1, clamp the texture to the edge");
 
+    addAttribute("bufferCount",
+        [&](const Values& args) {
+            _pboCount = max(args[0].as<int>(), 2);
+            return true;
+        },
+        [&]() -> Values { return {(int)_pboCount}; },
+        {'n'});
+    setAttributeDescription("bufferCount", "Number of GPU buffers to use for frame upload to the GPU");
+
+    addAttribute("bufferStalls",
+        [&](const Values&) { return false; },
+        [&]() -> Values { return {static_cast<int64_t>(_pboStalls)}; },
+        {});
+    setAttributeDescription("bufferStalls", "Number of frames which had to wait for an upload buffer to be released by the GPU");
+    setAttributeVolatile("bufferStalls", true);
+
     addAttribute("size",
         [&](const Values& args) {
             resize(args[0].as<int>(), args[1].as<int>());
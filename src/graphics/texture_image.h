@@ -25,16 +25,20 @@
 #ifndef SPLASH_TEXTURE_IMAGE_H
 #define SPLASH_TEXTURE_IMAGE_H
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <glm/glm.hpp>
 #include <list>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include "./config.h"
 
 #include "./core/attribute.h"
 #include "./core/coretypes.h"
+#include "./core/upload_ring.h"
 #include "./graphics/texture.h"
 #include "./image/image.h"
 #include "./utils/cgutils.h"
@@ -91,10 +95,10 @@ class Texture_Image : public Texture
     void generateMipmap() const;
 
     /**
-     * Computed the mean value for the image
-     * \return Return the mean RGB value
+     * Compute the mean value for the image. The texture is read back asynchronously, so the value is a few frames late.
+     * \return Return the mean RGB value of the most recent completed read back, or nothing if none completed since the last call
      */
-    RgbValue getMeanValue() const;
+    std::optional<RgbValue> getMeanValue();
 
     /**
      * \brief Get the id of the gl texture
@@ -109,11 +113,12 @@ class Texture_Image : public Texture
     std::unordered_map<std::string, Values> getShaderUniforms() const final;
 
     /**
-     * Grab the texture to the host memory, at the given mipmap level
+     * Grab the texture to the host memory, at the given mipmap level. This does not wait for the GPU:
+     * the read back is queued, and the most recent one which completed is returned.
      * \param level Mipmap level to grab
-     * \return Return the image data in an ImageBuffer
+     * \return Return the image data in an ImageBuffer, which is empty if no read back completed since the last call
      */
-    ImageBuffer grabMipmap(unsigned int level = 0) const;
+    ImageBuffer grabMipmap(unsigned int level = 0);
 
     /**
      * \brief Read the texture and returns an Image
@@ -164,9 +169,46 @@ class Texture_Image : public Texture
     void unlinkIt(const std::shared_ptr<GraphObject>& obj) final;
 
   private:
+    struct UploadSlots
+    {
+        std::shared_ptr<UploadRing> ring{};
+        std::vector<GLuint> pbos{};
+        std::vector<GLsync> fences{};
+    };
+
+    struct Readback
+    {
+        std::vector<GLuint> pbos{};
+        std::vector<GLubyte*> pixels{};
+        std::vector<GLsync> fences{};
+        std::vector<ImageBufferSpec> specs{}; //!< Spec of the image read into each PBO
+        size_t size{0};                       //!< Size of each PBO, in bytes
+        int writeIndex{0};
+    };
+
     GLuint _glTex{0};
-    GLuint _pbos[2];
-    GLubyte* _pbosPixels[2];
+
+    // Ring of PBOs the frames are copied into before upload, a PBO being reused once the GPU is done reading it
+    uint32_t _pboCount{3};
+    std::vector<GLuint> _pbos{};
+    std::vector<GLubyte*> _pbosPixels{};
+    std::vector<GLsync> _pboFences{};
+    std::atomic<uint64_t> _pboStalls{0}; //!< Number of frames which had to wait for the GPU to release a PBO
+
+    // Slots the source can write its frames into, uploaded without any copy. There are as many as PBOs in the ring.
+    UploadSlots _uploadSlots{};
+    std::string _uploadSlotsName{""};               //!< Name under which the slots are published
+    std::vector<UploadSlots> _retiredUploadSlots{}; //!< Previous slots, deleted once they are not used anymore
+
+    // Retired slots of destroyed textures, which stay mapped until their sources release them.
+    // GL contexts being shared, they are deleted by any other texture.
+    static std::mutex _orphanedUploadSlotsMutex;
+    static std::vector<UploadSlots> _orphanedUploadSlots;
+
+    // Rings of PBOs the texture is read back into, for grabMipmap and getMeanValue
+    static constexpr int _readbackPboCount{3};
+    Readback _mipmapReadback{};
+    Readback _meanValueReadback{};
 
     int _multisample{0};
     bool _cubemap{false};
@@ -210,6 +252,48 @@ class Texture_Image : public Texture
      */
     bool updatePbos(int width, int height, int bytes);
 
+    /**
+     * \brief Get the next PBO of the ring, waiting for the GPU to be done reading it if needed
+     * \return Return the index of the PBO
+     */
+    int acquirePbo();
+
+    /**
+     * \brief Queue a read back of the texture into the next PBO of the ring, and get the most recent completed one.
+     * If the GPU did not release the next PBO yet, no read back is queued.
+     * \param readback Ring to read back into
+     * \param level Mipmap level to read
+     * \param spec Spec of the image at this level
+     * \param format GL format to read the texture as
+     * \param type GL type to read the texture as
+     * \return Return the most recent image read back, or an empty buffer if none completed since the last call
+     */
+    ImageBuffer readbackMipmap(Readback& readback, int level, const ImageBufferSpec& spec, GLenum format, GLenum type);
+
+    /**
+     * \brief Delete the PBOs of a read back ring
+     * \param readback Ring to delete
+     */
+    void deleteReadback(Readback& readback);
+
+    /**
+     * \brief Create the upload slots and publish them for the given image, if not already done
+     * \param imageName Name of the image feeding this texture
+     * \param size Size of a frame, in bytes
+     * \return Return true if all went well
+     */
+    bool updateUploadSlots(const std::string& imageName, size_t size);
+
+    /**
+     * \brief Withdraw the upload slots, which are deleted once they are not used anymore
+     */
+    void releaseUploadSlots();
+
+    /**
+     * \brief Release the upload slots the GPU is done reading, and delete the retired and orphaned slots which are not used anymore
+     */
+    void pollUploadSlots();
+
     /**
      * \brief Register new functors to modify attributes
      */
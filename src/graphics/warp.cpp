@@ -184,9 +184,13 @@ void Warp::render()
     colorTexture->generateMipmap();
     if (_grabMipmapLevel >= 0)
     {
-        _mipmapBuffer = colorTexture->grabMipmap(_grabMipmapLevel).getRawBuffer();
-        auto spec = colorTexture->getSpec();
-        _mipmapBufferSpec = {spec.width, spec.height, spec.channels, spec.bpp, spec.format};
+        auto image = colorTexture->grabMipmap(_grabMipmapLevel);
+        if (!image.empty())
+        {
+            _mipmapBuffer = image.getRawBuffer();
+            auto spec = image.getSpec();
+            _mipmapBufferSpec = {spec.width, spec.height, spec.channels, spec.bpp, spec.format};
+        }
     }
 
     colorTexture->setTimestamp(input->getTimestamp());
@@ -322,6 +326,7 @@ void Warp::registerAttributes()
         },
         {});
     setAttributeDescription("size", "Size of the input camera");
+    setAttributeVolatile("size", true);
 
     // Show the Bezier patch describing the warp
     // Also resets the selected control point if hidden
@@ -360,10 +365,12 @@ void Warp::registerAttributes()
     setAttributeDescription("grabMipmapLevel", "If set to 0 or superior, sync the rendered texture to the 'buffer' attribute, at the given mipmap level");
 
     addAttribute("buffer", [&](const Values&) { return true; }, [&]() -> Values { return {_mipmapBuffer}; }, {});
-    setAttributeDescription("buffer", "Getter attribute which gives access to the mipmap image, if grabMipmapLevel is greater or equal to 0");
+    setAttributeDescription("buffer", "Getter attribute which gives access to the last mipmap image read back, if grabMipmapLevel is greater or equal to 0");
+    setAttributeVolatile("buffer", true);
 
     addAttribute("bufferSpec", [&](const Values&) { return true; }, [&]() -> Values { return _mipmapBufferSpec; }, {});
     setAttributeDescription("bufferSpec", "Getter attribute to the specs of the attribute buffer");
+    setAttributeVolatile("bufferSpec", true);
 }
 
 } // end of namespace
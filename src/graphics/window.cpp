@@ -827,9 +827,11 @@ void Window::registerAttributes()
             return textureList;
         });
     setAttributeDescription("textureList", "Get the list of the textures linked to the window");
+    setAttributeVolatile("textureList", true);
 
     addAttribute("presentationDelay", [&](const Values&) { return true; }, [&]() -> Values { return {_presentationDelay}; });
     setAttributeDescription("presentationDelay", "Delay between the update of an image and its display");
+    setAttributeVolatile("presentationDelay", true);
 }
 
 } // namespace Splash
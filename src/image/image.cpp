@@ -1,7 +1,7 @@
 #include "./image/image.h"
 
+#include <cstring>
 #include <fstream>
-#include <future>
 #include <memory>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -9,11 +9,12 @@
 #include <stb_image.h>
 #include <stb_image_write.h>
 
+#include "./core/buffer_pool.h"
+#include "./core/upload_ring.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
 #include "./utils/timer.h"
 
-#define SPLASH_IMAGE_COPY_THREADS 2
 #define SPLASH_IMAGE_SERIALIZED_HEADER_SIZE 4096
 
 using namespace std;
@@ -94,7 +95,7 @@ void Image::set(const ImageBuffer& img)
 {
     lock_guard<shared_mutex> lockRead(_writeMutex);
     if (!_bufferImage)
-        _bufferImage = make_unique<ImageBuffer>();
+        _bufferImage = make_shared<ImageBuffer>();
     *_bufferImage = img;
     _imageUpdated = true;
     updateTimestamp();
@@ -108,7 +109,7 @@ void Image::set(unsigned int w, unsigned int h, unsigned int channels, ImageBuff
 
     lock_guard<shared_mutex> lock(_writeMutex);
     if (!_bufferImage)
-        _bufferImage = make_unique<ImageBuffer>();
+        _bufferImage = make_shared<ImageBuffer>();
     std::swap(*_bufferImage, img);
     _imageUpdated = true;
     updateTimestamp();
@@ -116,6 +117,12 @@ void Image::set(unsigned int w, unsigned int h, unsigned int channels, ImageBuff
 
 /*************/
 shared_ptr<SerializedObject> Image::serialize() const
+{
+    return serializeInto({});
+}
+
+/*************/
+shared_ptr<SerializedObject> Image::serializeInto(const function<ResizableArray<uint8_t>(size_t)>& allocate) const
 {
     lock_guard<Spinlock> lock(_readMutex);
 
@@ -123,36 +130,43 @@ shared_ptr<SerializedObject> Image::serialize() const
         Timer::get() << "serialize " + _name;
 
     // We first get the xml version of the specs, and pack them into the obj
-    if (!_image)
+    if (!_image || _image->data() == nullptr)
         return {};
     string xmlSpec = _image->getSpec().to_string();
     int nbrChar = xmlSpec.size();
     int imgSize = _image->getSpec().rawSize();
-    int totalSize = SPLASH_IMAGE_SERIALIZED_HEADER_SIZE + imgSize;
 
-    auto obj = make_shared<SerializedObject>(totalSize);
+    // If the caller gives the memory, the image follows the header in it. Otherwise it is sent as a separate payload.
+    ResizableArray<uint8_t> header;
+    if (allocate)
+        header = allocate(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE + imgSize);
+    const bool isSingleArray = header.size() != 0;
+    if (!isSingleArray)
+        header = BufferPool::get().allocate(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
 
-    auto currentObjPtr = obj->data();
+    auto currentObjPtr = header.data();
     const uint8_t* ptr = reinterpret_cast<const uint8_t*>(&nbrChar);
     copy(ptr, ptr + sizeof(nbrChar), currentObjPtr);
     currentObjPtr += sizeof(nbrChar);
 
     const char* charPtr = reinterpret_cast<const char*>(xmlSpec.c_str());
     copy(charPtr, charPtr + nbrChar, currentObjPtr);
-    currentObjPtr = obj->data() + SPLASH_IMAGE_SERIALIZED_HEADER_SIZE;
-
-    // And then, the image
-    const char* imgPtr = reinterpret_cast<const char*>(_image->data());
-    if (imgPtr == NULL)
-        return {};
 
+    // And then, the image. Unless written along the header, it is not copied: the payload holds the current image,
+    // which is not modified anymore as long as it is shared (see Image::update)
+    auto image = _image;
+    shared_ptr<SerializedObject> obj;
+    if (isSingleArray)
+    {
+        memcpy(header.data() + SPLASH_IMAGE_SERIALIZED_HEADER_SIZE, image->data(), imgSize);
+        obj = make_shared<SerializedObject>(std::move(header));
+    }
+    else
     {
-        vector<future<void>> threads;
-        int stride = SPLASH_IMAGE_COPY_THREADS;
-        for (int i = 0; i < stride - 1; ++i)
-            threads.push_back(async(launch::async, ([=]() { copy(imgPtr + imgSize / stride * i, imgPtr + imgSize / stride * (i + 1), currentObjPtr + imgSize / stride * i); })));
-        copy(imgPtr + imgSize / stride * (stride - 1), imgPtr + imgSize, currentObjPtr + imgSize / stride * (stride - 1));
+        auto payload = ResizableArray<uint8_t>(image->data(), imgSize, [image](uint8_t*) {});
+        obj = make_shared<SerializedObject>(std::move(header), std::move(payload));
     }
+    obj->_handle = image;
 
     if (Timer::get().isDebug())
         Timer::get() >> ("serialize " + _name);
@@ -160,10 +174,50 @@ shared_ptr<SerializedObject> Image::serialize() const
     return obj;
 }
 
+/*************/
+ResizableArray<uint8_t> Image::acquireUploadSlot(size_t size) const
+{
+    auto ring = UploadRing::find(_name);
+    if (!ring)
+        return {};
+    return ring->acquire(size);
+}
+
+/*************/
+bool Image::isUploadSlot(const void* data) const
+{
+    auto ring = UploadRing::find(_name);
+    return ring && ring->getSlotIndex(data) >= 0;
+}
+
+/*************/
+shared_ptr<SerializedObject> Image::share() const
+{
+    lock_guard<Spinlock> lock(_readMutex);
+    if (!_image)
+        return {};
+
+    auto obj = make_shared<SerializedObject>();
+    obj->_handle = _image;
+    return obj;
+}
+
 /*************/
 bool Image::deserialize(const shared_ptr<SerializedObject>& obj)
 {
-    if (obj.get() == nullptr || obj->size() == 0)
+    if (obj.get() == nullptr)
+        return false;
+
+    // Images from the same process are used as is, they are not modified while shared
+    if (auto image = obj->getHandle<shared_ptr<ImageBuffer>>())
+    {
+        _bufferImage = *image;
+        _imageUpdated = true;
+        updateTimestamp(_bufferImage->getSpec().timestamp);
+        return true;
+    }
+
+    if (obj->size() == 0)
         return false;
 
     if (Timer::get().isDebug())
@@ -192,12 +246,20 @@ bool Image::deserialize(const shared_ptr<SerializedObject>& obj)
             _bufferDeserialize = ImageBuffer(spec);
         _bufferDeserialize.getSpec().timestamp = spec.timestamp;
 
-        auto rawBuffer = obj->grabData();
-        rawBuffer.shift(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
-        _bufferDeserialize.setRawBuffer(std::move(rawBuffer));
+        // The image is either sent as a separate payload, or follows the header
+        if (obj->payloadSize() != 0)
+        {
+            _bufferDeserialize.setRawBuffer(obj->grabPayload());
+        }
+        else
+        {
+            auto rawBuffer = obj->grabData();
+            rawBuffer.shift(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
+            _bufferDeserialize.setRawBuffer(std::move(rawBuffer));
+        }
 
-        if (!_bufferImage)
-            _bufferImage = make_unique<ImageBuffer>();
+        if (!_bufferImage || _bufferImage.use_count() > 1)
+            _bufferImage = make_shared<ImageBuffer>();
         std::swap(*_bufferImage, _bufferDeserialize);
         _imageUpdated = true;
 
@@ -254,7 +316,7 @@ bool Image::readFile(const string& filename)
     {
         lock_guard<Spinlock> lock(_readMutex);
         if (!_bufferImage)
-            _bufferImage = make_unique<ImageBuffer>();
+            _bufferImage = make_shared<ImageBuffer>();
         std::swap(*_bufferImage, img);
         _imageUpdated = true;
     }
@@ -273,6 +335,8 @@ void Image::zero()
     if (!_image)
         return;
 
+    if (_image.use_count() > 1)
+        _image = make_shared<ImageBuffer>(_image->getSpec());
     _image->zero();
 }
 
@@ -286,6 +350,10 @@ void Image::update()
         _image.swap(_bufferImage);
         _imageUpdated = false;
 
+        // The previous image may still be referenced by a serialized object being sent
+        if (_bufferImage.use_count() > 1)
+            _bufferImage = make_shared<ImageBuffer>();
+
         if (_remoteType.empty() || _type == _remoteType)
             updateMediaInfo();
     }
@@ -293,6 +361,15 @@ void Image::update()
     {
         updateTimestamp();
     }
+
+    // A frame held in the upload slot of a released texture, e.g. while paused, is copied for the slot to be freed
+    lock_guard<Spinlock> lockRead(_readMutex);
+    if (_image && !_image->empty() && UploadRing::isClosedSlot(_image->data()))
+    {
+        auto image = make_shared<ImageBuffer>(_image->getSpec(), BufferPool::get().allocate(_image->getSize()));
+        memcpy(image->data(), _image->data(), _image->getSize());
+        _image = image;
+    }
 }
 
 /*************/
@@ -360,9 +437,7 @@ void Image::createDefaultImage()
     img.zero();
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = make_unique<ImageBuffer>();
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
@@ -386,9 +461,7 @@ void Image::createPattern()
         }
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = make_unique<ImageBuffer>();
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
@@ -122,6 +122,19 @@ class Image : public BufferObject
      */
     std::shared_ptr<SerializedObject> serialize() const override;
 
+    /**
+     * \brief Serialize the image into memory given by the caller, the image following the header
+     * \param allocate Allocation function
+     * \return Return the serialized image
+     */
+    std::shared_ptr<SerializedObject> serializeInto(const std::function<ResizableArray<uint8_t>(size_t)>& allocate) const override;
+
+    /**
+     * \brief Share the current image with objects living in the same process
+     * \return Return a serialized object holding the image
+     */
+    std::shared_ptr<SerializedObject> share() const override;
+
     /**
      * \brief Update the Image from a serialized representation
      * \param obj Serialized image
@@ -163,8 +176,8 @@ class Image : public BufferObject
     bool write(const std::string& filename);
 
   protected:
-    std::unique_ptr<ImageBuffer> _image{nullptr};
-    std::unique_ptr<ImageBuffer> _bufferImage{nullptr};
+    std::shared_ptr<ImageBuffer> _image{nullptr};       //!< Current image, shared with the serialized objects referencing it
+    std::shared_ptr<ImageBuffer> _bufferImage{nullptr}; //!< Image being filled, never shared
     std::string _filepath{""};
 
     Values _mediaInfo{};
@@ -179,6 +192,21 @@ class Image : public BufferObject
     void createDefaultImage(); //< Create a default black image
     void createPattern();      //< Create a default pattern
 
+    /**
+     * \brief Get an array to write the next frame into, mapping one of the upload slots of the texture fed by
+     * this image if it lives in the same process. The texture then uploads the frame without copying it.
+     * \param size Frame size, in bytes
+     * \return Return the array, which is empty if no slot is available
+     */
+    ResizableArray<uint8_t> acquireUploadSlot(size_t size) const;
+
+    /**
+     * \brief Check whether the given data is in an upload slot. Such data must not be written again once handed over.
+     * \param data Pointer to the data
+     * \return Return true if the data is in an upload slot
+     */
+    bool isUploadSlot(const void* data) const;
+
     /**
      * Update the _mediaInfo member
      */
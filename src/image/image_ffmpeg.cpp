@@ -1,6 +1,8 @@
 #include "./image/image_ffmpeg.h"
 
 #include <chrono>
+#include <cstring>
+#include <filesystem>
 #include <functional>
 #include <future>
 #include <numeric>
@@ -61,6 +63,9 @@ void Image_FFmpeg::freeFFmpegObjects()
 #endif
     }
 
+    if (_videoIndexThread.joinable())
+        _videoIndexThread.join();
+
     if (_avContext)
     {
         avformat_close_input(&_avContext);
@@ -113,8 +118,17 @@ bool Image_FFmpeg::read(const string& filename)
     }
 #endif
 
+    {
+        lock_guard<mutex> lockIndex(_videoIndexMutex);
+        _videoIndex.clear();
+        _videoIndexReady = false;
+        _keyframeInterval = 0;
+    }
+    _seekTarget = -1;
+
     // Launch the loops
     _continueRead = true;
+    _videoIndexThread = thread([this, filepath]() { buildVideoIndex(filepath); });
     _videoDisplayThread = thread([&]() { videoDisplayLoop(); });
 #if HAVE_PORTAUDIO
     _audioThread = thread([&]() { audioLoop(); });
@@ -145,6 +159,78 @@ string Image_FFmpeg::tagToFourCC(unsigned int tag)
     return fourcc;
 }
 
+/*************/
+void Image_FFmpeg::buildVideoIndex(const string& filepath)
+{
+    error_code errorCode;
+    auto mediaSize = static_cast<uint64_t>(filesystem::file_size(filepath, errorCode));
+    if (errorCode)
+        return;
+    auto mediaTime = static_cast<int64_t>(filesystem::last_write_time(filepath, errorCode).time_since_epoch().count());
+    if (errorCode)
+        return;
+
+    VideoIndex index;
+    const auto cachePath = VideoIndex::getCachePath(filepath);
+    if (!index.load(cachePath, mediaSize, mediaTime))
+    {
+        // The index is built from a separate context, as reading packets without decoding them is fast
+        // and does not disturb the read loop
+        AVFormatContext* indexContext = nullptr;
+        if (avformat_open_input(&indexContext, filepath.c_str(), nullptr, nullptr) != 0)
+            return;
+
+        if (avformat_find_stream_info(indexContext, nullptr) < 0)
+        {
+            avformat_close_input(&indexContext);
+            return;
+        }
+
+        // Same stream as the one selected by the read loop
+        int streamIndex = -1;
+        for (uint32_t i = 0; i < indexContext->nb_streams; ++i)
+        {
+            if (indexContext->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+            {
+                streamIndex = i;
+                break;
+            }
+        }
+
+        AVPacket packet;
+        av_init_packet(&packet);
+        while (streamIndex >= 0 && _continueRead && av_read_frame(indexContext, &packet) >= 0)
+        {
+            if (packet.stream_index == streamIndex)
+            {
+                auto pts = packet.pts != AV_NOPTS_VALUE ? packet.pts : packet.dts;
+                if (pts != AV_NOPTS_VALUE)
+                    index.addFrame(pts, packet.flags & AV_PKT_FLAG_KEY);
+            }
+            av_packet_unref(&packet);
+        }
+        avformat_close_input(&indexContext);
+
+        // Interrupted, the index is incomplete
+        if (!_continueRead || index.empty())
+            return;
+
+        index.finalize();
+        if (!index.save(cachePath, mediaSize, mediaTime))
+            Log::get() << Log::MESSAGE << "Image_FFmpeg::" << __FUNCTION__ << " - Could not write the frame index cache for file " << filepath << Log::endl;
+    }
+
+    if (index.getKeyframeCount() == 0)
+        return;
+
+    lock_guard<mutex> lockIndex(_videoIndexMutex);
+    _keyframeInterval = index.getMaxKeyframeInterval();
+    _videoIndex = std::move(index);
+    _videoIndexReady = true;
+    Log::get() << Log::MESSAGE << "Image_FFmpeg::" << __FUNCTION__ << " - Indexed " << _videoIndex.getFrameCount() << " frames and " << _videoIndex.getKeyframeCount()
+               << " keyframes for file " << filepath << Log::endl;
+}
+
 #if HAVE_PORTAUDIO
 /*************/
 bool Image_FFmpeg::setupAudioOutput(AVCodecContext* audioCodecContext)
@@ -328,24 +414,46 @@ void Image_FFmpeg::readLoop()
         return;
     }
 
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
-    vector<unsigned char> buffer(numBytes);
+    // 4:2:0 frames are kept planar and converted to RGB by the shader, which saves a pass over each frame
+    // and keeps the full chroma resolution. Other formats are converted to YUYV.
+    auto outputPixelFormat = AV_PIX_FMT_YUYV422;
+    ImageBufferSpec outputSpec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
+    if (videoCodecContext->width % 2 == 0 && videoCodecContext->height % 2 == 0)
+    {
+        switch (videoCodecContext->pix_fmt)
+        {
+        default:
+            break;
+        case AV_PIX_FMT_NV12:
+            outputPixelFormat = AV_PIX_FMT_NV12;
+            outputSpec = ImageBufferSpec(videoCodecContext->width, videoCodecContext->height, 1, 8, ImageBufferSpec::Type::UINT8, "NV12");
+            break;
+        case AV_PIX_FMT_YUV420P:
+            outputPixelFormat = AV_PIX_FMT_YUV420P;
+            outputSpec = ImageBufferSpec(videoCodecContext->width, videoCodecContext->height, 1, 8, ImageBufferSpec::Type::UINT8, "I420");
+            break;
+        case AV_PIX_FMT_P010LE:
+        case AV_PIX_FMT_YUV420P10LE:
+            // 10 bits frames are converted to P010 if needed, to keep their full depth
+            outputPixelFormat = AV_PIX_FMT_P010LE;
+            outputSpec = ImageBufferSpec(videoCodecContext->width, videoCodecContext->height, 1, 16, ImageBufferSpec::Type::UINT16, "P010");
+            break;
+        }
+    }
 
     struct SwsContext* swsContext = nullptr;
-    if (!isHap)
+    if (!isHap && outputPixelFormat != videoCodecContext->pix_fmt)
     {
         swsContext = sws_getContext(videoCodecContext->width,
             videoCodecContext->height,
             videoCodecContext->pix_fmt,
             videoCodecContext->width,
             videoCodecContext->height,
-            AV_PIX_FMT_YUYV422,
+            outputPixelFormat,
             SWS_BILINEAR,
             nullptr,
             nullptr,
             nullptr);
-
-        av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer.data(), AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
     }
 
     AVPacket packet;
@@ -375,6 +483,10 @@ void Image_FFmpeg::readLoop()
                 // If the codec is handled by FFmpeg
                 if (!isHap)
                 {
+                    // Frames buffered by the decoder before a seek must not be output after it
+                    if (_flushDecoder.exchange(false))
+                        avcodec_flush_buffers(videoCodecContext);
+
                     auto frameFinished = false;
                     if (avcodec_send_packet(videoCodecContext, &packet) < 0)
                         Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Error while decoding a frame in file " << _filepath << Log::endl;
@@ -383,20 +495,34 @@ void Image_FFmpeg::readLoop()
 
                     if (frameFinished)
                     {
-                        sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, videoCodecContext->height, rgbFrame->data, rgbFrame->linesize);
-
-                        ImageBufferSpec spec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
-                        img.reset(new ImageBuffer(spec));
-
-                        unsigned char* pixels = reinterpret_cast<unsigned char*>(img->data());
-                        copy(buffer.begin(), buffer.end(), pixels);
-
                         if (packet.pts != AV_NOPTS_VALUE)
                             timing = static_cast<uint64_t>((double)frame->best_effort_timestamp * _videoTimeBase * 1e6);
                         else
                             timing = 0.0;
                         // This handles repeated frames
                         timing += frame->repeat_pict * _videoTimeBase * 0.5;
+                    }
+
+                    if (frameFinished && !isBeforeSeekTarget(timing))
+                    {
+                        // The frame is copied or converted directly into a recycled buffer
+                        img = make_unique<ImageBuffer>(outputSpec, _framePool->allocate(outputSpec.rawSize()));
+                        if (!swsContext)
+                        {
+                            av_image_copy_to_buffer(img->data(),
+                                img->getSize(),
+                                (const uint8_t* const*)frame->data,
+                                frame->linesize,
+                                outputPixelFormat,
+                                videoCodecContext->width,
+                                videoCodecContext->height,
+                                1);
+                        }
+                        else
+                        {
+                            av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, img->data(), outputPixelFormat, videoCodecContext->width, videoCodecContext->height, 1);
+                            sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, videoCodecContext->height, rgbFrame->data, rgbFrame->linesize);
+                        }
 
                         hasFrame = true;
                     }
@@ -410,7 +536,11 @@ void Image_FFmpeg::readLoop()
                     // We are using kind of a hack to store a DXT compressed image in an ImageBuffer
                     // First, we check the texture format type
                     std::string textureFormat;
-                    if (hapDecodeFrame(packet.data, packet.size, nullptr, 0, textureFormat))
+                    if (packet.pts != AV_NOPTS_VALUE)
+                        timing = static_cast<uint64_t>((double)packet.pts * _videoTimeBase * 1e6);
+
+                    // Hap frames are all keyframes, so frames before the seek target are not even decoded
+                    if (!isBeforeSeekTarget(timing) && hapDecodeFrame(packet.data, packet.size, nullptr, 0, textureFormat))
                     {
                         // Check if we need to resize the reader buffer
                         // We set the size so as to have just enough place for the given texture format
@@ -434,19 +564,12 @@ void Image_FFmpeg::readLoop()
                         }
 
                         spec.format = {textureFormat};
-                        img.reset(new ImageBuffer(spec));
+                        img = make_unique<ImageBuffer>(spec, _framePool->allocate(spec.rawSize()));
 
                         unsigned long outputBufferBytes = spec.width * spec.height * spec.channels;
 
                         if (hapDecodeFrame(packet.data, packet.size, img->data(), outputBufferBytes, textureFormat))
-                        {
-                            if (packet.pts != AV_NOPTS_VALUE)
-                                timing = static_cast<uint64_t>((double)packet.pts * _videoTimeBase * 1e6);
-                            else
-                                timing = 0.0;
-
                             hasFrame = true;
-                        }
                     }
                 }
 
@@ -612,16 +735,35 @@ void Image_FFmpeg::seek(float seconds, bool clearQueues)
     else if (seconds > duration)
         seconds = duration;
 
-    int frame = static_cast<int>(floor(seconds / _videoTimeBase));
-    if (avformat_seek_file(_avContext, _videoStreamIndex, 0, frame, frame, seekFlag) < 0)
+    auto frame = static_cast<int64_t>(floor(seconds / _videoTimeBase));
+    int seekResult = -1;
+    if (_videoIndexReady)
+    {
+        // Seek to the keyframe preceding the exact target frame, the read loop then decodes up to the target
+        lock_guard<mutex> lockIndex(_videoIndexMutex);
+        frame = _videoIndex.getFrameAt(frame).value_or(frame);
+        auto keyframe = _videoIndex.getKeyframeBefore(frame);
+        if (keyframe)
+            seekResult = av_seek_frame(_avContext, _videoStreamIndex, keyframe.value(), AVSEEK_FLAG_BACKWARD);
+    }
+
+    // Without an index, the demuxer looks for the closest keyframe before the target by itself
+    if (seekResult < 0)
+        seekResult = avformat_seek_file(_avContext, _videoStreamIndex, 0, frame, frame, seekFlag);
+
+    if (seekResult < 0)
     {
         Log::get() << Log::WARNING << "Image_FFmpeg::" << __FUNCTION__ << " - Could not seek to timestamp " << seconds << Log::endl;
     }
     else
     {
+        _seekTarget = static_cast<int64_t>((double)frame * _videoTimeBase * 1e6);
+        if (clearQueues)
+            _flushDecoder = true;
+
         lock_guard<mutex> lockQueue(_videoQueueMutex);
-        // As seeking will no necessarily go to the desired timestamp, but to the closest i-frame,
-        // we will set _startTime at the next frame in the videoDisplayLoop
+        // The read loop drops the frames decoded between the keyframe and the target,
+        // and _startTime is set at the first frame shown by the videoDisplayLoop
         _startTime = -1;
 
         if (clearQueues)
@@ -635,6 +777,21 @@ void Image_FFmpeg::seek(float seconds, bool clearQueues)
     }
 }
 
+/*************/
+bool Image_FFmpeg::isBeforeSeekTarget(uint64_t timing)
+{
+    auto target = _seekTarget.load();
+    if (target < 0)
+        return false;
+
+    // A 1ms tolerance absorbs the rounding differences between packet and frame timestamps
+    if (timing != 0 && static_cast<int64_t>(timing) + 1000 < target)
+        return true;
+
+    _seekTarget = -1;
+    return false;
+}
+
 /*************/
 void Image_FFmpeg::seek_async(float seconds, bool clearQueues)
 {
@@ -694,7 +851,15 @@ void Image_FFmpeg::videoDisplayLoop()
             TimedFrame& timedFrame = localQueue[0];
             if (timedFrame.timing != 0ull)
             {
-                if (_paused || (clockIsPaused && useClock))
+                // While prerolling, hold the first frame until playback is started
+                if (_prerolling)
+                {
+                    _currentTime = timedFrame.timing;
+                    _startTime = Timer::getTime() - _currentTime;
+                    this_thread::sleep_for(chrono::milliseconds(2));
+                    continue;
+                }
+                else if (_paused || (clockIsPaused && useClock))
                 {
                     _startTime = Timer::getTime() - _currentTime;
                     this_thread::sleep_for(chrono::milliseconds(2));
@@ -741,7 +906,13 @@ void Image_FFmpeg::videoDisplayLoop()
                 int64_t waitTime = timedFrame.timing - _currentTime;
 
                 // If the gap is too big, we seek through the video
-                if (abs(waitTime / 1e6) > (_intraOnly ? 1.f : 3.f)) // Maximum gap duration depending on encoding type (arbitrary values)
+                // Maximum gap duration depends on encoding type (arbitrary values). If the keyframes are known, seeking lands
+                // on the exact frame, so for late frames it is preferred as soon as it is cheaper than decoding up to the target.
+                // Early frames can not be caught up by decoding, so they keep the default threshold instead of waiting up to a GOP.
+                auto maxGap = _intraOnly ? 1.f : 3.f;
+                if (!_intraOnly && _videoIndexReady && waitTime < 0)
+                    maxGap = max(1.f, static_cast<float>(_keyframeInterval * _videoTimeBase));
+                if (abs(waitTime / 1e6) > maxGap)
                 {
                     auto expectedValue = false;
                     if (_timeJump.compare_exchange_strong(expectedValue, true, std::memory_order_acquire))
@@ -760,11 +931,18 @@ void Image_FFmpeg::videoDisplayLoop()
 
                 _elapsedTime = timedFrame.timing;
 
+                // Upload slots are only taken for the frame being shown, as the frames decoded ahead would hold them all.
+                // Copying the frame here saves the copy on the render thread.
+                auto slot = acquireUploadSlot(timedFrame.frame->getSize());
+                if (slot.size() != 0)
+                {
+                    memcpy(slot.data(), timedFrame.frame->data(), slot.size());
+                    timedFrame.frame = make_unique<ImageBuffer>(timedFrame.frame->getSpec(), std::move(slot));
+                }
+
                 {
                     lock_guard<shared_mutex> lock(_writeMutex);
-                    if (!_bufferImage)
-                        _bufferImage = make_unique<ImageBuffer>();
-                    std::swap(_bufferImage, timedFrame.frame);
+                    _bufferImage = std::move(timedFrame.frame);
                     _imageUpdated = true;
                 }
 
@@ -794,6 +972,7 @@ void Image_FFmpeg::registerAttributes()
         [&](const Values& args) {
             int64_t sizeMB = max(16, args[0].as<int>());
             _maximumBufferSize = sizeMB * (int64_t)1048576;
+            _framePool->setMaxCachedSize(_maximumBufferSize);
             return true;
         },
         [&]() -> Values { return {_maximumBufferSize / (int64_t)1048576}; },
@@ -808,6 +987,7 @@ void Image_FFmpeg::registerAttributes()
 
             return {getMediaDuration()};
         });
+    setAttributeVolatile("duration", true);
 
 #if HAVE_PORTAUDIO
     addAttribute("audioDeviceOutput",
@@ -842,6 +1022,7 @@ void Image_FFmpeg::registerAttributes()
             return {duration};
         });
     setAttributeDescription("elapsed", "Time elapsed since the beginning of the video");
+    setAttributeVolatile("elapsed", true);
 
     addAttribute("pause",
         [&](const Values& args) {
@@ -851,6 +1032,24 @@ void Image_FFmpeg::registerAttributes()
         [&]() -> Values { return {_paused}; },
         {'n'});
 
+    addAttribute("preroll",
+        [&](const Values& args) {
+            float seconds = args[0].as<float>();
+            if (seconds < 0.f)
+            {
+                _prerolling = false;
+                return true;
+            }
+
+            _prerolling = true;
+            seek_async(max(seconds, static_cast<float>(_trimStart) / 1e6f));
+            _seekTime = seconds;
+            return true;
+        },
+        [&]() -> Values { return {_prerolling ? _seekTime : -1.f}; },
+        {'n'});
+    setAttributeDescription("preroll", "Seek to the given position and buffer the following frames without showing them, until set to a negative value");
+
     addAttribute("seek",
         [&](const Values& args) {
             float seconds = args[0].as<float>();
@@ -908,6 +1107,7 @@ void Image_FFmpeg::registerAttributes()
         },
         [&]() -> Values { return {_videoFormat}; },
         {'s'});
+    setAttributeVolatile("videoFormat", true);
 
     addAttribute("timeShift",
         [&](const Values& args) {
@@ -43,8 +43,10 @@ extern "C" {
 }
 
 #include "./core/attribute.h"
+#include "./core/buffer_pool.h"
 #include "./core/coretypes.h"
 #include "./image/image.h"
+#include "./image/video_index.h"
 #if HAVE_PORTAUDIO
 #include "./sound/speaker.h"
 #endif
@@ -95,6 +97,7 @@ class Image_FFmpeg : public Image
     // Frame size history, used to keep the frame buffer smaller than _maximumBufferSize
     std::vector<int64_t> _framesSize{};
     int64_t _maximumBufferSize{(int64_t)1 << 29};
+    std::shared_ptr<BufferPool> _framePool{BufferPool::create(_maximumBufferSize)}; //!< Decoded frames are recycled once replaced by the display loop
 
     std::mutex _videoQueueMutex;
     std::mutex _videoSeekMutex;
@@ -103,6 +106,15 @@ class Image_FFmpeg : public Image
 
     std::atomic_bool _timeJump{false};
 
+    std::thread _videoIndexThread;
+    std::mutex _videoIndexMutex;
+    VideoIndex _videoIndex{};                  //!< Frame and keyframe timestamps, used for frame-accurate seeking
+    std::atomic_bool _videoIndexReady{false};  //!< Set once _videoIndex is built or loaded from the cache
+    std::atomic<int64_t> _keyframeInterval{0}; //!< Largest interval between two keyframes, in stream time base
+    std::atomic<int64_t> _seekTarget{-1};      //!< Timing of the frame to seek to (in us), frames before are decoded but dropped
+    std::atomic_bool _flushDecoder{false};     //!< Set by seek to discard the frames buffered by the decoder
+    std::atomic_bool _prerolling{false};       //!< If true, frames are buffered but not displayed
+
     bool _intraOnly{false};
     int64_t _startTime{0};
     int64_t _currentTime{0};
@@ -157,6 +169,12 @@ class Image_FFmpeg : public Image
      */
     float getMediaDuration() const;
 
+    /**
+     * \brief Build the frame index for the given file, or load it from the cache
+     * \param filepath Path to the media file
+     */
+    void buildVideoIndex(const std::string& filepath);
+
     /**
      * \brief Base init for the class
      */
@@ -173,6 +191,13 @@ class Image_FFmpeg : public Image
      */
     void seek(float seconds, bool clearQueues = true);
 
+    /**
+     * \brief Check whether a decoded frame comes before the current seek target, and should be dropped
+     * \param timing Frame timing, in us
+     * \return Return true if the frame should be dropped
+     */
+    bool isBeforeSeekTarget(uint64_t timing);
+
     /**
      * Seek asynchronously
      * \param seconds Desired position
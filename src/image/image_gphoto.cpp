@@ -476,6 +476,7 @@ void Image_GPhoto::registerAttributes()
                 return {1};
         });
     setAttributeDescription("ready", "Ask whether the camera is ready to shoot");
+    setAttributeVolatile("ready", true);
 }
 
 } // namespace Splash
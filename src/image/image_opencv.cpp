@@ -141,7 +141,7 @@ void Image_OpenCV::readLoop()
         {
             lock_guard<shared_mutex> lockWrite(_writeMutex);
             if (!_bufferImage)
-                _bufferImage = make_unique<ImageBuffer>();
+                _bufferImage = make_shared<ImageBuffer>();
             std::swap(*_bufferImage, _readBuffer);
             _imageUpdated = true;
         }
@@ -223,6 +223,7 @@ void Image_OpenCV::registerAttributes()
 
     addAttribute("capturing", [](const Values&) { return true; }, [&]() -> Values { return {_capturing}; });
     setAttributeDescription("capturing", "Ask whether the camera is grabbing images");
+    setAttributeVolatile("capturing", true);
 
     addAttribute("cvOptions",
         [&](const Values& args) {
@@ -13,6 +13,7 @@
 #include <glm/glm.hpp>
 #endif
 
+#include "./core/thread_pool.h"
 #include "./utils/cgutils.h"
 #include "./utils/log.h"
 #include "./utils/osutils.h"
@@ -217,6 +218,19 @@ void Image_Shmdata::onData(void* data, int data_size)
         Timer::get() >> ("image_shmdata " + _name);
 }
 
+/*************/
+void Image_Shmdata::acquireReaderBuffer()
+{
+    // Frames are written straight into an upload slot of the texture if possible.
+    // Slots can not be written again once handed over, as the GPU may still be reading them.
+    const auto spec = _readerBuffer.getSpec();
+    auto slot = acquireUploadSlot(spec.rawSize());
+    if (slot.size() != 0)
+        _readerBuffer = ImageBuffer(spec, std::move(slot));
+    else if (isUploadSlot(_readerBuffer.data()))
+        _readerBuffer = ImageBuffer(spec);
+}
+
 /*************/
 void Image_Shmdata::readHapFrame(void* data, int data_size)
 {
@@ -247,6 +261,8 @@ void Image_Shmdata::readHapFrame(void* data, int data_size)
         _readerBuffer = ImageBuffer(spec);
     }
 
+    acquireReaderBuffer();
+
     unsigned long outputBufferBytes = bufSpec.width * bufSpec.height * bufSpec.channels;
     if (!hapDecodeFrame(data, data_size, _readerBuffer.data(), outputBufferBytes, textureFormat))
         return;
@@ -254,7 +270,7 @@ void Image_Shmdata::readHapFrame(void* data, int data_size)
     {
         lock_guard<shared_mutex> lock(_writeMutex);
         if (!_bufferImage)
-            _bufferImage = make_unique<ImageBuffer>();
+            _bufferImage = make_shared<ImageBuffer>();
         std::swap(*(_bufferImage), _readerBuffer);
         _imageUpdated = true;
     }
@@ -287,6 +303,8 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
         _readerBuffer = ImageBuffer(spec);
     }
 
+    acquireReaderBuffer();
+
     if (!_isYUV && (_channels == 3 || _channels == 4))
     {
         char* pixels = (char*)(_readerBuffer).data();
@@ -294,7 +312,7 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
         for (int block = 0; block < SPLASH_SHMDATA_THREADS; ++block)
         {
             int size = _width * _height * _channels * sizeof(char);
-            threads.push_back(async(launch::async, [=]() {
+            threads.push_back(ThreadPool::get().enqueue([=]() {
                 int sizeOfBlock; // We compute the size of the block, to handle image size non divisible by SPLASH_SHMDATA_THREADS
                 if (size - size / SPLASH_SHMDATA_THREADS * block < 2 * size / SPLASH_SHMDATA_THREADS)
                     sizeOfBlock = size - size / SPLASH_SHMDATA_THREADS * block;
@@ -304,6 +322,9 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
                 memcpy(pixels + size / SPLASH_SHMDATA_THREADS * block, (const char*)data + size / SPLASH_SHMDATA_THREADS * block, sizeOfBlock);
             }));
         }
+
+        for (auto& thread : threads)
+            thread.wait();
     }
     else if (_is420)
     {
@@ -335,7 +356,7 @@ void Image_Shmdata::readUncompressedFrame(void* data, int /*data_size*/)
     {
         lock_guard<shared_mutex> lock(_writeMutex);
         if (!_bufferImage)
-            _bufferImage = make_unique<ImageBuffer>();
+            _bufferImage = make_shared<ImageBuffer>();
         std::swap(*(_bufferImage), _readerBuffer);
         _imageUpdated = true;
     }
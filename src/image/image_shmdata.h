@@ -105,6 +105,11 @@ class Image_Shmdata : public Image
      */
     void onData(void* data, int data_size);
 
+    /**
+     * Get the reader buffer ready for the next frame, using an upload slot if possible
+     */
+    void acquireReaderBuffer();
+
     /**
      * Read Hap compressed images
      */
@@ -107,11 +107,16 @@ void Image_V4L2::captureThreadFunc()
     {
         while (_captureThreadRun)
         {
-            if (!_bufferImage || _bufferImage->getSpec() != _imageBuffers[buffer.index]->getSpec())
-                _bufferImage = make_unique<ImageBuffer>(_spec);
+            // Read straight into an upload slot of the texture if possible, slots can not be reused once handed over
+            auto slot = acquireUploadSlot(_spec.rawSize());
 
             {
                 unique_lock<shared_mutex> lockWrite(_writeMutex);
+                if (slot.size() != 0)
+                    _bufferImage = make_shared<ImageBuffer>(_spec, std::move(slot));
+                else if (!_bufferImage || _bufferImage->getSpec() != _spec || isUploadSlot(_bufferImage->data()))
+                    _bufferImage = make_shared<ImageBuffer>(_spec);
+
                 result = ::read(_deviceFd, _bufferImage->data(), _spec.rawSize());
                 _imageUpdated = true;
             }
@@ -172,13 +177,22 @@ void Image_V4L2::captureThreadFunc()
                     assert(buffer.index < _bufferCount);
 
                     if (!_bufferImage || _bufferImage->getSpec() != _imageBuffers[buffer.index]->getSpec())
-                        _bufferImage = make_unique<ImageBuffer>(_spec);
+                        _bufferImage = make_shared<ImageBuffer>(_spec);
 
                     if (_ioMethod == V4L2_MEMORY_MMAP)
                     {
                         auto& imageBuffer = _imageBuffers[buffer.index];
+
+                        // Copying the frame to an upload slot here saves the copy on the render thread
+                        auto slot = acquireUploadSlot(imageBuffer->getSpec().rawSize());
+                        if (slot.size() != 0)
+                            memcpy(slot.data(), imageBuffer->data(), slot.size());
+
                         unique_lock<shared_mutex> lockWrite(_writeMutex);
-                        _bufferImage = make_unique<ImageBuffer>(imageBuffer->getSpec(), imageBuffer->data());
+                        if (slot.size() != 0)
+                            _bufferImage = make_shared<ImageBuffer>(imageBuffer->getSpec(), std::move(slot));
+                        else
+                            _bufferImage = make_shared<ImageBuffer>(imageBuffer->getSpec(), imageBuffer->data());
                         _imageUpdated = true;
                     }
                     else if (_ioMethod == V4L2_MEMORY_USERPTR)
@@ -255,7 +269,7 @@ void Image_V4L2::captureThreadFunc()
 
     // Reset to a default image
     unique_lock<shared_mutex> lockWrite(_writeMutex);
-    _bufferImage = make_unique<ImageBuffer>(ImageBufferSpec(512, 512, 4, 32));
+    _bufferImage = make_shared<ImageBuffer>(ImageBufferSpec(512, 512, 4, 32));
     _bufferImage->zero();
     _imageUpdated = true;
     updateTimestamp();
@@ -408,7 +422,7 @@ bool Image_V4L2::initializeCapture()
                 return false;
             }
 
-            _imageBuffers.push_back(make_unique<ImageBuffer>(_spec, static_cast<uint8_t*>(mappedMemory), true));
+            _imageBuffers.push_back(make_shared<ImageBuffer>(_spec, static_cast<uint8_t*>(mappedMemory), true));
 
             result = xioctl(_deviceFd, VIDIOC_QBUF, &buffer);
             if (result < 0)
@@ -426,7 +440,7 @@ bool Image_V4L2::initializeCapture()
 
         for (uint32_t i = 0; i < _bufferCount; ++i)
         {
-            _imageBuffers.push_back(make_unique<ImageBuffer>(_spec));
+            _imageBuffers.push_back(make_shared<ImageBuffer>(_spec));
 
             memset(&buffer, 0, sizeof(buffer));
             buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -832,6 +846,7 @@ void Image_V4L2::registerAttributes()
     setAttributeDescription("index", "Set the input index for the selected V4L2 capture device");
 
     addAttribute("sourceFormat", [&](const Values&) { return true; }, [&]() -> Values { return {_sourceFormatAsString}; }, {});
+    setAttributeVolatile("sourceFormat", true);
 
     addAttribute("pixelFormat",
         [&](const Values& args) {
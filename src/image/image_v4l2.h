@@ -100,7 +100,7 @@ class Image_V4L2 : public Image
     // Capture buffers;
     struct v4l2_requestbuffers _v4l2RequestBuffers;
     static const uint32_t _bufferCount{1};
-    std::deque<std::unique_ptr<ImageBuffer>> _imageBuffers{};
+    std::deque<std::shared_ptr<ImageBuffer>> _imageBuffers{};
 
     bool _shouldCapture{false};    //!< True if the device should start capturing
     bool _capturing{false};        //!< True if currently capturing frames
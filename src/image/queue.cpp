@@ -38,6 +38,24 @@ shared_ptr<SerializedObject> Queue::serialize() const
         return {};
 }
 
+/*************/
+shared_ptr<SerializedObject> Queue::serializeInto(const function<ResizableArray<uint8_t>(size_t)>& allocate) const
+{
+    if (_currentSource)
+        return _currentSource->serializeInto(allocate);
+    else
+        return {};
+}
+
+/*************/
+shared_ptr<SerializedObject> Queue::share() const
+{
+    if (_currentSource)
+        return _currentSource->share();
+    else
+        return {};
+}
+
 /*************/
 string Queue::getDistantName() const
 {
@@ -119,17 +137,30 @@ void Queue::update()
         {
             auto& sourceParameters = _playlist[_currentSourceIndex];
 
-            if (!_currentSource || _currentSource->getType() != sourceParameters.type)
-                _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
-
-            if (_currentSource)
+            // A prerolled source already has its file opened and its first frames decoded
+            bool prerolled = _nextSource && _nextSourceIndex == _currentSourceIndex;
+            if (prerolled)
+            {
+                _currentSource = _nextSource;
                 _playing = true;
+            }
             else
-                _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
-            dynamic_pointer_cast<Image>(_currentSource)->zero();
+            {
+                if (!_currentSource || _currentSource->getType() != sourceParameters.type)
+                    _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
+
+                if (_currentSource)
+                    _playing = true;
+                else
+                    _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
+                dynamic_pointer_cast<Image>(_currentSource)->zero();
+            }
+            _nextSource.reset();
+            _nextSourceIndex = -1;
             _currentSource->setName(_name + DISTANT_NAME_SUFFIX);
 
-            _currentSource->setAttribute("file", {sourceParameters.filename});
+            if (!prerolled)
+                _currentSource->setAttribute("file", {sourceParameters.filename});
 
             if (_useClock && !sourceParameters.freeRun)
             {
@@ -145,12 +176,19 @@ void Queue::update()
 
             _root->sendMessage(_name, "source", {sourceParameters.type});
 
-            for (const auto& arg : sourceParameters.args)
+            if (prerolled)
+            {
+                _currentSource->setAttribute("preroll", {-1});
+            }
+            else
             {
-                if (!arg.isNamed())
-                    continue;
+                for (const auto& arg : sourceParameters.args)
+                {
+                    if (!arg.isNamed())
+                        continue;
 
-                _currentSource->setAttribute(arg.getName(), arg.as<Values>());
+                    _currentSource->setAttribute(arg.getName(), arg.as<Values>());
+                }
             }
 
             Log::get() << Log::MESSAGE << "Queue::" << __FUNCTION__ << " - Playing file: " << sourceParameters.filename << Log::endl;
@@ -164,10 +202,44 @@ void Queue::update()
         _seeked = false;
     }
 
+    prerollNextSource();
+
     if (_currentSource)
         _currentSource->update();
 }
 
+/*************/
+void Queue::prerollNextSource()
+{
+    if (_prerollDuration <= 0 || _currentSourceIndex < 0)
+        return;
+
+    auto nextIndex = _currentSourceIndex + 1;
+    if (nextIndex >= static_cast<int32_t>(_playlist.size()) || nextIndex == _nextSourceIndex)
+        return;
+
+    const auto& sourceParameters = _playlist[nextIndex];
+    if (sourceParameters.type != "image_ffmpeg" || sourceParameters.start - _currentTime > _prerollDuration)
+        return;
+
+    _nextSource = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
+    _nextSourceIndex = nextIndex;
+    if (!_nextSource)
+        return;
+
+    _nextSource->setAttribute("file", {sourceParameters.filename});
+    for (const auto& arg : sourceParameters.args)
+    {
+        if (!arg.isNamed())
+            continue;
+
+        _nextSource->setAttribute(arg.getName(), arg.as<Values>());
+    }
+    _nextSource->setAttribute("preroll", {0.f});
+
+    Log::get() << Log::MESSAGE << "Queue::" << __FUNCTION__ << " - Prerolling file: " << sourceParameters.filename << Log::endl;
+}
+
 /*************/
 void Queue::cleanPlaylist(vector<Source>& playlist)
 {
@@ -326,6 +398,8 @@ void Queue::registerAttributes()
 
             cleanPlaylist(playlist);
             _playlist = playlist;
+            _nextSource.reset();
+            _nextSourceIndex = -1;
 
             return true;
         },
@@ -350,8 +424,18 @@ void Queue::registerAttributes()
         });
     setAttributeDescription("playlist", "Set the playlist as an array of [type, filename, start, end, (args)]");
 
+    addAttribute("preroll",
+        [&](const Values& args) {
+            _prerollDuration = static_cast<int64_t>(max(0.f, args[0].as<float>()) * 1e6);
+            return true;
+        },
+        [&]() -> Values { return {static_cast<float>(_prerollDuration) / 1e6f}; },
+        {'n'});
+    setAttributeDescription("preroll", "Time (in seconds) before its start at which a video source is opened and buffered, 0 to disable");
+
     addAttribute("elapsed", [&](const Values& /*args*/) { return true; }, [&]() -> Values { return {static_cast<float>(_currentTime / 1e6)}; }, {'n'});
     setAttributeDescription("elapsed", "Time elapsed since the beginning of the queue");
+    setAttributeVolatile("elapsed", true);
 
     addAttribute("seek",
         [&](const Values& args) {
@@ -83,6 +83,19 @@ class Queue : public BufferObject
      */
     std::shared_ptr<SerializedObject> serialize() const override;
 
+    /**
+     * \brief Serialize the underlying source into memory given by the caller
+     * \param allocate Allocation function
+     * \return Return the serialized object
+     */
+    std::shared_ptr<SerializedObject> serializeInto(const std::function<ResizableArray<uint8_t>(size_t)>& allocate) const override;
+
+    /**
+     * \brief Share the underlying source with objects living in the same process
+     * \return Return the serialized object
+     */
+    std::shared_ptr<SerializedObject> share() const override;
+
     /**
      * \brief Returns always true, the Queue object handles update itself
      * \return Return true if the queue was updated
@@ -113,6 +126,9 @@ class Queue : public BufferObject
     bool _paused{false};
 
     std::shared_ptr<BufferObject> _currentSource; // The source being played
+    std::shared_ptr<BufferObject> _nextSource;    // The next source, prerolled before its start
+    int32_t _nextSourceIndex{-1};
+    int64_t _prerollDuration{2000000}; // Time before its start at which a source is prerolled, in us
 
     int32_t _currentSourceIndex{-1};
     bool _playing{false};
@@ -129,6 +145,11 @@ class Queue : public BufferObject
      */
     void cleanPlaylist(std::vector<Source>& playlist);
 
+    /**
+     * \brief Open the source following the current one and let it buffer its first frames
+     */
+    void prerollNextSource();
+
     /**
      * Regist\brief er new functors to modify attributes
      */
@@ -0,0 +1,139 @@
+#include "./image/video_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+namespace Splash
+{
+
+namespace
+{
+constexpr char cacheMagic[8] = {'S', 'P', 'L', 'V', 'I', 'D', 'X', '\0'};
+constexpr uint32_t cacheVersion = 1;
+
+struct CacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t padding;
+    uint64_t mediaSize;
+    int64_t mediaTime;
+    uint64_t frameCount;
+    uint64_t keyframeCount;
+};
+} // namespace
+
+/*************/
+void VideoIndex::addFrame(int64_t pts, bool keyframe)
+{
+    _frames.push_back(pts);
+    if (keyframe)
+        _keyframes.push_back(pts);
+}
+
+/*************/
+void VideoIndex::finalize()
+{
+    // Packets come in decoding order, which differs from presentation order with B-frames
+    sort(_frames.begin(), _frames.end());
+    _frames.erase(unique(_frames.begin(), _frames.end()), _frames.end());
+    sort(_keyframes.begin(), _keyframes.end());
+    _keyframes.erase(unique(_keyframes.begin(), _keyframes.end()), _keyframes.end());
+}
+
+/*************/
+void VideoIndex::clear()
+{
+    _frames.clear();
+    _keyframes.clear();
+}
+
+/*************/
+optional<int64_t> VideoIndex::getFrameAt(int64_t pts) const
+{
+    auto it = upper_bound(_frames.begin(), _frames.end(), pts);
+    if (it == _frames.begin())
+        return {};
+    return *(--it);
+}
+
+/*************/
+optional<int64_t> VideoIndex::getKeyframeBefore(int64_t pts) const
+{
+    auto it = upper_bound(_keyframes.begin(), _keyframes.end(), pts);
+    if (it == _keyframes.begin())
+        return {};
+    return *(--it);
+}
+
+/*************/
+int64_t VideoIndex::getMaxKeyframeInterval() const
+{
+    int64_t interval = 0;
+    for (size_t i = 1; i < _keyframes.size(); ++i)
+        interval = max(interval, _keyframes[i] - _keyframes[i - 1]);
+    if (!_keyframes.empty() && !_frames.empty())
+        interval = max(interval, _frames.back() - _keyframes.back());
+    return interval;
+}
+
+/*************/
+bool VideoIndex::load(const string& path, uint64_t mediaSize, int64_t mediaTime)
+{
+    ifstream file(path, ios::in | ios::binary);
+    if (!file.is_open())
+        return false;
+
+    CacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+
+    if (memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion)
+        return false;
+
+    // The cache is outdated if the media changed since it was written
+    if (header.mediaSize != mediaSize || header.mediaTime != mediaTime)
+        return false;
+
+    if (header.keyframeCount > header.frameCount)
+        return false;
+
+    vector<int64_t> frames(header.frameCount);
+    vector<int64_t> keyframes(header.keyframeCount);
+    if (!file.read(reinterpret_cast<char*>(frames.data()), frames.size() * sizeof(int64_t)))
+        return false;
+    if (!file.read(reinterpret_cast<char*>(keyframes.data()), keyframes.size() * sizeof(int64_t)))
+        return false;
+
+    _frames = std::move(frames);
+    _keyframes = std::move(keyframes);
+    return true;
+}
+
+/*************/
+bool VideoIndex::save(const string& path, uint64_t mediaSize, int64_t mediaTime) const
+{
+    ofstream file(path, ios::out | ios::binary | ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = cacheVersion;
+    header.mediaSize = mediaSize;
+    header.mediaTime = mediaTime;
+    header.frameCount = _frames.size();
+    header.keyframeCount = _keyframes.size();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(_frames.data()), _frames.size() * sizeof(int64_t));
+    file.write(reinterpret_cast<const char*>(_keyframes.data()), _keyframes.size() * sizeof(int64_t));
+
+    return file.good();
+}
+
+} // namespace Splash
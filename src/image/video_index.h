@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @video_index.h
+ * The VideoIndex class, holding the timestamps of all frames and keyframes of a video stream
+ * It is built by reading the packets of a media file, and can be cached on disk next to the media.
+ */
+
+#ifndef SPLASH_VIDEO_INDEX_H
+#define SPLASH_VIDEO_INDEX_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Splash
+{
+
+/*************/
+class VideoIndex
+{
+  public:
+    /**
+     * \brief Get the path of the cache file for the given media
+     * \param mediaPath Path to the media
+     * \return Return the path to the cache file
+     */
+    static std::string getCachePath(const std::string& mediaPath) { return mediaPath + ".splashidx"; }
+
+    /**
+     * \brief Add a frame to the index. Frames can be added in decoding order.
+     * \param pts Frame presentation timestamp, in stream time base
+     * \param keyframe True if the frame is a keyframe
+     */
+    void addFrame(int64_t pts, bool keyframe);
+
+    /**
+     * \brief Sort the frames in presentation order. Must be called once all frames are added.
+     */
+    void finalize();
+
+    /**
+     * \brief Clear the index
+     */
+    void clear();
+
+    /**
+     * \brief Check whether the index is empty
+     * \return Return true if empty
+     */
+    bool empty() const { return _frames.empty(); }
+
+    /**
+     * \brief Get the frame count
+     * \return Return the number of frames
+     */
+    size_t getFrameCount() const { return _frames.size(); }
+
+    /**
+     * \brief Get the keyframe count
+     * \return Return the number of keyframes
+     */
+    size_t getKeyframeCount() const { return _keyframes.size(); }
+
+    /**
+     * \brief Get the last frame starting at or before the given timestamp
+     * \param pts Timestamp, in stream time base
+     * \return Return the frame timestamp, or nothing if no frame matches
+     */
+    std::optional<int64_t> getFrameAt(int64_t pts) const;
+
+    /**
+     * \brief Get the last keyframe starting at or before the given timestamp
+     * \param pts Timestamp, in stream time base
+     * \return Return the keyframe timestamp, or nothing if no keyframe matches
+     */
+    std::optional<int64_t> getKeyframeBefore(int64_t pts) const;
+
+    /**
+     * \brief Get the largest interval between two successive keyframes
+     * \return Return the interval, in stream time base
+     */
+    int64_t getMaxKeyframeInterval() const;
+
+    /**
+     * \brief Load the index from a cache file
+     * \param path Path to the cache file
+     * \param mediaSize Size of the indexed media, which must match the one stored in the cache
+     * \param mediaTime Modification time of the indexed media, which must match the one stored in the cache
+     * \return Return true if the cache was loaded
+     */
+    bool load(const std::string& path, uint64_t mediaSize, int64_t mediaTime);
+
+    /**
+     * \brief Save the index to a cache file
+     * \param path Path to the cache file
+     * \param mediaSize Size of the indexed media
+     * \param mediaTime Modification time of the indexed media
+     * \return Return true if the cache was written
+     */
+    bool save(const std::string& path, uint64_t mediaSize, int64_t mediaTime) const;
+
+  private:
+    std::vector<int64_t> _frames{};    //!< Frame timestamps, sorted in presentation order
+    std::vector<int64_t> _keyframes{}; //!< Keyframe timestamps, sorted in presentation order
+};
+
+} // namespace Splash
+
+#endif // SPLASH_VIDEO_INDEX_H
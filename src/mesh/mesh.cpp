@@ -1,5 +1,8 @@
 #include "./mesh/mesh.h"
 
+#include <cstring>
+#include <limits>
+
 #include "./core/root_object.h"
 #include "./mesh/meshloader.h"
 #include "./utils/log.h"
@@ -53,7 +56,7 @@ vector<float> Mesh::getVertCoords() const
 {
     lock_guard<Spinlock> lock(_readMutex);
     vector<float> coords;
-    for (auto& v : _mesh.vertices)
+    for (auto& v : _mesh->vertices)
     {
         coords.push_back(v[0]);
         coords.push_back(v[1]);
@@ -68,7 +71,7 @@ vector<float> Mesh::getUVCoords() const
 {
     lock_guard<Spinlock> lock(_readMutex);
     vector<float> coords;
-    for (auto& u : _mesh.uvs)
+    for (auto& u : _mesh->uvs)
     {
         coords.push_back(u[0]);
         coords.push_back(u[1]);
@@ -81,7 +84,7 @@ vector<float> Mesh::getNormals() const
 {
     lock_guard<Spinlock> lock(_readMutex);
     vector<float> normals;
-    for (auto& n : _mesh.normals)
+    for (auto& n : _mesh->normals)
     {
         normals.push_back(n[0]);
         normals.push_back(n[1]);
@@ -96,7 +99,7 @@ vector<float> Mesh::getAnnexe() const
 {
     lock_guard<Spinlock> lock(_readMutex);
     vector<float> annexe;
-    for (auto& a : _mesh.annexe)
+    for (auto& a : _mesh->annexe)
     {
         annexe.push_back(a[0]);
         annexe.push_back(a[1]);
@@ -106,6 +109,34 @@ vector<float> Mesh::getAnnexe() const
     return annexe;
 }
 
+/*************/
+shared_ptr<const MeshBVH> Mesh::getBVH() const
+{
+    lock_guard<Spinlock> lock(_readMutex);
+    return _mesh->bvh;
+}
+
+/*************/
+float Mesh::pickVertex(const glm::vec3& p, glm::vec3& v) const
+{
+    lock_guard<Spinlock> lock(_readMutex);
+    if (_mesh->bvh)
+        return _mesh->bvh->findClosestVertex(_mesh->vertices, p, v);
+
+    float distance = numeric_limits<float>::max();
+    for (const auto& vertex : _mesh->vertices)
+    {
+        float dist = glm::length(p - glm::vec3(vertex));
+        if (dist < distance)
+        {
+            v = glm::vec3(vertex);
+            distance = dist;
+        }
+    }
+
+    return distance;
+}
+
 /*************/
 bool Mesh::read(const string& filename)
 {
@@ -124,7 +155,7 @@ bool Mesh::read(const string& filename)
         mesh.normals = objLoader.getNormals();
 
         lock_guard<shared_mutex> lock(_writeMutex);
-        _mesh = mesh;
+        _mesh = make_shared<const MeshContainer>(std::move(mesh));
         updateTimestamp();
     }
 
@@ -134,36 +165,57 @@ bool Mesh::read(const string& filename)
 /*************/
 shared_ptr<SerializedObject> Mesh::serialize() const
 {
-    auto obj = make_shared<SerializedObject>();
+    return serializeInto({});
+}
 
+/*************/
+shared_ptr<SerializedObject> Mesh::serializeInto(const function<ResizableArray<uint8_t>(size_t)>& allocate) const
+{
     if (Timer::get().isDebug())
         Timer::get() << "serialize " + _name;
 
-    // For this, we will use the getVertex, getUV, etc. methods to create a serialized representation of the mesh
-    vector<vector<float>> data;
-    data.push_back(getVertCoords());
-    data.push_back(getUVCoords());
-    data.push_back(getNormals());
-    data.push_back(getAnnexe());
+    // Containers are never modified, so the current one can be serialized once the lock is released
+    shared_ptr<const MeshContainer> mesh;
+    {
+        lock_guard<Spinlock> lock(_readMutex);
+        mesh = _mesh;
+    }
 
-    lock_guard<Spinlock> lock(_readMutex);
-    int nbrVertices = data[0].size() / 4;
-    int totalSize = sizeof(nbrVertices); // We add to all this the total number of vertices
-    for (auto& d : data)
-        totalSize += d.size() * sizeof(d[0]);
-    obj->resize(totalSize);
+    // The attributes are written as arrays of floats straight from the container, normals being padded to four floats
+    int nbrVertices = mesh->vertices.size();
+    int streamed = mesh->streamed;
+    size_t totalSize = sizeof(nbrVertices) + sizeof(streamed); // We add to all this the total number of vertices and the streamed flag
+    totalSize += mesh->vertices.size() * sizeof(glm::vec4) + mesh->uvs.size() * sizeof(glm::vec2);
+    totalSize += mesh->normals.size() * sizeof(glm::vec4) + mesh->annexe.size() * sizeof(glm::vec4);
+
+    ResizableArray<uint8_t> buffer;
+    if (allocate)
+        buffer = allocate(totalSize);
+    if (buffer.size() == 0)
+        buffer = ResizableArray<uint8_t>(totalSize);
+    auto obj = make_shared<SerializedObject>(std::move(buffer));
 
     auto currentObjPtr = obj->data();
-    const char* ptr = reinterpret_cast<const char*>(&nbrVertices);
-    copy(ptr, ptr + sizeof(nbrVertices), currentObjPtr);
+    memcpy(currentObjPtr, &nbrVertices, sizeof(nbrVertices));
     currentObjPtr += sizeof(nbrVertices);
-
-    for (auto& d : data)
+    memcpy(currentObjPtr, &streamed, sizeof(streamed));
+    currentObjPtr += sizeof(streamed);
+
+    memcpy(currentObjPtr, mesh->vertices.data(), mesh->vertices.size() * sizeof(glm::vec4));
+    currentObjPtr += mesh->vertices.size() * sizeof(glm::vec4);
+    memcpy(currentObjPtr, mesh->uvs.data(), mesh->uvs.size() * sizeof(glm::vec2));
+    currentObjPtr += mesh->uvs.size() * sizeof(glm::vec2);
+    for (const auto& normal : mesh->normals)
     {
-        ptr = reinterpret_cast<const char*>(d.data());
-        copy(ptr, ptr + d.size() * sizeof(float), currentObjPtr);
-        currentObjPtr += d.size() * sizeof(float);
+        const auto paddedNormal = glm::vec4(normal, 0.f);
+        memcpy(currentObjPtr, &paddedNormal, sizeof(paddedNormal));
+        currentObjPtr += sizeof(paddedNormal);
     }
+    memcpy(currentObjPtr, mesh->annexe.data(), mesh->annexe.size() * sizeof(glm::vec4));
+
+    // Peers living in the same process share the current container
+    if (_root && _root->isConnectedToInner())
+        obj->_handle = mesh;
 
     if (Timer::get().isDebug())
         Timer::get() >> ("serialize " + _name);
@@ -171,10 +223,42 @@ shared_ptr<SerializedObject> Mesh::serialize() const
     return obj;
 }
 
+/*************/
+shared_ptr<SerializedObject> Mesh::share() const
+{
+    lock_guard<Spinlock> lock(_readMutex);
+    auto obj = make_shared<SerializedObject>();
+    obj->_handle = _mesh;
+    return obj;
+}
+
 /*************/
 bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
 {
-    if (obj.get() == nullptr || obj->size() == 0)
+    if (obj.get() == nullptr)
+        return false;
+
+    // Meshes from the same process are shared, without going through their serialized form
+    if (auto mesh = obj->getHandle<shared_ptr<const MeshContainer>>())
+    {
+        // The World does not build the hierarchy, so shared containers are copied to add it
+        if (!(*mesh)->streamed && !(*mesh)->bvh)
+        {
+            auto meshWithBVH = **mesh;
+            buildBVH(meshWithBVH);
+            _bufferMesh = make_shared<const MeshContainer>(std::move(meshWithBVH));
+        }
+        else
+        {
+            _bufferMesh = *mesh;
+        }
+        _meshUpdated = true;
+        updateTimestamp();
+        return true;
+    }
+
+    int streamed;
+    if (obj->size() < sizeof(int) + sizeof(streamed))
         return false;
 
     if (Timer::get().isDebug())
@@ -187,6 +271,9 @@ bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
     auto currentObjPtr = obj->data();
     copy(currentObjPtr, currentObjPtr + sizeof(nbrVertices), ptr); // This will fail if float have different size between sender and receiver
     currentObjPtr += sizeof(nbrVertices);
+    ptr = reinterpret_cast<char*>(&streamed);
+    copy(currentObjPtr, currentObjPtr + sizeof(streamed), ptr);
+    currentObjPtr += sizeof(streamed);
 
     if (nbrVertices < 0 || nbrVertices > static_cast<int>(obj->size()))
     {
@@ -255,7 +342,12 @@ bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
             }
         }
 
-        _bufferMesh = mesh;
+        // Streamed meshes change every frame, building their hierarchy would cost more than it saves
+        mesh.streamed = streamed;
+        if (!mesh.streamed)
+            buildBVH(mesh);
+
+        _bufferMesh = make_shared<const MeshContainer>(std::move(mesh));
         _meshUpdated = true;
 
         updateTimestamp();
@@ -276,7 +368,7 @@ bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
 /*************/
 void Mesh::update()
 {
-    if (_meshUpdated)
+    if (_meshUpdated && _bufferMesh)
     {
         lock_guard<Spinlock> lock(_readMutex);
         shared_lock<shared_mutex> lockWrite(_writeMutex);
@@ -346,12 +438,46 @@ void Mesh::createDefaultMesh(int subdiv)
         }
     }
 
+    buildBVH(mesh);
+
     lock_guard<shared_mutex> lock(_writeMutex);
-    _mesh = std::move(mesh);
+    _mesh = make_shared<const MeshContainer>(std::move(mesh));
 
     updateTimestamp();
 }
 
+/*************/
+void Mesh::buildBVH(MeshContainer& mesh)
+{
+    mesh.bvh.reset();
+
+    // All per-vertex attributes are sorted along with the vertices, so they have to match
+    const auto vertexCount = mesh.vertices.size();
+    if (mesh.uvs.size() != vertexCount || mesh.normals.size() != vertexCount || (!mesh.annexe.empty() && mesh.annexe.size() != vertexCount))
+        return;
+
+    auto bvh = make_shared<MeshBVH>();
+    auto order = bvh->build(mesh.vertices);
+    if (bvh->empty())
+        return;
+
+    const auto sortTriangles = [&](auto& attribute) {
+        if (attribute.empty())
+            return;
+        auto sorted = attribute;
+        for (size_t t = 0; t < order.size(); ++t)
+            for (size_t v = 0; v < 3; ++v)
+                sorted[t * 3 + v] = attribute[order[t] * 3 + v];
+        attribute = std::move(sorted);
+    };
+
+    sortTriangles(mesh.vertices);
+    sortTriangles(mesh.uvs);
+    sortTriangles(mesh.normals);
+    sortTriangles(mesh.annexe);
+    mesh.bvh = bvh;
+}
+
 /*************/
 void Mesh::registerAttributes()
 {
@@ -36,6 +36,7 @@
 #include "./core/attribute.h"
 #include "./core/buffer_object.h"
 #include "./core/coretypes.h"
+#include "./mesh/mesh_bvh.h"
 
 namespace Splash
 {
@@ -92,6 +93,20 @@ class Mesh : public BufferObject
      */
     virtual std::vector<float> getAnnexe() const;
 
+    /**
+     * \brief Get the bounding volume hierarchy of the mesh, matching the order of getVertCoords()
+     * \return Return the hierarchy, or nullptr if the mesh has none
+     */
+    std::shared_ptr<const MeshBVH> getBVH() const;
+
+    /**
+     * \brief Get the coordinates of the closest vertex to the given point
+     * \param p Point around which to look
+     * \param v If detected, vertex coordinates
+     * \return Return the distance from p to v
+     */
+    float pickVertex(const glm::vec3& p, glm::vec3& v) const;
+
     /**
      * \brief Read / update the mesh
      * \param filename File to load from
@@ -105,6 +120,19 @@ class Mesh : public BufferObject
      */
     std::shared_ptr<SerializedObject> serialize() const override;
 
+    /**
+     * \brief Serialize the mesh into memory given by the caller
+     * \param allocate Allocation function
+     * \return Return the serialized mesh
+     */
+    std::shared_ptr<SerializedObject> serializeInto(const std::function<ResizableArray<uint8_t>(size_t)>& allocate) const override;
+
+    /**
+     * \brief Share the mesh with objects living in the same process
+     * \return Return a serialized object holding the mesh
+     */
+    std::shared_ptr<SerializedObject> share() const override;
+
     /**
      * \brief Set the mesh from a serialized representation
      * \param obj Serialized object
@@ -124,11 +152,14 @@ class Mesh : public BufferObject
         std::vector<glm::vec2> uvs;
         std::vector<glm::vec3> normals;
         std::vector<glm::vec4> annexe;
+        std::shared_ptr<const MeshBVH> bvh{nullptr}; //!< Hierarchy over the triangles, if built
+        bool streamed{false};                        //!< True if the mesh is replaced continuously, in which case no hierarchy is built
     };
 
     std::string _filepath{};
-    MeshContainer _mesh;
-    MeshContainer _bufferMesh;
+    // Containers are never modified once created, so that they can be shared with the peers living in the same process
+    std::shared_ptr<const MeshContainer> _mesh{std::make_shared<const MeshContainer>()};
+    std::shared_ptr<const MeshContainer> _bufferMesh{nullptr};
     bool _meshUpdated{false};
     bool _benchmark{false};
     int _planeSubdivisions{0};
@@ -138,6 +169,13 @@ class Mesh : public BufferObject
      */
     void registerAttributes();
 
+    /**
+     * \brief Build the bounding volume hierarchy of the given mesh, reordering its triangles to match it
+     * Hierarchies are only used for drawing and picking, so they are built by the Scenes when receiving a mesh
+     * \param mesh Mesh
+     */
+    static void buildBVH(MeshContainer& mesh);
+
   private:
     void init();
 
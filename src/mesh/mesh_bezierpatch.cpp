@@ -71,7 +71,7 @@ void Mesh_BezierPatch::createPatch(int width, int height)
     height = std::max(2, height);
 
     // Check whether the current patch has the same size
-    if (_bezierControl.vertices.size() != 0 && _patch.size.x == width && _patch.size.y == height)
+    if (_bezierControl && _bezierControl->vertices.size() != 0 && _patch.size.x == width && _patch.size.y == height)
         return;
 
     Patch patch;
@@ -146,7 +146,7 @@ void Mesh_BezierPatch::createPatch(Patch& patch)
             mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
         }
     }
-    _bezierControl = mesh;
+    _bezierControl = make_shared<const MeshContainer>(std::move(mesh));
 
     updateTimestamp();
 }
@@ -232,8 +232,8 @@ void Mesh_BezierPatch::updatePatch()
         }
     }
 
-    _bufferMesh = mesh;
-    _bezierMesh = mesh;
+    _bezierMesh = make_shared<const MeshContainer>(std::move(mesh));
+    _bufferMesh = _bezierMesh;
 
     updateTimestamp();
     _meshUpdated = true;
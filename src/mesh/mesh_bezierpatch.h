@@ -91,8 +91,8 @@ class Mesh_BezierPatch : public Mesh
     std::mutex _patchMutex{};
 
     bool _patchUpdated{true};
-    MeshContainer _bezierControl;
-    MeshContainer _bezierMesh;
+    std::shared_ptr<const MeshContainer> _bezierControl{nullptr};
+    std::shared_ptr<const MeshContainer> _bezierMesh{nullptr};
 
     std::vector<float> _binomialCoeffsX{};
     std::vector<float> _binomialCoeffsY{};
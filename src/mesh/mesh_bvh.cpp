@@ -0,0 +1,241 @@
+#include "./mesh/mesh_bvh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace std;
+using namespace glm;
+
+namespace Splash
+{
+
+/*************/
+vector<uint32_t> MeshBVH::build(const vector<vec4>& vertices)
+{
+    _nodes.clear();
+
+    if (vertices.empty() || vertices.size() % 3 != 0)
+        return {};
+
+    const uint32_t triangleCount = vertices.size() / 3;
+    vector<uint32_t> order(triangleCount);
+    iota(order.begin(), order.end(), 0);
+
+    vector<vec3> centroids(triangleCount);
+    vector<vec3> normals(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; ++t)
+    {
+        const vec3 a(vertices[t * 3]);
+        const vec3 b(vertices[t * 3 + 1]);
+        const vec3 c(vertices[t * 3 + 2]);
+        centroids[t] = (a + b + c) / 3.f;
+
+        // Counter-clockwise triangles are front facing, as for the GL default
+        const vec3 normal = cross(b - a, c - a);
+        const float normalLength = length(normal);
+        normals[t] = normalLength > 0.f ? normal / normalLength : vec3(0.f);
+    }
+
+    _nodes.reserve(2 * (triangleCount / leafTriangleCount + 1));
+    buildNode(vertices, centroids, normals, order, 0, triangleCount);
+
+    return order;
+}
+
+/*************/
+uint32_t MeshBVH::buildNode(
+    const vector<vec4>& vertices, const vector<vec3>& centroids, const vector<vec3>& normals, vector<uint32_t>& order, uint32_t begin, uint32_t end)
+{
+    const uint32_t index = _nodes.size();
+    _nodes.emplace_back();
+
+    Node node;
+    node.first = begin * 3;
+    node.count = (end - begin) * 3;
+    node.min = vec3(numeric_limits<float>::max());
+    node.max = vec3(numeric_limits<float>::lowest());
+
+    vec3 normalSum(0.f);
+    for (uint32_t t = begin; t < end; ++t)
+    {
+        const auto triangle = order[t];
+        for (uint32_t v = 0; v < 3; ++v)
+        {
+            const vec3 position(vertices[triangle * 3 + v]);
+            node.min = glm::min(node.min, position);
+            node.max = glm::max(node.max, position);
+        }
+        normalSum += normals[triangle];
+    }
+
+    // Cone holding all the face normals, degenerate triangles being ignored as they are never rasterized
+    const float normalSumLength = length(normalSum);
+    if (normalSumLength > 0.f)
+    {
+        node.coneAxis = normalSum / normalSumLength;
+        float minDot = 1.f;
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            const auto& normal = normals[order[t]];
+            if (normal != vec3(0.f))
+                minDot = std::min(minDot, dot(node.coneAxis, normal));
+        }
+        if (minDot > 0.f)
+            node.coneCutoff = sqrt(1.f - minDot * minDot);
+    }
+
+    if (end - begin > leafTriangleCount)
+    {
+        // Split at the median of the centroids, along their largest extent
+        vec3 centroidMin(numeric_limits<float>::max());
+        vec3 centroidMax(numeric_limits<float>::lowest());
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            centroidMin = glm::min(centroidMin, centroids[order[t]]);
+            centroidMax = glm::max(centroidMax, centroids[order[t]]);
+        }
+        const vec3 extent = centroidMax - centroidMin;
+        const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+        const uint32_t middle = begin + (end - begin) / 2;
+        nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](uint32_t lhs, uint32_t rhs) { return centroids[lhs][axis] < centroids[rhs][axis]; });
+
+        node.left = buildNode(vertices, centroids, normals, order, begin, middle);
+        node.right = buildNode(vertices, centroids, normals, order, middle, end);
+    }
+
+    _nodes[index] = node;
+    return index;
+}
+
+/*************/
+void MeshBVH::cull(const mat4& modelViewProjectionMatrix, const vec3& eye, int faceCulling, vector<Range>& ranges) const
+{
+    ranges.clear();
+    if (_nodes.empty())
+        return;
+
+    // Frustum planes in mesh space, extracted from the rows of the matrix
+    const auto row = [&](int i) { return vec4(modelViewProjectionMatrix[0][i], modelViewProjectionMatrix[1][i], modelViewProjectionMatrix[2][i], modelViewProjectionMatrix[3][i]); };
+    vec4 planes[6];
+    for (int i = 0; i < 3; ++i)
+    {
+        planes[i * 2] = row(3) + row(i);
+        planes[i * 2 + 1] = row(3) - row(i);
+    }
+
+    const auto addRange = [&](const Node& node) {
+        if (!ranges.empty() && ranges.back().first + ranges.back().count == node.first)
+            ranges.back().count += node.count;
+        else
+            ranges.push_back({node.first, node.count});
+    };
+
+    // Depth-first traversal, the left child first so that ranges are found in increasing order.
+    // Each entry holds a node and the planes it still has to be tested against, as children of a node
+    // lying entirely on the inner side of a plane do so too.
+    const uint32_t allPlanes = 0x3F;
+    pair<uint32_t, uint32_t> stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = {0, allPlanes};
+
+    while (stackSize > 0)
+    {
+        const auto [nodeIndex, parentPlanes] = stack[--stackSize];
+        const auto& node = _nodes[nodeIndex];
+
+        uint32_t planeMask = parentPlanes;
+        bool outside = false;
+        for (int p = 0; p < 6 && !outside; ++p)
+        {
+            if (!(planeMask & (1 << p)))
+                continue;
+
+            const vec3 normal(planes[p]);
+            const vec3 farthest(normal.x >= 0.f ? node.max.x : node.min.x, normal.y >= 0.f ? node.max.y : node.min.y, normal.z >= 0.f ? node.max.z : node.min.z);
+            const vec3 nearest(normal.x >= 0.f ? node.min.x : node.max.x, normal.y >= 0.f ? node.min.y : node.max.y, normal.z >= 0.f ? node.min.z : node.max.z);
+            if (dot(normal, farthest) + planes[p].w < 0.f)
+                outside = true;
+            else if (dot(normal, nearest) + planes[p].w >= 0.f)
+                planeMask &= ~(1u << p);
+        }
+        if (outside)
+            continue;
+
+        // All faces of the node are culled if the eye lies outside of the cone of the directions they can be seen from
+        if (faceCulling != 0 && node.coneCutoff <= 1.f)
+        {
+            const vec3 toCenter = (node.min + node.max) * 0.5f - eye;
+            const float radius = length(node.max - node.min) * 0.5f;
+            if (dot(toCenter, node.coneAxis * static_cast<float>(faceCulling)) >= node.coneCutoff * length(toCenter) + radius)
+                continue;
+        }
+
+        if (node.left == 0 || (planeMask == 0 && faceCulling == 0))
+        {
+            addRange(node);
+            continue;
+        }
+
+        stack[stackSize++] = {node.right, planeMask};
+        stack[stackSize++] = {node.left, planeMask};
+    }
+}
+
+/*************/
+float MeshBVH::findClosestVertex(const vector<vec4>& vertices, const vec3& point, vec3& closest) const
+{
+    float bestDistance = numeric_limits<float>::max();
+    if (_nodes.empty() || vertices.size() < getVertexCount())
+        return bestDistance;
+
+    // Distances are compared squared, nodes farther than the best vertex found so far being skipped
+    const auto boxDistance = [&](const Node& node) {
+        const vec3 delta = glm::max(glm::max(node.min - point, point - node.max), vec3(0.f));
+        return dot(delta, delta);
+    };
+
+    uint32_t stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const auto& node = _nodes[stack[--stackSize]];
+        if (boxDistance(node) >= bestDistance)
+            continue;
+
+        if (node.left == 0)
+        {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const vec3 delta = vec3(vertices[i]) - point;
+                const float distance = dot(delta, delta);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    closest = vec3(vertices[i]);
+                }
+            }
+            continue;
+        }
+
+        // The nearest child is visited first
+        if (boxDistance(_nodes[node.left]) < boxDistance(_nodes[node.right]))
+        {
+            stack[stackSize++] = node.right;
+            stack[stackSize++] = node.left;
+        }
+        else
+        {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+
+    return bestDistance == numeric_limits<float>::max() ? bestDistance : sqrt(bestDistance);
+}
+
+} // namespace Splash
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @mesh_bvh.h
+ * The MeshBVH class, a bounding volume hierarchy over the triangles of a mesh
+ * Triangles are sorted so that each node covers a contiguous range of vertices, which
+ * allows for drawing only the parts of a mesh seen by a camera, and for fast vertex picking.
+ */
+
+#ifndef SPLASH_MESH_BVH_H
+#define SPLASH_MESH_BVH_H
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Splash
+{
+
+/*************/
+class MeshBVH
+{
+  public:
+    struct Node
+    {
+        glm::vec3 min{0.f};
+        glm::vec3 max{0.f};
+        glm::vec3 coneAxis{0.f}; //!< Mean direction of the faces of the node
+        float coneCutoff{2.f};   //!< Sine of the half angle of the cone holding all face normals, greater than 1 if they can not be culled together
+        uint32_t first{0};       //!< First vertex covered by the node
+        uint32_t count{0};       //!< Number of vertices covered by the node
+        uint32_t left{0};        //!< Index of the first child, 0 for leaves
+        uint32_t right{0};       //!< Index of the second child, 0 for leaves
+    };
+
+    struct Range
+    {
+        uint32_t first{0};
+        uint32_t count{0};
+    };
+
+    static constexpr uint32_t leafTriangleCount{1024}; //!< Maximum number of triangles per leaf
+
+  public:
+    /**
+     * \brief Build the hierarchy for the given triangles
+     * \param vertices Vertices, three per triangle
+     * \return Return the new order of the triangles, the i-th triangle of the hierarchy being the order[i]-th one of the input.
+     * The vertices (and all other per-vertex attributes) must be reordered accordingly before being used with the hierarchy.
+     */
+    std::vector<uint32_t> build(const std::vector<glm::vec4>& vertices);
+
+    /**
+     * \brief Check whether the hierarchy is empty
+     * \return Return true if it has not been built
+     */
+    bool empty() const { return _nodes.empty(); }
+
+    /**
+     * \brief Get the number of vertices covered by the hierarchy
+     * \return Return the vertex count
+     */
+    uint32_t getVertexCount() const { return _nodes.empty() ? 0 : _nodes[0].count; }
+
+    /**
+     * \brief Get the nodes, the first one being the root
+     * \return Return the nodes
+     */
+    const std::vector<Node>& getNodes() const { return _nodes; }
+
+    /**
+     * \brief Get the ranges of vertices which may be seen through the given matrix, adjacent ranges being merged
+     * \param modelViewProjectionMatrix Matrix projecting the mesh to clip space
+     * \param eye Position of the eye in mesh space, for face culling
+     * \param faceCulling Set to 1 to cull back faces, -1 to cull front faces, 0 to keep all faces
+     * \param ranges Visible ranges, cleared beforehand
+     */
+    void cull(const glm::mat4& modelViewProjectionMatrix, const glm::vec3& eye, int faceCulling, std::vector<Range>& ranges) const;
+
+    /**
+     * \brief Find the vertex closest to the given point
+     * \param vertices Vertices, sorted as returned by build()
+     * \param point Point
+     * \param closest Closest vertex, if found
+     * \return Return the distance to the closest vertex, or the maximum float value if none was found
+     */
+    float findClosestVertex(const std::vector<glm::vec4>& vertices, const glm::vec3& point, glm::vec3& closest) const;
+
+  private:
+    std::vector<Node> _nodes{};
+
+    /**
+     * \brief Build a node and its children, sorting their triangles
+     * \param vertices Input vertices
+     * \param centroids Centroids of the input triangles
+     * \param normals Unit normals of the input triangles, null for degenerate ones
+     * \param order Order of the triangles, sorted in place
+     * \param begin First triangle of the node, in order
+     * \param end Triangle past the last one of the node, in order
+     * \return Return the index of the node
+     */
+    uint32_t buildNode(const std::vector<glm::vec4>& vertices,
+        const std::vector<glm::vec3>& centroids,
+        const std::vector<glm::vec3>& normals,
+        std::vector<uint32_t>& order,
+        uint32_t begin,
+        uint32_t end);
+};
+
+} // namespace Splash
+
+#endif // SPLASH_MESH_BVH_H
@@ -87,6 +87,7 @@ void Mesh_Shmdata::onData(void* data, int /*data_size*/)
     intPtr += 8 * verticeNbr;
     // Then create the faces
     MeshContainer newMesh;
+    newMesh.streamed = true;
     for (int p = 0; p < polyNbr; ++p)
     {
         int size = *(intPtr++);
@@ -118,7 +119,7 @@ void Mesh_Shmdata::onData(void* data, int /*data_size*/)
     if (Timer::get().isDebug())
         Timer::get() << "mesh_shmdata " + _name;
 
-    _bufferMesh = std::move(newMesh);
+    _bufferMesh = make_shared<const MeshContainer>(std::move(newMesh));
     _meshUpdated = true;
     updateTimestamp();
 
@@ -50,6 +50,7 @@ void Sink_Shmdata::registerAttributes()
 
     addAttribute("caps", [&](const Values&) { return true; }, [&]() -> Values { return {_caps}; }, {'s'});
     setAttributeDescription("caps", "Caps of the sent data");
+    setAttributeVolatile("caps", true);
 }
 
 } // end of namespace
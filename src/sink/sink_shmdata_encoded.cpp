@@ -259,6 +259,7 @@ void Sink_Shmdata_Encoded::registerAttributes()
 
     addAttribute("caps", [&](const Values&) { return true; }, [&]() -> Values { return {_caps}; });
     setAttributeDescription("caps", "Generated caps");
+    setAttributeVolatile("caps", true);
 
     addAttribute("codec",
         [&](const Values& args) {
@@ -296,6 +297,7 @@ void Sink_Shmdata_Encoded::registerAttributes()
 
     addAttribute("caps", [&](const Values&) { return true; }, [&]() -> Values { return {_caps}; }, {'s'});
     setAttributeDescription("caps", "Caps of the sent data");
+    setAttributeVolatile("caps", true);
 }
 
 } // end of namespace
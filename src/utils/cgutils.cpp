@@ -2,17 +2,39 @@
 
 #include <future>
 
+#include "./core/thread_pool.h"
+
 using namespace std;
 
 namespace Splash
 {
 
+/*************/
+ThreadPool& getHapDecodePool()
+{
+    // Hap frames are decoded from the tasks of the global ThreadPool (i.e. by Image_Shmdata), waiting there
+    // for the chunks could block all of its workers. The decode pool is thus separate, and shared by all sources.
+    static auto instance = new ThreadPool;
+    return *instance;
+}
+
 /*************/
 void hapDecodeCallback(HapDecodeWorkFunction func, void* p, unsigned int count, void* /*info*/)
 {
-    vector<future<void>> threads;
-    for (unsigned int i = 0; i < count; ++i)
-        threads.push_back(async(launch::async, [=]() { func(p, i); }));
+    if (count == 0)
+        return;
+
+    vector<future<void>> chunks;
+    chunks.reserve(count - 1);
+    auto& pool = getHapDecodePool();
+    for (unsigned int i = 1; i < count; ++i)
+        chunks.push_back(pool.enqueue([=]() { func(p, i); }));
+
+    // The calling thread decodes the first chunk instead of waiting idle
+    func(p, 0);
+
+    for (auto& chunk : chunks)
+        chunk.wait();
 }
 
 /*************/
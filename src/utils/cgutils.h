@@ -39,6 +39,8 @@
 namespace Splash
 {
 
+class ThreadPool;
+
 /*************/
 // Color stuff
 /*************/
@@ -240,7 +242,9 @@ inline glm::dmat4 getProjectionMatrix(float fov, float near, float far, float wi
 /*************/
 // HAP
 /*************/
-// Hap chunk callback
+// Get the pool decoding the Hap chunks
+ThreadPool& getHapDecodePool();
+// Hap chunk callback, decoding the chunks in parallel on the Hap decode pool
 void hapDecodeCallback(HapDecodeWorkFunction func, void* p, unsigned int count, void* info);
 // Decode a Hap frame
 // If out is null, only sets the format
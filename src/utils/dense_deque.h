@@ -20,12 +20,16 @@
 /*
  * @dense_deque.h
  * Dense double-ended queue, a cache-friendly deque based on std::vector
+ * Some free space is kept in front of the values, so that insertion at the front is amortized O(1)
  */
 
 #ifndef SPLASH_DENSE_DEQUE_H
 #define SPLASH_DENSE_DEQUE_H
 
+#include <algorithm>
 #include <initializer_list>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace Splash
@@ -38,6 +42,8 @@ class DenseDeque
     using value_type = T;
     using iterator = typename std::vector<T>::iterator;
     using const_iterator = typename std::vector<T>::const_iterator;
+    using reverse_iterator = typename std::vector<T>::reverse_iterator;
+    using const_reverse_iterator = typename std::vector<T>::const_reverse_iterator;
 
   public:
     DenseDeque() {}
@@ -64,66 +70,79 @@ class DenseDeque
     {
         if (&other == this)
             return *this;
-        _data = other._data;
+        // The free space in front of the values is not copied
+        _data.assign(other.begin(), other.end());
+        _begin = 0;
         return *this;
     }
 
-    DenseDeque(const DenseDeque<T>&& value) { operator=(value); }
+    DenseDeque(DenseDeque<T>&& value) noexcept { operator=(std::move(value)); }
     DenseDeque<T>& operator=(DenseDeque<T>&& other) noexcept
     {
         if (&other == this)
             return *this;
-        _data = other._data;
+        _data = std::move(other._data);
+        _begin = other._begin;
+        other._data.clear();
+        other._begin = 0;
         return *this;
     }
 
     // Comparison operators
-    inline bool operator==(const DenseDeque<T>& rhs) const { return _data == rhs._data; }
-    inline bool operator!=(const DenseDeque<T>& rhs) const { return _data != rhs._data; }
-    inline bool operator<(const DenseDeque<T>& rhs) const { return _data < rhs._data; }
-    inline bool operator<=(const DenseDeque<T>& rhs) const { return _data <= rhs._data; }
-    inline bool operator>(const DenseDeque<T>& rhs) const { return _data > rhs._data; }
-    inline bool operator>=(const DenseDeque<T>& rhs) const { return _data >= rhs._data; }
+    inline bool operator==(const DenseDeque<T>& rhs) const { return size() == rhs.size() && std::equal(begin(), end(), rhs.begin()); }
+    inline bool operator!=(const DenseDeque<T>& rhs) const { return !operator==(rhs); }
+    inline bool operator<(const DenseDeque<T>& rhs) const { return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end()); }
+    inline bool operator<=(const DenseDeque<T>& rhs) const { return !rhs.operator<(*this); }
+    inline bool operator>(const DenseDeque<T>& rhs) const { return rhs.operator<(*this); }
+    inline bool operator>=(const DenseDeque<T>& rhs) const { return !operator<(rhs); }
 
     // Element access
-    inline T& at(size_t pos) { return _data.at(pos); }
-    inline const T& at(size_t pos) const { return _data.at(pos); }
-    inline T& operator[](size_t pos) { return _data[pos]; }
-    inline const T& operator[](size_t pos) const { return _data[pos]; }
-    inline T& front() { return _data.front(); }
-    inline const T& front() const { return _data.front(); }
+    inline T& at(size_t pos) { return _data.at(checkPosition(pos)); }
+    inline const T& at(size_t pos) const { return _data.at(checkPosition(pos)); }
+    inline T& operator[](size_t pos) { return _data[_begin + pos]; }
+    inline const T& operator[](size_t pos) const { return _data[_begin + pos]; }
+    inline T& front() { return _data[_begin]; }
+    inline const T& front() const { return _data[_begin]; }
     inline T& back() { return _data.back(); }
     inline const T& back() const { return _data.back(); }
-    inline T* data() noexcept { return _data.data(); }
-    inline const T* data() const noexcept { return _data.data(); }
+    inline T* data() noexcept { return _data.data() + _begin; }
+    inline const T* data() const noexcept { return _data.data() + _begin; }
 
     // Iterators
-    inline iterator begin() noexcept { return _data.begin(); }
-    inline const_iterator begin() const noexcept { return _data.begin(); }
-    inline const_iterator cbegin() const noexcept { return _data.cbegin(); }
+    inline iterator begin() noexcept { return _data.begin() + _begin; }
+    inline const_iterator begin() const noexcept { return _data.begin() + _begin; }
+    inline const_iterator cbegin() const noexcept { return _data.cbegin() + _begin; }
 
     inline iterator end() noexcept { return _data.end(); }
     inline const_iterator end() const noexcept { return _data.end(); }
     inline const_iterator cend() const noexcept { return _data.cend(); }
 
-    inline iterator rbegin() noexcept { return _data.rbegin(); }
-    inline const_iterator rbegin() const noexcept { return _data.rbegin(); }
-    inline const_iterator rcbegin() const noexcept { return _data.rcbegin(); }
+    inline reverse_iterator rbegin() noexcept { return _data.rbegin(); }
+    inline const_reverse_iterator rbegin() const noexcept { return _data.rbegin(); }
+    inline const_reverse_iterator crbegin() const noexcept { return _data.crbegin(); }
 
-    inline iterator rend() noexcept { return _data.rend(); }
-    inline const_iterator rend() const noexcept { return _data.rend(); }
-    inline const_iterator rcend() const noexcept { return _data.rcend(); }
+    inline reverse_iterator rend() noexcept { return _data.rend() - _begin; }
+    inline const_reverse_iterator rend() const noexcept { return _data.rend() - _begin; }
+    inline const_reverse_iterator crend() const noexcept { return _data.crend() - _begin; }
 
     // Capacity
-    inline bool empty() const { return _data.empty(); }
-    inline size_t size() const { return _data.size(); }
-    inline bool max_size() const noexcept { return _data.max_size(); }
-    inline void reserve(size_t count) { _data.reserve(count); }
-    inline size_t capacity() const noexcept { return _data.capacity(); }
-    inline void shrink_to_fit() { _data.shrink_to_fit(); }
+    inline bool empty() const { return _data.size() == _begin; }
+    inline size_t size() const { return _data.size() - _begin; }
+    inline size_t max_size() const noexcept { return _data.max_size(); }
+    inline void reserve(size_t count) { _data.reserve(_begin + count); }
+    inline size_t capacity() const noexcept { return _data.capacity() - _begin; }
+    inline void shrink_to_fit()
+    {
+        shrinkFront();
+        _data.shrink_to_fit();
+    }
 
     // Modifiers
-    inline void clear() noexcept { _data.clear(); }
+    inline void clear() noexcept
+    {
+        _data.clear();
+        _begin = 0;
+    }
     inline iterator erase(const_iterator pos) { return _data.erase(pos); }
     inline iterator erase(const_iterator first, const_iterator last) { return _data.erase(first, last); }
 
@@ -134,47 +153,85 @@ class DenseDeque
     {
         return _data.emplace_back(std::forward<Args>(args)...);
     }
-    inline void pop_back() { _data.pop_back(); }
-
-    inline void push_front(const T& value)
+    inline void pop_back()
     {
-        _data.resize(_data.size() + 1);
-        for (size_t i = _data.size() - 1; i > 0; --i)
-            _data[i] = std::move(_data[i - 1]);
-        _data[0] = value;
+        _data.pop_back();
+        if (_data.size() == _begin)
+            clear();
     }
 
-    template <class... Args>
-    inline T& emplace_front(T& value, Args&&... args)
+    inline void push_front(const T& value) { push_front(T(value)); }
+    inline void push_front(T&& value)
     {
-        _data.resize(_data.size() + 1);
-        for (size_t i = _data.size() - 1; i > 0; --i)
-            _data[i] = std::move(_data[i - 1]);
-        _data[0] = value;
-        return emplace_front(value, args...);
+        reserveFront();
+        _data[--_begin] = std::move(value);
     }
-    inline T& emplace_front(T&& value)
+
+    template <class... Args>
+    inline T& emplace_front(Args&&... args)
     {
-        _data.resize(_data.size() + 1);
-        for (size_t i = _data.size() - 1; i > 0; --i)
-            _data[i] = std::move(_data[i - 1]);
-        _data[0] = value;
-        return _data[0];
+        reserveFront();
+        _data[--_begin] = T(std::forward<Args>(args)...);
+        return _data[_begin];
     }
     inline void pop_front()
     {
-        for (size_t i = 0; i < _data.size() - 1; ++i)
-            _data[i] = std::move(_data[i + 1]);
-        _data.resize(_data.size() - 1);
+        // Release the resources held by the value, the slot is kept as free space for the next push_front
+        _data[_begin++] = T();
+        if (_data.size() == _begin)
+            clear();
+        // Used as a FIFO the deque would grow forever, so the free space is dropped once larger than the values.
+        // This moves each value at most once per pop, keeping pop_front amortized O(1)
+        else if (_begin > size())
+            shrinkFront();
     }
 
-    inline void resize(size_t count, const T& value) { _data.resize(count, value); }
-    inline void resize(size_t count) { _data.resize(count); }
+    inline void resize(size_t count, const T& value) { _data.resize(_begin + count, value); }
+    inline void resize(size_t count) { _data.resize(_begin + count); }
 
-    inline void swap(DenseDeque<T>& other) { _data.swap(other._data); }
+    inline void swap(DenseDeque<T>& other)
+    {
+        _data.swap(other._data);
+        std::swap(_begin, other._begin);
+    }
 
   private:
     std::vector<T> _data;
+    size_t _begin{0}; //!< Index of the first value in _data, the slots before it being free space for push_front
+
+    /**
+     * Check that the given position is in the deque, and convert it to a position in _data
+     * \param pos Position
+     * \return Return the position in _data
+     */
+    inline size_t checkPosition(size_t pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("DenseDeque::at - position is out of range");
+        return _begin + pos;
+    }
+
+    /**
+     * Remove the free space in front of the values
+     */
+    inline void shrinkFront()
+    {
+        _data.erase(_data.begin(), _data.begin() + _begin);
+        _begin = 0;
+    }
+
+    /**
+     * Make sure that there is some free space in front of the values.
+     * The free space grows with the size of the deque, so that push_front is amortized O(1)
+     */
+    inline void reserveFront()
+    {
+        if (_begin != 0)
+            return;
+        auto freeSpace = std::max<size_t>(_data.size(), 4);
+        _data.insert(_data.begin(), freeSpace, T());
+        _begin = freeSpace;
+    }
 };
 
 } // namespace Splash
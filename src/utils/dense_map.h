@@ -21,6 +21,7 @@
  * @dense_map.h
  * Dense map, a cache friendly unordered map based on std::vector
  * It matches as much as possible std::map, check https://en.cppreference.com/w/cpp/container/map
+ * Keys are stored in a DenseSet, which switches to hashed lookups for large maps
  *
  * Known issues:
  * - modifying the DenseMap while iterating over it with a for range may invalide the std::pair references
@@ -31,6 +32,8 @@
 
 #include <initializer_list>
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "./utils/dense_set.h"
@@ -21,6 +21,10 @@
  * @dense_set.h
  * Dense set, cache-friendly ordered set based on std::vector
  * It matches as much as possible std::set, check https://en.cppreference.com/w/cpp/container/set
+ * Above a given size, lookups go through an open addressing hash index holding the positions of the values
+ *
+ * Known issues:
+ * - modifying the values through the iterators invalidates the hash index
  */
 
 #ifndef SPLASH_DENSE_SET_H
@@ -29,6 +33,7 @@
 #include <algorithm>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <vector>
 
 namespace Splash
@@ -45,17 +50,10 @@ class DenseSet
     DenseSet() = default;
     template <typename InputIt>
     DenseSet(InputIt first, InputIt last)
-        : _data(first, last)
-    {
-        for (auto it = _data.begin(); it != _data.end(); ++it)
-            _data.erase(std::remove(it + 1, _data.end(), *it), _data.end());
-    }
-    DenseSet(std::initializer_list<T> init)
-        : _data(init)
     {
-        for (auto it = _data.begin(); it != _data.end(); ++it)
-            _data.erase(std::remove(it + 1, _data.end(), *it), _data.end());
+        insert(first, last);
     }
+    DenseSet(std::initializer_list<T> init) { insert(init); }
 
     DenseSet(const DenseSet<T>& other) { operator=(other); }
     DenseSet<T>& operator=(const DenseSet<T>& other)
@@ -63,23 +61,26 @@ class DenseSet
         if (&other == this)
             return *this;
         _data = other._data;
+        _hashIndex = other._hashIndex;
         return *this;
     }
 
-    DenseSet(const DenseSet<T>&& other) { operator=(other); }
+    DenseSet(DenseSet<T>&& other) noexcept { operator=(std::move(other)); }
     DenseSet<T>& operator=(DenseSet<T>&& other) noexcept
     {
         if (&other == this)
             return *this;
-        _data = other._data;
+        _data = std::move(other._data);
+        _hashIndex = std::move(other._hashIndex);
+        other.clear();
         return *this;
     }
 
     DenseSet<T>& operator=(std::initializer_list<T> init)
     {
-        _data = init;
-        for (auto it = _data.begin(); it != _data.end(); ++it)
-            _data.erase(std::remove(it + 1, _data.end(), *it), _data.end());
+        clear();
+        insert(init);
+        return *this;
     }
 
     // Comparison operators
@@ -88,7 +89,7 @@ class DenseSet
         if (size() != rhs.size())
             return false;
         for (const auto& value : _data)
-            if (std::find(rhs._data.cbegin(), rhs._data.cend(), value) == rhs._data.cend())
+            if (rhs.find(value) == rhs._data.cend())
                 return false;
         return true;
     }
@@ -118,75 +119,196 @@ class DenseSet
     void reserve(size_t size) { _data.reserve(size); }
 
     // Modifiers
-    void clear() noexcept { _data.clear(); }
+    void clear() noexcept
+    {
+        _data.clear();
+        _hashIndex.clear();
+    }
 
     std::pair<iterator, bool> insert(const T& value)
     {
-        auto it = std::find(_data.begin(), _data.end(), value);
-        if (it != _data.end())
-            return {it, false};
+        auto position = findPosition(value);
+        if (position != _data.size())
+            return {_data.begin() + position, false};
         _data.push_back(value);
+        addToIndex(_data.size() - 1);
         return {_data.end() - 1, true};
     }
-    std::pair<iterator, bool> insert(const T&& value)
+    std::pair<iterator, bool> insert(T&& value)
     {
-        auto it = std::find(_data.begin(), _data.end(), value);
-        if (it != _data.end())
-            return {it, false};
-        _data.push_back(value);
+        auto position = findPosition(value);
+        if (position != _data.size())
+            return {_data.begin() + position, false};
+        _data.push_back(std::move(value));
+        addToIndex(_data.size() - 1);
         return {_data.end() - 1, true};
     }
     template <class InputIt>
     void insert(InputIt first, InputIt last)
     {
-        _data.insert(_data.end(), first, last);
-        for (auto it = _data.begin(); it != _data.end(); ++it)
-            _data.erase(std::remove(it + 1, _data.end(), *it), _data.end());
+        for (auto it = first; it != last; ++it)
+            insert(*it);
     }
     void insert(std::initializer_list<T> init)
     {
-        _data.insert(_data.end(), init);
-        for (auto it = _data.begin(); it != _data.end(); ++it)
-            _data.erase(std::remove(it + 1, _data.end(), *it), _data.end());
+        for (const auto& value : init)
+            insert(value);
     }
 
     template <class... Args>
     std::pair<iterator, bool> emplace(Args&&... args)
     {
         auto value = T(std::forward<Args>(args)...);
-        if (std::find(_data.cbegin(), _data.cend(), value) != _data.cend())
-            return {_data.end(), false};
+        auto position = findPosition(value);
+        if (position != _data.size())
+            return {_data.begin() + position, false};
         auto it = _data.emplace(_data.end(), std::move(value));
+        addToIndex(_data.size() - 1);
         return {it, true};
     }
 
-    iterator erase(const_iterator pos) { return _data.erase(pos); }
-    iterator erase(const_iterator first, const_iterator last) { return _data.erase(first, last); }
+    iterator erase(const_iterator pos)
+    {
+        removeFromIndex(std::distance(_data.cbegin(), pos));
+        return _data.erase(pos);
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto it = _data.erase(first, last);
+        rebuildIndex();
+        return it;
+    }
     size_t erase(const T& key)
     {
-        auto it = std::find(_data.cbegin(), _data.cend(), key);
-        if (it == _data.cend())
+        auto position = findPosition(key);
+        if (position == _data.size())
             return 0;
-        _data.erase(it);
+        removeFromIndex(position);
+        _data.erase(_data.begin() + position);
         return 1;
     }
 
-    void swap(DenseSet<T>& other) noexcept { _data.swap(other._data); }
-
-    // Lookup
-    size_t count(const T& key)
+    void swap(DenseSet<T>& other) noexcept
     {
-        if (std::find(_data.cbegin(), _data.cend(), key) == _data.cend())
-            return 0;
-        return 1;
+        _data.swap(other._data);
+        _hashIndex.swap(other._hashIndex);
     }
 
-    iterator find(const T& key) { return std::find(_data.begin(), _data.end(), key); }
+    // Lookup
+    size_t count(const T& key) const { return findPosition(key) == _data.size() ? 0 : 1; }
+
+    iterator find(const T& key) { return _data.begin() + findPosition(key); }
 
-    const_iterator find(const T& key) const { return std::find(_data.cbegin(), _data.cend(), key); }
+    const_iterator find(const T& key) const { return _data.cbegin() + findPosition(key); }
 
   private:
+    static constexpr size_t _hashIndexThreshold{32}; //!< Size above which the hash index is used, linear search being faster for smaller sets
+
     std::vector<T> _data;
+    std::vector<size_t> _hashIndex{}; //!< Open addressing hash table holding positions in _data plus one, zero marking an empty bucket
+
+    /**
+     * Get the position of the given value
+     * \param key Value to look for
+     * \return Return the position of the value, or the size of the set if not found
+     */
+    size_t findPosition(const T& key) const
+    {
+        if (_hashIndex.empty())
+            return std::distance(_data.cbegin(), std::find(_data.cbegin(), _data.cend(), key));
+
+        auto mask = _hashIndex.size() - 1;
+        for (auto bucket = std::hash<T>()(key) & mask; _hashIndex[bucket] != 0; bucket = (bucket + 1) & mask)
+            if (_data[_hashIndex[bucket] - 1] == key)
+                return _hashIndex[bucket] - 1;
+        return _data.size();
+    }
+
+    /**
+     * Add the value at the given position to the hash index, creating or growing it if needed
+     * \param position Value position
+     */
+    void addToIndex(size_t position)
+    {
+        if (_data.size() < _hashIndexThreshold)
+            return;
+
+        // The index is kept at most half full, to keep the probe sequences short
+        if (_hashIndex.size() < 2 * _data.size())
+        {
+            rebuildIndex();
+            return;
+        }
+
+        auto mask = _hashIndex.size() - 1;
+        auto bucket = std::hash<T>()(_data[position]) & mask;
+        while (_hashIndex[bucket] != 0)
+            bucket = (bucket + 1) & mask;
+        _hashIndex[bucket] = position + 1;
+    }
+
+    /**
+     * Remove the value at the given position from the hash index, and shift the positions of the following values.
+     * Must be called before the value is removed from the set.
+     * \param position Value position
+     */
+    void removeFromIndex(size_t position)
+    {
+        if (_hashIndex.empty())
+            return;
+
+        // Once below the threshold the set goes back to linear search, as values added from now on are not indexed
+        if (_data.size() - 1 < _hashIndexThreshold)
+        {
+            _hashIndex.clear();
+            return;
+        }
+
+        auto mask = _hashIndex.size() - 1;
+        auto bucket = std::hash<T>()(_data[position]) & mask;
+        while (_hashIndex[bucket] != position + 1)
+            bucket = (bucket + 1) & mask;
+
+        // Move back the following values of the probe sequence which would not be reachable anymore
+        for (auto next = (bucket + 1) & mask; _hashIndex[next] != 0; next = (next + 1) & mask)
+        {
+            auto ideal = std::hash<T>()(_data[_hashIndex[next] - 1]) & mask;
+            if (((next - ideal) & mask) >= ((next - bucket) & mask))
+            {
+                _hashIndex[bucket] = _hashIndex[next];
+                bucket = next;
+            }
+        }
+        _hashIndex[bucket] = 0;
+
+        for (auto& entry : _hashIndex)
+            if (entry > position + 1)
+                --entry;
+    }
+
+    /**
+     * Build the hash index from scratch, if the set is large enough to need one
+     */
+    void rebuildIndex()
+    {
+        _hashIndex.clear();
+        if (_data.size() < _hashIndexThreshold)
+            return;
+
+        size_t bucketCount = 1;
+        while (bucketCount < 4 * _data.size())
+            bucketCount <<= 1;
+        _hashIndex.assign(bucketCount, 0);
+
+        auto mask = bucketCount - 1;
+        for (size_t position = 0; position < _data.size(); ++position)
+        {
+            auto bucket = std::hash<T>()(_data[position]) & mask;
+            while (_hashIndex[bucket] != 0)
+                bucket = (bucket + 1) & mask;
+            _hashIndex[bucket] = position + 1;
+        }
+    }
 };
 
 } // namespace Splash
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <doctest.h>
 
@@ -23,6 +25,7 @@ class GraphObjectMock : public GraphObject
     int _integer{0};
     float _float{0.f};
     string _string{""};
+    mutable int _counter{0};
 
     void registerAttributes()
     {
@@ -49,6 +52,10 @@ class GraphObjectMock : public GraphObject
             },
             [&]() -> Values { return {_string}; },
             {'s'});
+
+        // Getter-only attribute, its value changing without the setter being called
+        addAttribute("counter", [&](const Values&) { return true; }, [&]() -> Values { return {_counter++}; }, {});
+        setAttributeVolatile("counter", true);
     }
 };
 
@@ -110,3 +117,47 @@ TEST_CASE("Testing GraphObject attribute registering")
     object->setAttribute("someAttribute", {1337});
     CHECK(someString != otherString);
 }
+
+/*************/
+TEST_CASE("Testing GraphObject dirty attributes")
+{
+    auto object = make_shared<GraphObjectMock>(nullptr);
+    auto contains = [](const vector<string>& list, const string& value) { return find(list.begin(), list.end(), value) != list.end(); };
+
+    // All attributes are dirty at first
+    auto dirtyAttributes = object->getDirtyAttributes();
+    CHECK(contains(dirtyAttributes, "integer"));
+    CHECK(contains(dirtyAttributes, "string"));
+
+    // Only volatile attributes remain
+    dirtyAttributes = object->getDirtyAttributes();
+    CHECK(!contains(dirtyAttributes, "integer"));
+    CHECK(contains(dirtyAttributes, "timestamp"));
+
+    object->setAttribute("integer", {42});
+    dirtyAttributes = object->getDirtyAttributes();
+    CHECK(contains(dirtyAttributes, "integer"));
+    CHECK(!contains(dirtyAttributes, "float"));
+
+    // A failed set does not mark the attribute as dirty
+    object->setAttribute("integer", {"not an integer"});
+    CHECK(!contains(object->getDirtyAttributes(), "integer"));
+
+    CHECK(contains(object->getDirtyAttributes(true), "float"));
+}
+
+/*************/
+TEST_CASE("Testing GraphObject getter-only attributes")
+{
+    auto object = make_shared<GraphObjectMock>(nullptr);
+    auto contains = [](const vector<string>& list, const string& value) { return find(list.begin(), list.end(), value) != list.end(); };
+
+    // Getter-only attributes are reported on every update, not only on full ones
+    for (int i = 0; i < 4; ++i)
+        CHECK(contains(object->getDirtyAttributes(), "counter"));
+
+    Values first, second;
+    object->getAttribute("counter", first);
+    object->getAttribute("counter", second);
+    CHECK(first != second);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <doctest.h>
+
+#include "./core/buffer_pool.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing BufferPool recycling")
+{
+    auto& pool = BufferPool::get();
+    pool.clear();
+    auto initialStats = pool.getStats();
+
+    const size_t bufferSize = 8 << 20;
+    uint8_t* firstBlock = nullptr;
+    {
+        auto array = pool.allocate(bufferSize);
+        CHECK(array.size() == bufferSize);
+        firstBlock = array.data();
+        memset(array.data(), 0, array.size());
+    }
+
+    CHECK(pool.getStats().cachedBytes >= bufferSize);
+
+    {
+        auto object = pool.allocateSerializedObject(bufferSize);
+        CHECK(object->size() == bufferSize);
+        CHECK(object->data() == firstBlock);
+    }
+
+    auto stats = pool.getStats();
+    CHECK(stats.allocations == initialStats.allocations + 1);
+    CHECK(stats.recycledAllocations == initialStats.recycledAllocations + 1);
+    CHECK(stats.recycledBytes >= initialStats.recycledBytes + bufferSize);
+
+    pool.clear();
+    CHECK(pool.getStats().cachedBytes == 0);
+}
+
+/*************/
+TEST_CASE("Testing BufferPool owned by an object")
+{
+    const size_t bufferSize = 4 << 20;
+    auto pool = BufferPool::create(bufferSize);
+
+    uint8_t* firstBlock = nullptr;
+    {
+        auto array = pool->allocate(bufferSize);
+        firstBlock = array.data();
+    }
+    CHECK(pool->getStats().cachedBytes == bufferSize);
+
+    // Only one buffer fits in the pool, the second one is given back to the system
+    {
+        auto first = pool->allocate(bufferSize);
+        auto second = pool->allocate(bufferSize);
+        CHECK(first.data() == firstBlock);
+        CHECK(second.data() != firstBlock);
+    }
+    CHECK(pool->getStats().cachedBytes == bufferSize);
+    CHECK(pool->getStats().allocations == 2);
+    CHECK(pool->getStats().recycledAllocations == 1);
+
+    // Arrays outliving their pool are still valid
+    auto array = pool->allocate(bufferSize);
+    pool.reset();
+    memset(array.data(), 0, array.size());
+    CHECK(array.size() == bufferSize);
+}
@@ -54,3 +54,66 @@ TEST_CASE("Testing Splash::DenseDeque")
     ddeque.pop_front();
     CHECK(ddeque.front() == 0.f);
 }
+
+/*************/
+TEST_CASE("Testing Splash::DenseDeque front insertion")
+{
+    auto ddeque = DenseDeque<int>({1, 2, 3});
+    for (int i = 0; i > -1000; --i)
+        ddeque.push_front(i);
+    CHECK(ddeque.size() == 1003);
+    CHECK(ddeque.front() == -999);
+    CHECK(ddeque.back() == 3);
+    CHECK(ddeque[999] == 0);
+    CHECK(ddeque.at(1000) == 1);
+    CHECK_THROWS(ddeque.at(1003));
+
+    bool inOrder = true;
+    int expected = -999;
+    for (const auto& value : ddeque)
+        inOrder &= (value == expected++);
+    CHECK(inOrder);
+
+    for (int i = 0; i < 500; ++i)
+        ddeque.pop_front();
+    CHECK(ddeque.size() == 503);
+    CHECK(ddeque.front() == -499);
+    CHECK(*ddeque.rbegin() == 3);
+    CHECK(*(ddeque.rend() - 1) == -499);
+
+    auto otherDeque = ddeque;
+    CHECK(otherDeque == ddeque);
+    CHECK(otherDeque.data()[0] == -499);
+
+    auto movedDeque = std::move(otherDeque);
+    CHECK(movedDeque == ddeque);
+    CHECK(otherDeque.empty());
+
+    ddeque.erase(ddeque.begin(), ddeque.end());
+    CHECK(ddeque.empty());
+    ddeque.emplace_front(42);
+    CHECK(ddeque.size() == 1);
+    CHECK(ddeque.front() == 42);
+}
+
+/*************/
+TEST_CASE("Testing Splash::DenseDeque as a FIFO")
+{
+    // The deque is never fully drained, its free space must still be reclaimed
+    auto ddeque = DenseDeque<int>();
+    for (int i = 0; i < 16; ++i)
+        ddeque.push_back(i);
+
+    bool inOrder = true;
+    for (int i = 16; i < 100000; ++i)
+    {
+        ddeque.push_back(i);
+        inOrder &= (ddeque.front() == i - 16);
+        ddeque.pop_front();
+    }
+    CHECK(inOrder);
+    CHECK(ddeque.size() == 16);
+    CHECK(ddeque.front() == 100000 - 16);
+    CHECK(ddeque.back() == 99999);
+    CHECK(ddeque.capacity() < 128);
+}
@@ -20,6 +20,7 @@
 #include <doctest.h>
 
 #include <iostream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -101,3 +102,45 @@ TEST_CASE("Testing Splash::DenseMap")
     otherMap = DenseMap<int, float>({{4, 4.f}, {8, 8.f}});
     CHECK(dmap == otherMap);
 }
+
+/*************/
+TEST_CASE("Testing Splash::DenseMap with a hash index")
+{
+    auto dmap = DenseMap<std::string, int>();
+    for (int i = 0; i < 1024; ++i)
+        dmap[std::to_string(i)] = i;
+    CHECK(dmap.size() == 1024);
+
+    for (int i = 0; i < 1024; i += 3)
+        CHECK(dmap.erase(std::to_string(i)) == 1);
+
+    bool allFound = true;
+    for (int i = 0; i < 1024; ++i)
+    {
+        auto it = dmap.find(std::to_string(i));
+        if (i % 3 == 0)
+            allFound &= (it == dmap.end());
+        else
+            allFound &= (it != dmap.end() && (*it).second == i);
+    }
+    CHECK(allFound);
+}
+
+/*************/
+TEST_CASE("Testing Splash::DenseMap shrinking below the hash index threshold")
+{
+    auto dmap = DenseMap<int, int>();
+    for (int i = 0; i < 32; ++i)
+        dmap[i] = i;
+    dmap.erase(0);
+    dmap.erase(1);
+
+    // Keys inserted once back to a small size must still be found
+    dmap[100] = 100;
+    CHECK(dmap.find(100) != dmap.end());
+    dmap[100] = 101;
+    CHECK(dmap.size() == 31);
+    CHECK((*dmap.find(100)).second == 101);
+    CHECK(dmap.find(2) != dmap.end());
+    CHECK(dmap.find(0) == dmap.end());
+}
@@ -19,6 +19,8 @@
 
 #include <doctest.h>
 
+#include <string>
+
 #include "./utils/dense_set.h"
 
 using namespace Splash;
@@ -51,3 +53,64 @@ TEST_CASE("Testing Splash::DenseSet")
     CHECK(DenseSet({1, 2, 3, 4}) != DenseSet({5, 3, 2, 1}));
     CHECK(DenseSet({1, 2, 3, 4}) != DenseSet({1, 2, 3}));
 }
+
+/*************/
+TEST_CASE("Testing Splash::DenseSet with a hash index")
+{
+    // Large sets use a hash index for lookups, which must follow the modifications of the set
+    auto dset = DenseSet<std::string>();
+    for (int i = 0; i < 1024; ++i)
+        dset.insert(std::to_string(i));
+    CHECK(dset.size() == 1024);
+    CHECK(dset.insert("512").second == false);
+    CHECK(dset.size() == 1024);
+
+    for (int i = 0; i < 1024; i += 2)
+        CHECK(dset.erase(std::to_string(i)) == 1);
+    CHECK(dset.size() == 512);
+    CHECK(dset.erase("0") == 0);
+
+    bool allFound = true;
+    for (int i = 0; i < 1024; ++i)
+        allFound &= (dset.count(std::to_string(i)) == static_cast<size_t>(i % 2));
+    CHECK(allFound);
+
+    // The insertion order is kept
+    bool inOrder = true;
+    int expected = 1;
+    for (const auto& value : dset)
+    {
+        inOrder &= (value == std::to_string(expected));
+        expected += 2;
+    }
+    CHECK(inOrder);
+
+    dset.erase(dset.find("1"), dset.find("101"));
+    CHECK(dset.size() == 462);
+    CHECK(dset.find("99") == dset.end());
+    CHECK(*dset.find("101") == "101");
+
+    auto otherSet = dset;
+    CHECK(otherSet == dset);
+    dset.clear();
+    CHECK(dset.find("101") == dset.end());
+    CHECK(otherSet.find("101") != otherSet.end());
+}
+
+/*************/
+TEST_CASE("Testing Splash::DenseSet shrinking below the hash index threshold")
+{
+    auto dset = DenseSet<int>();
+    for (int i = 0; i < 32; ++i)
+        dset.insert(i);
+    dset.erase(0);
+    dset.erase(1);
+
+    // Values inserted once back to a small size must still be found
+    CHECK(dset.insert(100).second == true);
+    CHECK(dset.count(100) == 1);
+    CHECK(dset.insert(100).second == false);
+    CHECK(dset.size() == 31);
+    CHECK(dset.count(2) == 1);
+    CHECK(dset.count(0) == 0);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <doctest.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "./mesh/mesh_bvh.h"
+
+using namespace Splash;
+
+namespace
+{
+// Plane in [-1, 1]², facing +z, made of two triangles per cell
+std::vector<glm::vec4> createPlane(int subdiv)
+{
+    std::vector<glm::vec4> vertices;
+    const float step = 2.f / subdiv;
+    for (int v = 0; v < subdiv; ++v)
+    {
+        for (int u = 0; u < subdiv; ++u)
+        {
+            const float x = -1.f + u * step;
+            const float y = -1.f + v * step;
+            vertices.push_back(glm::vec4(x, y, 0.f, 1.f));
+            vertices.push_back(glm::vec4(x + step, y, 0.f, 1.f));
+            vertices.push_back(glm::vec4(x, y + step, 0.f, 1.f));
+            vertices.push_back(glm::vec4(x + step, y, 0.f, 1.f));
+            vertices.push_back(glm::vec4(x + step, y + step, 0.f, 1.f));
+            vertices.push_back(glm::vec4(x, y + step, 0.f, 1.f));
+        }
+    }
+    return vertices;
+}
+
+std::vector<glm::vec4> sortTriangles(const std::vector<glm::vec4>& vertices, const std::vector<uint32_t>& order)
+{
+    std::vector<glm::vec4> sorted(vertices.size());
+    for (size_t t = 0; t < order.size(); ++t)
+        for (size_t v = 0; v < 3; ++v)
+            sorted[t * 3 + v] = vertices[order[t] * 3 + v];
+    return sorted;
+}
+
+uint32_t countVertices(const std::vector<MeshBVH::Range>& ranges)
+{
+    uint32_t count = 0;
+    for (const auto& range : ranges)
+        count += range.count;
+    return count;
+}
+} // namespace
+
+/*************/
+TEST_CASE("Testing MeshBVH construction")
+{
+    MeshBVH bvh;
+    CHECK(bvh.build({}).empty());
+    CHECK(bvh.empty());
+
+    // Vertices not forming triangles are refused
+    CHECK(bvh.build(std::vector<glm::vec4>(4)).empty());
+    CHECK(bvh.empty());
+
+    const auto vertices = createPlane(128);
+    const auto order = bvh.build(vertices);
+    REQUIRE(!bvh.empty());
+    CHECK(order.size() == vertices.size() / 3);
+    CHECK(bvh.getVertexCount() == vertices.size());
+
+    // The order is a permutation of the triangles
+    std::vector<bool> seen(order.size(), false);
+    for (auto triangle : order)
+    {
+        REQUIRE(triangle < order.size());
+        CHECK(!seen[triangle]);
+        seen[triangle] = true;
+    }
+
+    // Children split the range of their parent, and leaves are not larger than the limit
+    const auto sorted = sortTriangles(vertices, order);
+    for (const auto& node : bvh.getNodes())
+    {
+        if (node.left == 0)
+        {
+            CHECK(node.count <= MeshBVH::leafTriangleCount * 3);
+        }
+        else
+        {
+            const auto& left = bvh.getNodes()[node.left];
+            const auto& right = bvh.getNodes()[node.right];
+            CHECK(left.first == node.first);
+            CHECK(right.first == left.first + left.count);
+            CHECK(left.count + right.count == node.count);
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+            CHECK(glm::all(glm::greaterThanEqual(glm::vec3(sorted[i]), node.min)));
+            CHECK(glm::all(glm::lessThanEqual(glm::vec3(sorted[i]), node.max)));
+        }
+    }
+}
+
+/*************/
+TEST_CASE("Testing MeshBVH culling")
+{
+    const auto vertices = createPlane(256);
+    MeshBVH bvh;
+    const auto sorted = sortTriangles(vertices, bvh.build(vertices));
+    const auto projection = glm::perspective(glm::radians(60.f), 1.f, 0.1f, 100.f);
+    std::vector<MeshBVH::Range> ranges;
+
+    // Seen as a whole from the front, everything is drawn in a single range
+    const glm::vec3 frontEye(0.f, 0.f, 3.f);
+    const auto frontMatrix = projection * glm::lookAt(frontEye, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    bvh.cull(frontMatrix, frontEye, 0, ranges);
+    CHECK(ranges.size() == 1);
+    CHECK(countVertices(ranges) == vertices.size());
+    bvh.cull(frontMatrix, frontEye, 1, ranges);
+    CHECK(countVertices(ranges) == vertices.size());
+
+    // Front faces are culled when the sideness is inverted
+    bvh.cull(frontMatrix, frontEye, -1, ranges);
+    CHECK(ranges.empty());
+
+    // Seen from behind, only back faces are visible
+    const glm::vec3 backEye(0.f, 0.f, -3.f);
+    const auto backMatrix = projection * glm::lookAt(backEye, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    bvh.cull(backMatrix, backEye, 1, ranges);
+    CHECK(ranges.empty());
+    bvh.cull(backMatrix, backEye, 0, ranges);
+    CHECK(countVertices(ranges) == vertices.size());
+
+    // Looking away from the plane, nothing is drawn
+    bvh.cull(projection * glm::lookAt(frontEye, glm::vec3(0.f, 0.f, 6.f), glm::vec3(0.f, 1.f, 0.f)), frontEye, 0, ranges);
+    CHECK(ranges.empty());
+
+    // Looking at a corner, only part of the plane is drawn, but every visible triangle is
+    const glm::vec3 cornerEye(-0.8f, -0.8f, 0.25f);
+    const auto cornerMatrix = projection * glm::lookAt(cornerEye, glm::vec3(-0.8f, -0.8f, 0.f), glm::vec3(0.f, 1.f, 0.f));
+    bvh.cull(cornerMatrix, cornerEye, 1, ranges);
+    CHECK(countVertices(ranges) > 0);
+    CHECK(countVertices(ranges) < vertices.size() / 4);
+
+    for (size_t i = 1; i < ranges.size(); ++i)
+        CHECK(ranges[i].first > ranges[i - 1].first + ranges[i - 1].count);
+
+    for (uint32_t i = 0; i < sorted.size(); ++i)
+    {
+        auto projected = cornerMatrix * sorted[i];
+        if (projected.w <= 0.f || glm::any(glm::greaterThan(glm::abs(glm::vec3(projected) / projected.w), glm::vec3(1.f))))
+            continue;
+
+        bool isDrawn = false;
+        for (const auto& range : ranges)
+            isDrawn = isDrawn || (i >= range.first && i < range.first + range.count);
+        CHECK(isDrawn);
+    }
+}
+
+/*************/
+TEST_CASE("Testing MeshBVH vertex picking")
+{
+    auto vertices = createPlane(64);
+    // Add some relief for the search not to be planar
+    for (auto& vertex : vertices)
+        vertex.z = 0.1f * glm::sin(vertex.x * 5.f) * glm::cos(vertex.y * 3.f);
+
+    MeshBVH bvh;
+    const auto sorted = sortTriangles(vertices, bvh.build(vertices));
+
+    glm::vec3 closest;
+    CHECK(MeshBVH().findClosestVertex(sorted, glm::vec3(0.f), closest) == std::numeric_limits<float>::max());
+
+    const std::vector<glm::vec3> points{{0.f, 0.f, 0.f}, {0.33f, -0.71f, 0.05f}, {-2.f, 3.f, 1.f}, {0.9f, 0.9f, -0.5f}};
+    for (const auto& point : points)
+    {
+        float expectedDistance = std::numeric_limits<float>::max();
+        for (const auto& vertex : sorted)
+            expectedDistance = std::min(expectedDistance, glm::length(glm::vec3(vertex) - point));
+
+        const float distance = bvh.findClosestVertex(sorted, point, closest);
+        CHECK(distance == doctest::Approx(expectedDistance));
+        CHECK(glm::length(closest - point) == doctest::Approx(expectedDistance));
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./core/graph_object.h"
+#include "./core/render_list.h"
+#include "./utils/dense_map.h"
+
+using namespace Splash;
+
+namespace
+{
+class ObjectMock : public GraphObject
+{
+  public:
+    ObjectMock(const std::string& type, Priority priority)
+        : GraphObject(nullptr)
+    {
+        _type = type;
+        _renderingPriority = priority;
+    }
+};
+} // namespace
+
+/*************/
+TEST_CASE("Testing RenderList ordering")
+{
+    std::vector<std::shared_ptr<GraphObject>> objects{std::make_shared<ObjectMock>("window", GraphObject::Priority::WINDOW),
+        std::make_shared<ObjectMock>("object", GraphObject::Priority::NO_RENDER),
+        std::make_shared<ObjectMock>("image", GraphObject::Priority::MEDIA),
+        std::make_shared<ObjectMock>("filter", GraphObject::Priority::FILTER),
+        std::make_shared<ObjectMock>("image", GraphObject::Priority::MEDIA)};
+
+    RenderList renderList;
+    CHECK(!renderList.isUpToDate(0));
+    renderList.rebuild(objects, 1);
+    CHECK(renderList.isUpToDate(1));
+    CHECK(!renderList.isUpToDate(2));
+
+    CHECK(renderList.getObjects().size() == objects.size());
+    const auto& renderedObjects = renderList.getRenderedObjects();
+    REQUIRE(renderedObjects.size() == 4);
+    CHECK(renderedObjects[0].lock() == objects[2]);
+    CHECK(renderedObjects[1].lock() == objects[4]);
+    CHECK(renderedObjects[2].lock() == objects[3]);
+    CHECK(renderedObjects[3].lock() == objects[0]);
+
+    const auto& groups = renderList.getGroups();
+    REQUIRE(groups.size() == 3);
+    CHECK(groups[0].priority == GraphObject::Priority::MEDIA);
+    CHECK(groups[0].begin == 0);
+    CHECK(groups[0].end == 2);
+    CHECK(groups[2].priority == GraphObject::Priority::WINDOW);
+    CHECK(groups[2].end == 4);
+}
+
+/*************/
+TEST_CASE("Testing RenderList object disposal")
+{
+    DenseMap<std::string, std::shared_ptr<GraphObject>> objects;
+    objects["image"] = std::make_shared<ObjectMock>("image", GraphObject::Priority::MEDIA);
+    objects["filter"] = std::make_shared<ObjectMock>("filter", GraphObject::Priority::FILTER);
+
+    std::vector<std::shared_ptr<GraphObject>> objectVector;
+    for (const auto& obj : objects)
+        objectVector.push_back(obj.second);
+    RenderList renderList;
+    renderList.rebuild(objectVector, 0);
+    objectVector.clear();
+
+    // As in RootObject::disposeObject, an object only referenced by the Scene can be removed while a render list exists
+    CHECK(objects["filter"].use_count() == 1);
+    std::weak_ptr<GraphObject> filter = objects["filter"];
+    objects.erase("filter");
+    CHECK(filter.expired());
+
+    size_t renderedCount = 0;
+    for (const auto& weakObject : renderList.getRenderedObjects())
+        if (weakObject.lock())
+            ++renderedCount;
+    CHECK(renderedCount == 1);
+}
@@ -68,3 +68,31 @@ TEST_CASE("Testing ResizableArray copy")
         for (int shift = 100; shift < 500; shift += 100)
             CHECK(checkCopy(size, shift) == size - shift);
 }
+
+/*************/
+TEST_CASE("Testing ResizableArray wrapping an external buffer")
+{
+    auto buffer = new uint8_t[1024];
+    memset(buffer, 42, 1024);
+    bool released = false;
+
+    {
+        auto array = ResizableArray<uint8_t>(buffer, 1024, [&](uint8_t* data) {
+            released = true;
+            delete[] data;
+        });
+        CHECK(array.size() == 1024);
+        CHECK(array.data() == buffer);
+        CHECK(array[512] == 42);
+
+        auto movedArray = std::move(array);
+        CHECK(movedArray.data() == buffer);
+        CHECK(!released);
+
+        auto copiedArray = ResizableArray<uint8_t>(movedArray);
+        CHECK(copiedArray.data() != buffer);
+        CHECK(copiedArray[512] == 42);
+    }
+
+    CHECK(released);
+}
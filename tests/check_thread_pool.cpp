@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./core/thread_pool.h"
+#include "./utils/cgutils.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing ThreadPool")
+{
+    ThreadPool pool(4);
+    CHECK(pool.getWorkerCount() == 4);
+
+    std::atomic<int> counter{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 256; ++i)
+        futures.push_back(pool.enqueue([&]() { ++counter; }));
+    for (auto& future : futures)
+        future.wait();
+    CHECK(counter == 256);
+
+    // Tasks added from a worker are run too
+    counter = 0;
+    std::vector<std::future<void>> innerFutures(16);
+    auto outerFuture = pool.enqueue([&]() {
+        for (auto& future : innerFutures)
+            future = pool.enqueue([&]() { ++counter; });
+    });
+    outerFuture.wait();
+    for (auto& future : innerFutures)
+        future.wait();
+    CHECK(counter == 16);
+
+    // Exceptions are forwarded to the future
+    auto future = pool.enqueue([]() { throw std::runtime_error("error"); });
+    CHECK_THROWS_AS(future.get(), std::runtime_error);
+}
+
+/*************/
+TEST_CASE("Testing Hap chunks decoding on the decode pool")
+{
+    std::vector<std::atomic<int>> chunks(16);
+    auto decodeChunk = [](void* p, unsigned int index) { ++(*static_cast<std::vector<std::atomic<int>>*>(p))[index]; };
+
+    hapDecodeCallback(decodeChunk, &chunks, chunks.size(), nullptr);
+    for (const auto& chunk : chunks)
+        CHECK(chunk == 1);
+
+    // Chunks are decoded even when called from a worker of the global pool
+    ThreadPool::get().enqueue([&]() { hapDecodeCallback(decodeChunk, &chunks, chunks.size(), nullptr); }).wait();
+    for (const auto& chunk : chunks)
+        CHECK(chunk == 2);
+}
@@ -259,3 +259,96 @@ TEST_CASE("Testing RootHandle")
     }
     CHECK(main.hasBranchAt("/first_branch"));
 }
+
+/*************/
+TEST_CASE("Testing LeafHandle")
+{
+    Tree::Root tree;
+    tree.createLeafAt("/some_object/a_leaf");
+
+    Tree::LeafHandle handle("/some_object/a_leaf");
+    CHECK(handle.isValid());
+    CHECK(handle.getPath() == "/some_object/a_leaf");
+    CHECK(tree.hasLeaf(handle));
+    CHECK(tree.setValueForLeaf(handle, Values({"What's my name"})));
+
+    Value leafValue;
+    CHECK(tree.getValueForLeaf(handle, leafValue));
+    CHECK(leafValue == Values({"What's my name"}));
+    tree.getValueForLeafAt("/some_object/a_leaf", leafValue);
+    CHECK(leafValue == Values({"What's my name"}));
+
+    auto seeds = tree.getUpdateSeedList();
+    CHECK(seeds.size() == 3);
+    CHECK(std::get<0>(seeds.back()) == Tree::Task::SetLeaf);
+    CHECK(std::get<1>(seeds.back()).as<Values>()[0].as<string>() == "/some_object/a_leaf");
+
+    // The handle follows the structural changes of the tree
+    CHECK(tree.renameLeafAt("/some_object/a_leaf", "another_leaf"));
+    CHECK(!tree.hasLeaf(handle));
+    CHECK(!tree.setValueForLeaf(handle, Values({"Say my name"})));
+    CHECK(tree.createLeafAt("/some_object/a_leaf", {"Say my name"}));
+    CHECK(tree.hasLeaf(handle));
+    CHECK(tree.getValueForLeaf(handle, leafValue));
+    CHECK(leafValue == Values({"Say my name"}));
+
+    CHECK(tree.removeBranchAt("/some_object"));
+    CHECK(!tree.hasLeaf(handle));
+
+    // A handle can be used with any tree
+    Tree::Root otherTree;
+    otherTree.createLeafAt("/some_object/a_leaf", {"Heisenberg"});
+    CHECK(otherTree.getValueForLeaf(handle, leafValue));
+    CHECK(leafValue == Values({"Heisenberg"}));
+    CHECK(!tree.hasLeaf(handle));
+
+    CHECK(!Tree::LeafHandle().isValid());
+    CHECK(!tree.hasLeaf(Tree::LeafHandle()));
+}
+
+/*************/
+TEST_CASE("Testing seed coalescing")
+{
+    Tree::Root tree;
+    tree.createLeafAt("/some_object/a_leaf");
+    tree.createLeafAt("/some_object/another_leaf");
+    tree.getUpdateSeedList();
+    auto initialCounts = tree.getSeedCounts();
+
+    // Only the last value set to a leaf is kept
+    for (int64_t i = 0; i < 8; ++i)
+    {
+        tree.setValueForLeafAt("/some_object/a_leaf", Values({i}));
+        tree.setValueForLeafAt("/some_object/another_leaf", Values({-i}));
+    }
+
+    auto seeds = tree.getUpdateSeedList();
+    CHECK(seeds.size() == 2);
+    CHECK(std::get<1>(seeds[0]).as<Values>()[0].as<string>() == "/some_object/a_leaf");
+    CHECK(std::get<1>(seeds[0]).as<Values>()[1] == Values({7}));
+    CHECK(std::get<1>(seeds[1]).as<Values>()[1] == Values({-7}));
+
+    auto counts = tree.getSeedCounts();
+    CHECK(counts.first - initialCounts.first == 16);
+    CHECK(counts.second - initialCounts.second == 2);
+
+    // Values set before a structural change are kept, as the leaf they target may have moved
+    Tree::Root otherTree;
+    otherTree.addSeedsToQueue(tree.getSeedsForPath("/some_object"));
+    CHECK_NOTHROW(otherTree.processQueue());
+
+    tree.setValueForLeafAt("/some_object/a_leaf", Values({"Skyler"}));
+    tree.renameLeafAt("/some_object/a_leaf", "renamed_leaf");
+    tree.createLeafAt("/some_object/a_leaf");
+    tree.setValueForLeafAt("/some_object/a_leaf", Values({"Hank"}));
+    seeds = tree.getUpdateSeedList();
+    CHECK(seeds.size() == 4);
+
+    otherTree.addSeedsToQueue(seeds);
+    CHECK_NOTHROW(otherTree.processQueue());
+    Value leafValue;
+    CHECK(otherTree.getValueForLeafAt("/some_object/renamed_leaf", leafValue));
+    CHECK(leafValue == Values({"Skyler"}));
+    CHECK(otherTree.getValueForLeafAt("/some_object/a_leaf", leafValue));
+    CHECK(leafValue == Values({"Hank"}));
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include <doctest.h>
+
+#include "./core/upload_ring.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing UploadRing slots")
+{
+    const size_t slotSize = 1024;
+    std::vector<uint8_t> memory(slotSize * 2);
+    auto ring = UploadRing::create({memory.data(), memory.data() + slotSize}, slotSize);
+    CHECK(ring->getSlotCount() == 2);
+    CHECK(ring->isIdle());
+
+    // Frames larger than a slot are refused
+    CHECK(ring->acquire(slotSize + 1).size() == 0);
+
+    {
+        auto first = ring->acquire(slotSize);
+        auto second = ring->acquire(slotSize / 2);
+        CHECK(first.size() == slotSize);
+        CHECK(second.size() == slotSize / 2);
+        CHECK(first.data() != second.data());
+        CHECK(ring->getSlotIndex(first.data()) >= 0);
+        CHECK(ring->getSlotIndex(second.data() + 16) >= 0);
+        CHECK(!ring->isIdle());
+
+        // All slots are in use
+        CHECK(ring->acquire(slotSize).size() == 0);
+    }
+    CHECK(ring->isIdle());
+
+    uint8_t outside = 0;
+    CHECK(ring->getSlotIndex(&outside) == -1);
+
+    // Slots read by the GPU are not given back until released
+    ring->setSlotBusy(0, true);
+    ring->setSlotBusy(1, true);
+    CHECK(ring->acquire(slotSize).size() == 0);
+    CHECK(!ring->isIdle());
+    ring->setSlotBusy(1, false);
+    {
+        auto array = ring->acquire(slotSize);
+        CHECK(ring->getSlotIndex(array.data()) == 1);
+    }
+    ring->setSlotBusy(0, false);
+
+    // A closed ring gives no slot anymore
+    ring->close();
+    CHECK(ring->acquire(slotSize).size() == 0);
+}
+
+/*************/
+TEST_CASE("Testing UploadRing registry")
+{
+    std::vector<uint8_t> memory(1024);
+    auto ring = UploadRing::create({memory.data()}, memory.size());
+    CHECK(UploadRing::find("check_upload_ring") == nullptr);
+
+    UploadRing::publish("check_upload_ring", ring);
+    CHECK(UploadRing::find("check_upload_ring") == ring);
+
+    // Only the published ring can be withdrawn
+    auto otherRing = UploadRing::create({memory.data()}, memory.size());
+    UploadRing::withdraw("check_upload_ring", otherRing.get());
+    CHECK(UploadRing::find("check_upload_ring") == ring);
+    UploadRing::withdraw("check_upload_ring", ring.get());
+    CHECK(UploadRing::find("check_upload_ring") == nullptr);
+
+    // Rings are not kept alive by the registry
+    UploadRing::publish("check_upload_ring", otherRing);
+    otherRing.reset();
+    CHECK(UploadRing::find("check_upload_ring") == nullptr);
+}
+
+/*************/
+TEST_CASE("Testing UploadRing closed slots")
+{
+    const size_t slotSize = 1024;
+    std::vector<uint8_t> memory(slotSize * 2);
+    auto ring = UploadRing::create({memory.data(), memory.data() + slotSize}, slotSize);
+    auto held = ring->acquire(slotSize);
+    CHECK(!UploadRing::isClosedSlot(held.data()));
+
+    // Frames held when the ring is closed are reported, for their source to copy them and release the slot
+    ring->close();
+    CHECK(UploadRing::isClosedSlot(held.data()));
+    CHECK(!ring->isIdle());
+
+    uint8_t outside = 0;
+    CHECK(!UploadRing::isClosedSlot(&outside));
+
+    held = ResizableArray<uint8_t>();
+    CHECK(ring->isIdle());
+
+    // Destroyed rings are forgotten
+    const auto data = memory.data();
+    ring.reset();
+    CHECK(!UploadRing::isClosedSlot(data));
+}
@@ -221,4 +221,43 @@ TEST_CASE("Testing Value serialization")
         auto outData = Serial::deserialize<Value>(buffer);
         CHECK(data == outData);
     }
+
+    {
+        vector<uint8_t> buffer;
+        auto data = Value(Values({Value(42, "answer"), 2.71828, Value(Values({testString}), "nested")}), "named");
+        CHECK(Serial::getSize(data) > Serial::getSize(Value(Values({42, 2.71828, Values({testString})}))));
+        Serial::serialize(data, buffer);
+        auto outData = Serial::deserialize<Value>(buffer);
+        CHECK(data == outData);
+        CHECK(outData.getName() == "named");
+        CHECK(outData[0].getName() == "answer");
+        CHECK(outData[2].getName() == "nested");
+    }
+}
+
+/*************/
+TEST_CASE("Testing Value names")
+{
+    auto value = Value(42, "answer");
+    CHECK(value.isNamed());
+    CHECK(value.getName() == "answer");
+    CHECK(!Value(42).isNamed());
+    CHECK(Value(42).getName().empty());
+
+    auto otherValue = Value(42);
+    CHECK(otherValue != value);
+    otherValue.setName(string("ans") + "wer");
+    CHECK(otherValue == value);
+
+    auto values = Values({value, Value("Douglas")["author"]});
+    auto movedValues = Value(std::move(values));
+    CHECK(movedValues[0].getName() == "answer");
+    CHECK(movedValues[1].getName() == "author");
+    CHECK(movedValues[1].as<string>() == "Douglas");
+
+    vector<uint8_t> buffer;
+    Serial::serialize(movedValues, buffer);
+    auto outData = Serial::deserialize<Value>(buffer);
+    CHECK(outData == movedValues);
+    CHECK(outData[1].getName() == "author");
 }
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include <doctest.h>
+
+#include "./image/video_index.h"
+
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing VideoIndex lookups")
+{
+    VideoIndex index;
+    CHECK(index.empty());
+    CHECK(!index.getFrameAt(0));
+
+    // Frames in decoding order, with B-frames: I0 P3 B1 B2 I4 P7 B5 B6
+    index.addFrame(0, true);
+    index.addFrame(3, false);
+    index.addFrame(1, false);
+    index.addFrame(2, false);
+    index.addFrame(4, true);
+    index.addFrame(7, false);
+    index.addFrame(5, false);
+    index.addFrame(6, false);
+    index.finalize();
+
+    CHECK(index.getFrameCount() == 8);
+    CHECK(index.getKeyframeCount() == 2);
+    CHECK(index.getMaxKeyframeInterval() == 4);
+
+    CHECK(index.getFrameAt(2).value() == 2);
+    CHECK(index.getFrameAt(100).value() == 7);
+    CHECK(!index.getFrameAt(-1));
+
+    CHECK(index.getKeyframeBefore(3).value() == 0);
+    CHECK(index.getKeyframeBefore(4).value() == 4);
+    CHECK(index.getKeyframeBefore(6).value() == 4);
+    CHECK(!index.getKeyframeBefore(-1));
+}
+
+/*************/
+TEST_CASE("Testing VideoIndex cache")
+{
+    const std::string path = "/tmp/splash_check_video_index.splashidx";
+
+    VideoIndex index;
+    for (int64_t pts = 0; pts < 300; ++pts)
+        index.addFrame(pts * 512, pts % 30 == 0);
+    index.finalize();
+    CHECK(index.save(path, 123456, 42));
+
+    VideoIndex loadedIndex;
+    CHECK(loadedIndex.load(path, 123456, 42));
+    CHECK(loadedIndex.getFrameCount() == 300);
+    CHECK(loadedIndex.getKeyframeCount() == 10);
+    CHECK(loadedIndex.getKeyframeBefore(100 * 512).value() == 90 * 512);
+
+    // The cache is discarded if the media changed
+    VideoIndex outdatedIndex;
+    CHECK(!outdatedIndex.load(path, 123456, 43));
+    CHECK(!outdatedIndex.load(path, 654321, 42));
+    CHECK(outdatedIndex.empty());
+
+    std::remove(path.c_str());
+    CHECK(!outdatedIndex.load(path, 123456, 42));
+}
@@ -22,67 +22,46 @@
 #include <chrono>
 #include <iostream>
 #include <map>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 using namespace Splash;
 
-int main()
+/*************/
+template <class Map>
+void measure(const std::string& name, size_t count)
 {
-    const size_t count = 1 << 8;
-    const size_t loopCount = 1 << 8;
+    // The number of loops is set so that all sizes do roughly the same number of operations
+    const size_t loopCount = std::max<size_t>(1, (1 << 16) / count);
     volatile int key;
     volatile float value;
 
-    std::cout << "----> DenseMap performance test\n";
-
-    /**
-     * DenseMap
-     */
-    std::cout << "DenseMap::insert -> " << std::flush;
-    DenseMap<int, float> dmap{};
+    Map map{};
+    std::cout << name << "::insert (" << count << " elements) -> " << std::flush;
     auto start = std::chrono::steady_clock::now();
-    for (int loop = 0; loop < loopCount; ++loop)
+    for (size_t loop = 0; loop < loopCount; ++loop)
     {
-        dmap.clear();
+        map.clear();
         for (size_t i = 0; i < count; ++i)
-            dmap.insert({i, static_cast<float>(i)});
+            map.insert({i, static_cast<float>(i)});
     }
     auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
     std::cout << duration << "µs\n";
 
-    std::cout << "DenseMap::iterator -> " << std::flush;
+    std::cout << name << "::find (" << count << " elements) -> " << std::flush;
     start = std::chrono::steady_clock::now();
-    for (int loop = 0; loop < loopCount; ++loop)
-        for (const auto& entry : dmap)
-        {
-            key = entry.first;
-            value = entry.second;
-        }
-    end = std::chrono::steady_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    std::cout << duration << "µs\n";
-
-    /**
-     * std::map
-     */
-    std::cout << "std::map::insert -> " << std::flush;
-    std::map<int, float> map{};
-    start = std::chrono::steady_clock::now();
-    for (int loop = 0; loop < loopCount; ++loop)
-    {
-        map.clear();
+    for (size_t loop = 0; loop < loopCount; ++loop)
         for (size_t i = 0; i < count; ++i)
-            map.insert({i, static_cast<float>(i)});
-    }
+            value = (*map.find(i)).second;
     end = std::chrono::steady_clock::now();
     duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
     std::cout << duration << "µs\n";
 
-    std::cout << "std::map::iterator -> " << std::flush;
+    std::cout << name << "::iterator (" << count << " elements) -> " << std::flush;
     start = std::chrono::steady_clock::now();
-    for (int loop = 0; loop < loopCount; ++loop)
+    for (size_t loop = 0; loop < loopCount; ++loop)
         for (const auto& entry : map)
         {
             key = entry.first;
@@ -91,32 +70,17 @@ int main()
     end = std::chrono::steady_clock::now();
     duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
     std::cout << duration << "µs\n";
+}
 
-    /**
-     * std::unordered_map
-     */
-    std::cout << "std::unordered_map::insert -> " << std::flush;
-    std::unordered_map<int, float> unordered_map{};
-    start = std::chrono::steady_clock::now();
-    for (int loop = 0; loop < loopCount; ++loop)
+/*************/
+int main()
+{
+    std::cout << "----> DenseMap performance test\n";
+
+    for (size_t count : {8, 64, 512, 4096, 65536})
     {
-        unordered_map.clear();
-        for (size_t i = 0; i < count; ++i)
-            unordered_map.insert({i, static_cast<float>(i)});
+        measure<DenseMap<int, float>>("DenseMap", count);
+        measure<std::map<int, float>>("std::map", count);
+        measure<std::unordered_map<int, float>>("std::unordered_map", count);
     }
-    end = std::chrono::steady_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    std::cout << duration << "µs\n";
-
-    std::cout << "std::unordered_map::iterator -> " << std::flush;
-    start = std::chrono::steady_clock::now();
-    for (int loop = 0; loop < loopCount; ++loop)
-        for (const auto& entry : unordered_map)
-        {
-            key = entry.first;
-            value = entry.second;
-        }
-    end = std::chrono::steady_clock::now();
-    duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    std::cout << duration << "µs\n";
 }
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "./image/image.h"
+
+using namespace Splash;
+
+/*************/
+class ImageMock : public Image
+{
+  public:
+    ImageMock()
+        : Image(nullptr)
+    {
+    }
+
+    // Write a new frame in the back buffer and swap it, as a video decoder does
+    void produceFrame(const ImageBufferSpec& spec, uint8_t value)
+    {
+        if (!_bufferImage || _bufferImage->getSpec() != spec)
+            _bufferImage = std::make_shared<ImageBuffer>(spec);
+
+        auto data = _bufferImage->data();
+        for (size_t i = 0; i < _bufferImage->getSize(); i += 4096)
+            data[i] = value;
+
+        _imageUpdated = true;
+        update();
+    }
+};
+
+enum class Transfer
+{
+    serialized, // Serialized object, as received by an inner scene when no outer scene exists
+    copied,     // Copy of the serialized object, as received by an inner scene when an outer scene exists
+    shared      // Shared handle over the image
+};
+
+/*************/
+void measureFrameRate(Transfer transfer, size_t windowCount)
+{
+    const size_t frameCount = 1 << 6;
+    // 4K RGBA frames, which is roughly the size of a decoded 4K Hap frame
+    const auto spec = ImageBufferSpec(4096, 2160, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+
+    ImageMock worldImage;
+    Image sceneImage(nullptr);
+    volatile uint8_t value = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        worldImage.produceFrame(spec, static_cast<uint8_t>(frame));
+
+        std::shared_ptr<SerializedObject> obj;
+        if (transfer == Transfer::shared)
+        {
+            obj = worldImage.share();
+        }
+        else
+        {
+            obj = worldImage.serialize();
+            obj->_handle.reset();
+            if (transfer == Transfer::copied)
+                obj = std::make_shared<SerializedObject>(*obj);
+        }
+
+        sceneImage.deserialize(obj);
+        sceneImage.update();
+
+        // Each window reads the image, one byte per page, as a texture upload would do
+        for (size_t window = 0; window < windowCount; ++window)
+        {
+            auto data = static_cast<const uint8_t*>(sceneImage.data());
+            for (size_t i = 0; i < static_cast<size_t>(spec.rawSize()); i += 4096)
+                value = value + data[i];
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << duration / frameCount << "µs per frame\n";
+}
+
+/*************/
+int main()
+{
+    std::cout << "----> Inner scene performance test\n";
+
+    for (size_t windowCount : {1, 4})
+    {
+        std::cout << "Image (serialized, " << windowCount << " windows) -> " << std::flush;
+        measureFrameRate(Transfer::serialized, windowCount);
+
+        std::cout << "Image (serialized and copied, " << windowCount << " windows) -> " << std::flush;
+        measureFrameRate(Transfer::copied, windowCount);
+
+        std::cout << "Image (shared, " << windowCount << " windows) -> " << std::flush;
+        measureFrameRate(Transfer::shared, windowCount);
+    }
+
+    return 0;
+}
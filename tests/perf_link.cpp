@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#include "./core/link.h"
+#include "./core/root_object.h"
+
+using namespace Splash;
+
+/*************/
+class RootObjectMock : public RootObject
+{
+  public:
+    explicit RootObjectMock(const std::string& name)
+    {
+        _name = name;
+        _linkSocketPrefix = "perf_link";
+        _link = std::make_unique<Link>(this, _name);
+    }
+
+    Link* getLink() { return _link.get(); }
+
+    void waitForBuffers(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(_receivedMutex);
+        _receivedCondition.wait_for(lock, std::chrono::seconds(10), [&]() { return _receivedCount >= count; });
+        _receivedCount = 0;
+    }
+
+  protected:
+    bool handleSerializedObject(const std::string& /*name*/, std::shared_ptr<SerializedObject> obj) override
+    {
+        // Read the buffer, one byte per page, as an object would do when using it
+        volatile uint8_t value = 0;
+        for (size_t i = 0; i < obj->size(); i += 4096)
+            value = value + obj->data()[i];
+        for (size_t i = 0; i < obj->payloadSize(); i += 4096)
+            value = value + obj->payload()[i];
+
+        std::unique_lock<std::mutex> lock(_receivedMutex);
+        ++_receivedCount;
+        _receivedCondition.notify_one();
+        return true;
+    }
+
+  private:
+    std::mutex _receivedMutex{};
+    std::condition_variable _receivedCondition{};
+    size_t _receivedCount{0};
+};
+
+/*************/
+void measureThroughput(RootObjectMock& sender, RootObjectMock& receiver, Link::BufferTransport transport, size_t bufferSize, bool withPayload = false)
+{
+    const size_t loopCount = 1 << 6;
+    sender.getLink()->setBufferTransport(transport);
+
+    auto buffer = std::make_shared<SerializedObject>(bufferSize);
+    memset(buffer->data(), 0, buffer->size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loopCount; ++loop)
+    {
+        // Send a new buffer each time, as the World does. With a payload, only the header is created
+        // and the payload references the source buffer, as Image::serialize does
+        std::shared_ptr<SerializedObject> frame;
+        if (withPayload)
+            frame = std::make_shared<SerializedObject>(ResizableArray<uint8_t>(4096), ResizableArray<uint8_t>(buffer->data(), buffer->size(), [buffer](uint8_t*) {}));
+        else
+            frame = std::make_shared<SerializedObject>(*buffer);
+        sender.getLink()->sendBuffer("buffer", frame);
+        receiver.waitForBuffers(1);
+        sender.getLink()->waitForBufferSending(std::chrono::milliseconds(50));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    auto throughput = static_cast<double>(bufferSize * loopCount) / static_cast<double>(duration); // in MB/s
+    std::cout << duration / loopCount << "µs per buffer, " << throughput << "MB/s\n";
+}
+
+/*************/
+int main()
+{
+    std::cout << "----> Link performance test\n";
+
+    RootObjectMock receiver("perf_receiver");
+    RootObjectMock sender("perf_sender");
+    sender.getLink()->connectTo("perf_receiver");
+
+    for (size_t bufferSize : {1920 * 1080 * 4, 4096 * 4096 * 4})
+    {
+        std::cout << "Link::sendBuffer (ipc, " << bufferSize << " bytes) -> " << std::flush;
+        measureThroughput(sender, receiver, Link::BufferTransport::ipc, bufferSize);
+
+        std::cout << "Link::sendBuffer (shm, " << bufferSize << " bytes) -> " << std::flush;
+        measureThroughput(sender, receiver, Link::BufferTransport::shm, bufferSize);
+
+        std::cout << "Link::sendBuffer (ipc with payload, " << bufferSize << " bytes) -> " << std::flush;
+        measureThroughput(sender, receiver, Link::BufferTransport::ipc, bufferSize, true);
+
+        std::cout << "Link::sendBuffer (shm with payload, " << bufferSize << " bytes) -> " << std::flush;
+        measureThroughput(sender, receiver, Link::BufferTransport::shm, bufferSize, true);
+    }
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "./core/graph_object.h"
+#include "./core/render_list.h"
+#include "./graphics/texture.h"
+#include "./utils/dense_map.h"
+
+using namespace Splash;
+
+volatile size_t windowCount{0};
+
+/*************/
+class ObjectMock : public GraphObject
+{
+  public:
+    ObjectMock(const std::string& type, Priority priority)
+        : GraphObject(nullptr)
+    {
+        _type = type;
+        _renderingPriority = priority;
+    }
+
+    void update() final { ++updateCount; }
+    void render() final { ++renderCount; }
+
+    size_t updateCount{0};
+    size_t renderCount{0};
+};
+
+/*************/
+// Build a scene looking like a large installation: many images, meshes and objects, a few cameras, warps and windows
+DenseMap<std::string, std::shared_ptr<GraphObject>> createScene(size_t objectCount)
+{
+    const std::vector<std::pair<std::string, GraphObject::Priority>> kinds{{"image", GraphObject::Priority::MEDIA},
+        {"texture_image", GraphObject::Priority::NO_RENDER},
+        {"mesh", GraphObject::Priority::MEDIA},
+        {"object", GraphObject::Priority::NO_RENDER},
+        {"filter", GraphObject::Priority::FILTER},
+        {"camera", GraphObject::Priority::CAMERA},
+        {"warp", GraphObject::Priority::POST_CAMERA},
+        {"window", GraphObject::Priority::WINDOW}};
+
+    DenseMap<std::string, std::shared_ptr<GraphObject>> objects;
+    for (size_t i = 0; i < objectCount; ++i)
+    {
+        const auto& kind = kinds[i % kinds.size()];
+        auto name = kind.first + "_" + std::to_string(i);
+        objects[name] = std::make_shared<ObjectMock>(kind.first, kind.second);
+    }
+    return objects;
+}
+
+/*************/
+// The render loop as it was, building the lists of objects on each frame
+void renderFromObjects(const DenseMap<std::string, std::shared_ptr<GraphObject>>& objects)
+{
+    for (auto& obj : objects)
+    {
+        auto texture = std::dynamic_pointer_cast<Texture>(obj.second);
+        if (texture)
+            texture->update();
+    }
+
+    std::map<GraphObject::Priority, std::vector<std::shared_ptr<GraphObject>>> objectList{};
+    for (auto obj = objects.cbegin(); obj != objects.cend(); ++obj)
+    {
+        obj->second->runTasks();
+
+        auto priority = obj->second->getRenderingPriority();
+        if (priority == GraphObject::Priority::NO_RENDER)
+            continue;
+
+        objectList[priority].push_back(obj->second);
+    }
+
+    for (auto& objPriority : objectList)
+    {
+        for (auto& obj : objPriority.second)
+        {
+            obj->update();
+            if (obj->getCategory() == GraphObject::Category::MESH && obj->wasUpdated())
+                obj->setNotUpdated();
+            obj->render();
+        }
+    }
+
+    for (auto& obj : objects)
+        if (obj.second->getType() == "window")
+            windowCount = windowCount + 1;
+}
+
+/*************/
+// The render loop going through the render list
+void renderFromRenderList(const RenderList& renderList)
+{
+    for (const auto& weakTexture : renderList.getTextures())
+        if (auto texture = weakTexture.lock())
+            texture->update();
+
+    for (const auto& weakObject : renderList.getObjects())
+        if (auto obj = weakObject.lock())
+            obj->runTasks();
+
+    const auto& renderedObjects = renderList.getRenderedObjects();
+    const auto& renderedCategories = renderList.getRenderedCategories();
+    for (auto& group : renderList.getGroups())
+    {
+        for (auto index = group.begin; index < group.end; ++index)
+        {
+            const auto obj = renderedObjects[index].lock();
+            if (!obj)
+                continue;
+            obj->update();
+            if (renderedCategories[index] == GraphObject::Category::MESH && obj->wasUpdated())
+                obj->setNotUpdated();
+            obj->render();
+        }
+    }
+
+    for (size_t i = 0; i < renderList.getWindows().size(); ++i)
+        windowCount = windowCount + 1;
+}
+
+/*************/
+void measure(size_t objectCount)
+{
+    const size_t frameCount = 1 << 14;
+    auto objects = createScene(objectCount);
+
+    std::cout << "Objects map (" << objectCount << " objects) -> " << std::flush;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frameCount; ++frame)
+        renderFromObjects(objects);
+    auto end = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << duration / frameCount << "ns per frame\n";
+
+    std::vector<std::shared_ptr<GraphObject>> objectVector;
+    for (auto& obj : objects)
+        objectVector.push_back(obj.second);
+    RenderList renderList;
+    renderList.rebuild(objectVector, 0);
+
+    std::cout << "Render list (" << objectCount << " objects) -> " << std::flush;
+    start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frameCount; ++frame)
+        renderFromRenderList(renderList);
+    end = std::chrono::steady_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << duration / frameCount << "ns per frame\n";
+
+    std::cout << "Render list rebuild (" << objectCount << " objects) -> " << std::flush;
+    start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frameCount; ++frame)
+        renderList.rebuild(objectVector, frame);
+    end = std::chrono::steady_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << duration / frameCount << "ns per rebuild\n";
+}
+
+/*************/
+int main()
+{
+    std::cout << "----> Render list performance test\n";
+
+    for (size_t objectCount : {32, 128, 512})
+        measure(objectCount);
+
+    return 0;
+}
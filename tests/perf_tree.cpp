@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "./core/tree.h"
+
+using namespace Splash;
+
+/*************/
+// Count the allocations done during the measures
+std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/*************/
+int main()
+{
+    const size_t objectCount = 1 << 6;
+    const size_t attributeCount = 1 << 5;
+    const size_t loopCount = 1 << 6;
+
+    std::cout << "----> Tree performance test\n";
+
+    Tree::Root tree;
+    for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+        for (size_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+            tree.createLeafAt("/world/objects/object_" + std::to_string(objectIndex) + "/attributes/attribute_" + std::to_string(attributeIndex));
+    tree.getUpdateSeedList();
+
+    // Leaves which are not modified are the most common case, as most attributes do not change from a frame to the next
+    auto measure = [&](const std::string& name, const auto& update, bool modifyValues) {
+        std::cout << name << (modifyValues ? "" : " (unmodified)") << " -> " << std::flush;
+        for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+            for (size_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+                update(objectIndex, attributeIndex, Value(-1));
+        tree.getUpdateSeedList();
+
+        allocationCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t loop = 0; loop < loopCount; ++loop)
+        {
+            for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+                for (size_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+                    update(objectIndex, attributeIndex, Value(modifyValues ? static_cast<int64_t>(loop) : -1));
+            tree.getUpdateSeedList();
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto updateCount = loopCount * objectCount * attributeCount;
+        std::cout << duration << "µs, " << static_cast<double>(allocationCount) / static_cast<double>(updateCount) << " allocations per update\n";
+    };
+
+    /**
+     * Get and set through string paths, built for each access as the RootObject used to do
+     */
+    std::vector<std::string> objectNames;
+    std::vector<std::string> attributeNames;
+    for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+        objectNames.push_back("object_" + std::to_string(objectIndex));
+    for (size_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+        attributeNames.push_back("attribute_" + std::to_string(attributeIndex));
+
+    auto setValueForLeafAt = [&](size_t objectIndex, size_t attributeIndex, const Value& value) {
+        tree.setValueForLeafAt("/world/objects/" + objectNames[objectIndex] + "/attributes/" + attributeNames[attributeIndex], value);
+    };
+    measure("Tree::Root::setValueForLeafAt", setValueForLeafAt, true);
+    measure("Tree::Root::setValueForLeafAt", setValueForLeafAt, false);
+
+    volatile bool found;
+    measure("Tree::Root::getValueForLeafAt", [&](size_t objectIndex, size_t attributeIndex, const Value&) {
+        Value value;
+        found = tree.getValueForLeafAt("/world/objects/" + objectNames[objectIndex] + "/attributes/" + attributeNames[attributeIndex], value);
+    }, false);
+
+    /**
+     * Get and set through leaf handles
+     */
+    std::vector<Tree::LeafHandle> handles;
+    for (size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex)
+        for (size_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex)
+            handles.emplace_back("/world/objects/" + objectNames[objectIndex] + "/attributes/" + attributeNames[attributeIndex]);
+
+    auto setValueForLeaf = [&](size_t objectIndex, size_t attributeIndex, const Value& value) { tree.setValueForLeaf(handles[objectIndex * attributeCount + attributeIndex], value); };
+    measure("Tree::Root::setValueForLeaf", setValueForLeaf, true);
+    measure("Tree::Root::setValueForLeaf", setValueForLeaf, false);
+
+    measure("Tree::Root::getValueForLeaf", [&](size_t objectIndex, size_t attributeIndex, const Value&) {
+        Value value;
+        found = tree.getValueForLeaf(handles[objectIndex * attributeCount + attributeIndex], value);
+    }, false);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "./core/graph_object.h"
+#include "./core/root_object.h"
+
+using namespace Splash;
+
+/*************/
+class RootObjectMock : public RootObject
+{
+  public:
+    explicit RootObjectMock(size_t objectCount)
+    {
+        _name = "world";
+        runTasks();
+
+        for (size_t i = 0; i < objectCount; ++i)
+        {
+            auto object = std::make_shared<GraphObject>(this);
+            object->setName("object_" + std::to_string(i));
+            _objects[object->getName()] = object;
+        }
+    }
+
+    void modifyObject(size_t index, int value) { _objects["object_" + std::to_string(index)]->setAttribute("priorityShift", {value}); }
+
+    void updateTree()
+    {
+        updateTreeFromObjects();
+        _tree.getUpdateSeedList();
+    }
+};
+
+/*************/
+int main()
+{
+    const size_t loopCount = 1 << 8;
+    std::cout << "----> Tree propagation performance test\n";
+
+    for (size_t objectCount : {16, 64, 256, 1024})
+    {
+        RootObjectMock root(objectCount);
+        // First update, which copies all the attributes to the tree
+        root.updateTree();
+
+        // One object out of sixteen gets modified every frame
+        std::cout << "RootObject::updateTreeFromObjects (" << objectCount << " objects) -> " << std::flush;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t loop = 0; loop < loopCount; ++loop)
+        {
+            for (size_t i = loop % 16; i < objectCount; i += 16)
+                root.modifyObject(i, static_cast<int>(loop));
+            root.updateTree();
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << duration / loopCount << "µs per update\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "./core/serialize/serialize_value.h"
+#include "./core/value.h"
+
+using namespace Splash;
+
+/*************/
+// Count the allocations done during the measures
+std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+/*************/
+// Round-trip the payload as an attribute does when it is set from the World:
+// the message is built, sent with the object and attribute names in front, stored, then read back
+void roundTrip(const std::string& name, const Values& payload)
+{
+    const size_t loopCount = 1 << 12;
+    std::vector<uint8_t> buffer;
+    buffer.reserve(1 << 16);
+    Value storedValue;
+    volatile size_t readSize = 0;
+
+    std::cout << name << " -> " << std::flush;
+    allocationCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loopCount; ++loop)
+    {
+        auto message = payload;
+        message.push_front("attribute");
+        message.push_front("object");
+
+        buffer.clear();
+        Serial::serialize(Value(std::move(message)), buffer);
+        auto received = Serial::deserialize<Value>(buffer);
+
+        auto args = received.as<Values>();
+        args.pop_front();
+        args.pop_front();
+        storedValue = Value(std::move(args));
+        readSize = readSize + storedValue.size();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << duration / static_cast<double>(loopCount) << "µs, " << static_cast<double>(allocationCount) / static_cast<double>(loopCount) << " allocations per round-trip\n";
+}
+
+/*************/
+int main()
+{
+    std::cout << "----> Value performance test\n";
+
+    Values matrix;
+    for (int i = 0; i < 16; ++i)
+        matrix.push_back(static_cast<double>(i));
+    roundTrip("4x4 matrix", matrix);
+
+    // Calibration points, as stored by the Camera: vertex position, projected position, and selection state
+    Values calibrationPoints;
+    for (int i = 0; i < 32; ++i)
+        calibrationPoints.push_back(Values({0.1 * i, 0.2 * i, 0.3 * i, 0.5, 0.5, false, true, 0.f, 0.f}));
+    roundTrip("Calibration points", calibrationPoints);
+
+    std::cout << "Values::push_front -> " << std::flush;
+    const size_t pushCount = 1 << 14;
+    Values values;
+    allocationCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < pushCount; ++i)
+        values.push_front(static_cast<int64_t>(i));
+    auto end = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << duration << "µs for " << pushCount << " values, " << allocationCount << " allocations\n";
+
+    return 0;
+}
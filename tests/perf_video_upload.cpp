@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2019 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+/*************/
+// Measure the CPU time spent by Image_FFmpeg::readLoop to get a decoded frame into an image buffer,
+// for the formats output by the H.264 and HEVC decoders. Decoding itself is not measured as it is not affected.
+void measure(const std::string& name, AVPixelFormat decodedFormat, AVPixelFormat outputFormat)
+{
+    const int width = 3840;
+    const int height = 2160;
+    const size_t loopCount = 1 << 6;
+
+    auto frame = av_frame_alloc();
+    frame->format = decodedFormat;
+    frame->width = width;
+    frame->height = height;
+    if (av_frame_get_buffer(frame, 32) < 0)
+    {
+        std::cout << name << " -> unable to allocate the frame\n";
+        av_frame_free(&frame);
+        return;
+    }
+
+    for (int plane = 0; plane < AV_NUM_DATA_POINTERS && frame->data[plane]; ++plane)
+        memset(frame->data[plane], 128, frame->linesize[plane] * (plane == 0 ? height : height / 2));
+
+    SwsContext* swsContext = nullptr;
+    if (outputFormat != decodedFormat)
+        swsContext = sws_getContext(width, height, decodedFormat, width, height, outputFormat, SWS_BILINEAR, nullptr, nullptr, nullptr);
+
+    std::vector<uint8_t> buffer(av_image_get_buffer_size(outputFormat, width, height, 1));
+    uint8_t* dstData[4];
+    int dstLinesize[4];
+    av_image_fill_arrays(dstData, dstLinesize, buffer.data(), outputFormat, width, height, 1);
+
+    std::cout << name << " -> " << std::flush;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t loop = 0; loop < loopCount; ++loop)
+    {
+        if (swsContext)
+            sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, height, dstData, dstLinesize);
+        else
+            av_image_copy_to_buffer(buffer.data(), buffer.size(), (const uint8_t* const*)frame->data, frame->linesize, outputFormat, width, height, 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << duration / loopCount << "µs per frame, " << buffer.size() << " bytes to upload\n";
+
+    sws_freeContext(swsContext);
+    av_frame_free(&frame);
+}
+
+/*************/
+int main()
+{
+    std::cout << "----> Video upload performance test (3840x2160)\n";
+
+    // Before: every frame was converted to YUYV
+    measure("H.264 (yuv420p) to YUYV", AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUYV422);
+    measure("HEVC 10 bits (yuv420p10le) to YUYV", AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_YUYV422);
+    measure("Hardware decoder (nv12) to YUYV", AV_PIX_FMT_NV12, AV_PIX_FMT_YUYV422);
+
+    // After: 4:2:0 frames are kept planar
+    measure("H.264 (yuv420p) as I420", AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P);
+    measure("HEVC 10 bits (yuv420p10le) to P010", AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_P010LE);
+    measure("Hardware decoder (nv12) as NV12", AV_PIX_FMT_NV12, AV_PIX_FMT_NV12);
+
+    return 0;
+}
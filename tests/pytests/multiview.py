@@ -0,0 +1,64 @@
+import splash
+from time import sleep
+
+description = "Compare the output of cameras rendered one by one and in a single multiview pass"
+
+cameras = ["cam1", "cam_multiview"]
+
+
+def grab(camera):
+    value = splash.get_object_attribute(camera, "buffer")
+    if isinstance(value, list):
+        value = value[0] if value else b""
+    return bytes(value)
+
+
+def grab_all():
+    # Let a few frames go through so that the read back mipmaps are up to date
+    sleep(1.0)
+    return [grab(camera) for camera in cameras]
+
+
+def difference(lhs, rhs):
+    if len(lhs) != len(rhs) or len(lhs) == 0:
+        return None
+    return sum(abs(a - b) for a, b in zip(lhs, rhs)) / len(lhs)
+
+
+def run():
+    # A second camera looking at the same object, with the same output parameters
+    splash.set_world_attribute("addObject", ["camera", "cam_multiview"])
+    sleep(0.5)
+    for attribute in ["size", "fov", "up"]:
+        splash.set_object_attribute("cam_multiview", attribute, splash.get_object_attribute("cam1", attribute))
+    splash.set_object_attribute("cam_multiview", "eye", [0.7457204461097717, -2.000045061111450, 1.961251258850098])
+    splash.set_object_attribute("cam_multiview", "target", splash.get_object_attribute("cam1", "target"))
+    splash.set_world_attribute("sendAllScenes", ["link", "object", "cam_multiview"])
+
+    initial16bits = splash.get_object_attribute("cam1", "16bits")
+    for camera in cameras:
+        splash.set_object_attribute(camera, "grabMipmapLevel", [3])
+
+    # Both output depths, as the multiview target has to match the format of the camera framebuffers
+    for render16bits in [0, 1]:
+        for camera in cameras:
+            splash.set_object_attribute(camera, "16bits", [render16bits])
+            splash.set_object_attribute(camera, "multiview", [0])
+        reference = grab_all()
+
+        for camera in cameras:
+            splash.set_object_attribute(camera, "multiview", [1])
+        multiview = grab_all()
+
+        print("Multiview timing (us), 16bits =", render16bits, ":", splash.get_timings().get("multiview"))
+
+        for camera, expected, result in zip(cameras, reference, multiview):
+            diff = difference(expected, result)
+            print("Camera", camera, "- 16bits =", render16bits, "- mean difference between per-camera and multiview outputs:", diff)
+            assert diff is not None and diff < 1.0, "Multiview output of " + camera + " differs from the per-camera output with 16bits = " + str(render16bits)
+
+    for camera in cameras:
+        splash.set_object_attribute(camera, "multiview", [0])
+        splash.set_object_attribute(camera, "grabMipmapLevel", [-1])
+    splash.set_object_attribute("cam1", "16bits", initial16bits)
+    splash.set_world_attribute("deleteObject", ["cam_multiview"])